@@ -0,0 +1,11 @@
+# Traitement hors ligne de vidéos et de dossiers d'images (sans interface QML).
+# Usage : batch [options] <entrée>... ; "batch --help" pour les options.
+QT = core
+CONFIG += c++17 console# Utilise la norme C++17 ; application console.
+CONFIG -= app_bundle
+TARGET = batch
+# Mêmes sources de traitement que l'application.
+include(../pipeline.pri)
+include(../opencv.pri)
+SOURCES += \
+        main.cpp
@@ -0,0 +1,301 @@
+#include <QCoreApplication> // Application console Qt.
+#include <QCommandLineParser> // Options de l'outil.
+#include <QDir> // Dossiers de sortie.
+#include <QFileInfo> // Nature et nom des entrées.
+#include <QJsonArray> // Chaîne de filtres décrite en JSON.
+#include <QJsonDocument>
+#include <QTextStream> // Sortie des mesures.
+#include "facedetector.h" // Détection synchrone des visages (étape faces).
+#include "filtergraph.h" // Même chaîne de filtres que l'application.
+#include "framesource.h" // Lecture des vidéos et des dossiers d'images.
+#include "workerpool.h" // Traitement des frames en parallèle.
+#include <opencv2/imgcodecs.hpp> // Écriture des images.
+#include <opencv2/imgproc.hpp> // Conversion des sorties en niveaux de gris.
+#include <opencv2/videoio.hpp> // Écriture des vidéos.
+#include <algorithm> // std::max.
+#include <chrono> // Durée du traitement.
+#include <condition_variable> // Fenêtre de frames en cours et remise en ordre.
+#include <map> // Frames traitées en attente d'écriture.
+#include <memory> // Contextes des threads.
+#include <mutex>
+#include <thread> // Thread d'écriture.
+#include <vector>
+// Traitement hors ligne : les frames d'une entrée sont lues dans l'ordre par le thread principal, filtrées en parallèle
+// (une frame par thread du pool, chaque thread ayant son propre graphe de filtres et sa propre cascade), puis remises
+// dans l'ordre et écrites par un thread dédié. Au plus "window" frames sont en cours entre la lecture et l'écriture :
+// la mémoire reste bornée quelle que soit la longueur de l'entrée.
+namespace {
+// Contexte de traitement d'un thread (ni le graphe ni la cascade ne se partagent entre threads)
+struct Worker {
+    FilterGraph graph;
+    cv::CascadeClassifier cascade;
+};
+// Réglages communs à toutes les entrées
+struct Options {
+    QVariantList chain; // Chaîne de filtres.
+    QString cascadePath; // Modèle Haar de l'étape faces.
+    double faceScale = 0.5; // Réduction de l'image analysée par la cascade.
+    QString outputDir; // Dossier de sortie (vide : rien n'est écrit, seul le débit est mesuré).
+    bool images = false; // Sortie en images numérotées au lieu d'une vidéo.
+    int threads = 0; // Threads de traitement.
+    int window = 0; // Frames en cours au plus.
+};
+// État partagé entre la lecture, les threads du pool et l'écriture d'une entrée
+struct Job {
+    std::mutex mutex;
+    std::condition_variable changed; // Frame traitée, frame écrite, contexte libéré ou fin de lecture.
+    std::vector<Worker *> idle; // Contextes libres.
+    std::map<uint64_t, cv::Mat> done; // Frames traitées, par numéro, en attente de leur tour.
+    uint64_t submitted = 0; // Frames confiées au pool.
+    uint64_t written = 0; // Frames écrites (numéro de la prochaine à écrire).
+    bool finished = false; // Plus aucune frame à lire.
+    bool writeFailed = false; // L'écriture a échoué (fichier ou dossier inaccessible).
+};
+// Entrée -> description de source : "file:...", "images:..." et "synthetic..." telles quelles, sinon d'après le chemin
+QString sourceSpec(const QString &input) {
+    const QString kind = input.section(':', 0, 0).toLower();
+    if (kind == "file" || kind == "images" || kind == "synthetic") {
+        return input;
+    }
+    return (QFileInfo(input).isDir() ? QStringLiteral("images:") : QStringLiteral("file:")) + input;
+}
+// Nom de sortie d'une entrée (nom du fichier sans extension ou du dossier)
+QString outputName(const QString &spec) {
+    const QString path = spec.section(':', 1);
+    const QFileInfo info(path);
+    const QString name = info.isDir() ? QDir(path).dirName() : info.completeBaseName();
+    return name.isEmpty() ? spec.section(':', 0, 0) : name;
+}
+// Écrit les frames dans l'ordre de lecture (thread d'écriture), jusqu'à la dernière frame confiée au pool
+void writeFrames(Job &job, const Options &options, const QString &name, double fps) {
+    cv::VideoWriter video;
+    QString directory;
+    if (!options.outputDir.isEmpty() && options.images) {
+        directory = QDir(options.outputDir).filePath(name);
+        if (!QDir().mkpath(directory)) {
+            QTextStream(stderr) << "Impossible de créer le dossier " << directory << "\n";
+            std::lock_guard<std::mutex> locker(job.mutex);
+            job.writeFailed = true;
+        }
+    }
+    cv::Mat color; // Sorties sur un canal (Canny) étendues en BGR (réutilisé).
+    for (;;) {
+        cv::Mat frame;
+        uint64_t index;
+        {
+            std::unique_lock<std::mutex> locker(job.mutex);
+            job.changed.wait(locker, [&job]() { return job.done.count(job.written) || (job.finished && job.written == job.submitted); });
+            auto it = job.done.find(job.written);
+            if (it == job.done.end()) {
+                return; // Tout est écrit.
+            }
+            frame = it->second;
+            index = it->first;
+            job.done.erase(it);
+        }
+        bool ok = true;
+        if (!options.outputDir.isEmpty() && !job.writeFailed) {
+            const cv::Mat *output = &frame;
+            if (frame.channels() == 1) {
+                cv::cvtColor(frame, color, cv::COLOR_GRAY2BGR);
+                output = &color;
+            }
+            if (options.images) {
+                const QString path = QDir(directory).filePath(QStringLiteral("%1.jpg").arg(index + 1, 6, 10, QLatin1Char('0')));
+                ok = cv::imwrite(path.toStdString(), *output);
+            } else {
+                if (!video.isOpened()) {
+                    const QString path = QDir(options.outputDir).filePath(name + QStringLiteral(".avi"));
+                    ok = video.open(path.toStdString(), cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), fps, output->size(), true);
+                    if (!ok) {
+                        QTextStream(stderr) << "Impossible d'écrire " << path << "\n";
+                    }
+                }
+                if (ok) {
+                    video.write(*output);
+                }
+            }
+        }
+        frame = cv::Mat(); // Le tampon retourne au pool du graphe qui l'a produit.
+        {
+            std::lock_guard<std::mutex> locker(job.mutex);
+            job.writeFailed = job.writeFailed || !ok;
+            ++job.written;
+            job.changed.notify_all(); // Place libre dans la fenêtre.
+        }
+    }
+}
+// Traite une entrée ; renvoie le nombre de frames traitées (-1 si l'entrée ou la sortie a échoué)
+int64_t processInput(const QString &spec, const Options &options, WorkerPool &pool, std::vector<std::unique_ptr<Worker>> &workers) {
+    std::unique_ptr<FrameSource> source = FrameSource::create(spec, 640, 480, 30);
+    if (!source) {
+        return -1;
+    }
+    source->setPacing(FrameSource::Pacing::Unthrottled); // Lecture au débit maximal.
+    if (!source->open()) {
+        QTextStream(stderr) << "Impossible d'ouvrir " << spec << "\n";
+        return -1;
+    }
+    Job job;
+    for (const std::unique_ptr<Worker> &worker : workers) {
+        if (worker->graph.isTemporal()) {
+            worker->graph.setChain(options.chain); // Nouvelle entrée : les accumulateurs repartent de sa première frame.
+        }
+        job.idle.push_back(worker.get());
+    }
+    const double fps = source->nominalFps() > 0.0 ? source->nominalFps() : 30.0;
+    std::thread writer(writeFrames, std::ref(job), std::cref(options), outputName(spec), fps);
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> locker(job.mutex);
+            job.changed.wait(locker, [&job, &options]() { return job.submitted - job.written < static_cast<uint64_t>(options.window); });
+            if (job.writeFailed) {
+                break;
+            }
+        }
+        cv::Mat frame;
+        if (!source->grab(frame)) {
+            break; // Fin de l'entrée.
+        }
+        uint64_t index;
+        {
+            std::lock_guard<std::mutex> locker(job.mutex);
+            index = job.submitted++;
+        }
+        pool.submit([&job, index, frame]() mutable {
+            Worker *worker;
+            {
+                std::unique_lock<std::mutex> locker(job.mutex);
+                job.changed.wait(locker, [&job]() { return !job.idle.empty(); });
+                worker = job.idle.back();
+                job.idle.pop_back();
+            }
+            worker->graph.process(frame); // Même traitement que VideoCapture::applyFilters.
+            std::lock_guard<std::mutex> locker(job.mutex);
+            job.idle.push_back(worker);
+            job.done.emplace(index, frame);
+            job.changed.notify_all(); // Sous le verrou : le job peut se terminer dès qu'il est relâché.
+        });
+    }
+    {
+        std::lock_guard<std::mutex> locker(job.mutex);
+        job.finished = true;
+        job.changed.notify_all();
+    }
+    writer.join(); // Revient quand toutes les frames confiées au pool sont écrites.
+    source->close();
+    return job.writeFailed ? -1 : static_cast<int64_t>(job.written);
+}
+}
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Applique la chaîne de filtres (et la détection de visages) à des vidéos ou des dossiers d'images.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("entrées", "Vidéos, dossiers d'images ou descriptions de source (file:..., images:..., synthetic:N).", "<entrée>...");
+    parser.addOption({"chain", "Chaîne de filtres : liste de noms (\"gray,gaussian\") ou tableau JSON ([{\"type\": \"gaussian\", \"size\": 7}]).", "chain", "none"});
+    parser.addOption({"cascade", "Modèle Haar de l'étape faces.", "path",
+                      QCoreApplication::applicationDirPath() + "/haarcascade_frontalface_default.xml"});
+    parser.addOption({"face-scale", "Réduction de l'image analysée par la cascade.", "scale", "0.5"});
+    parser.addOption({"output-dir", "Dossier de sortie (sans : rien n'est écrit, seul le débit est mesuré).", "dir"});
+    parser.addOption({"images", "Écrit des images numérotées (<dossier>/<entrée>/000001.jpg) au lieu d'une vidéo MJPEG."});
+    parser.addOption({"threads", "Threads de traitement (0 = tous les cœurs).", "count", "0"});
+    parser.addOption({"window", "Frames en cours au plus entre la lecture et l'écriture (0 = deux par thread).", "frames", "0"});
+    parser.process(app);
+    const QStringList inputs = parser.positionalArguments();
+    if (inputs.isEmpty()) {
+        parser.showHelp(2);
+    }
+    Options options;
+    const QString chainText = parser.value("chain");
+    const QJsonDocument json = QJsonDocument::fromJson(chainText.toUtf8());
+    if (json.isArray()) {
+        options.chain = json.array().toVariantList();
+    } else {
+        for (const QString &name : chainText.split(',', Qt::SkipEmptyParts)) {
+            options.chain << name.trimmed();
+        }
+    }
+    options.cascadePath = parser.value("cascade");
+    options.faceScale = parser.value("face-scale").toDouble();
+    options.outputDir = parser.value("output-dir");
+    options.images = parser.isSet("images");
+    options.threads = parser.value("threads").toInt();
+    if (options.threads <= 0) {
+        options.threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    options.window = parser.value("window").toInt();
+    FilterGraph probe; // Chaîne validée une fois, avant de créer les contextes.
+    QString chainError;
+    if (!probe.setChain(options.chain, &chainError)) {
+        QTextStream(stderr) << chainError << "\n";
+        return 2;
+    }
+    const bool temporal = probe.isTemporal();
+    if (temporal) {
+        // Accumulateurs d'une frame à l'autre : une seule frame en cours, filtres par bandes sur tous les cœurs
+        if (options.threads > 1 || options.window > 1) {
+            QTextStream(stderr) << "Chaîne temporelle : frames traitées dans l'ordre, une à la fois.\n";
+        }
+        options.threads = 1;
+        options.window = 1;
+    }
+    if (options.window <= 0) {
+        options.window = 2 * options.threads;
+    }
+    if (!options.outputDir.isEmpty() && !QDir().mkpath(options.outputDir)) {
+        QTextStream(stderr) << "Impossible de créer le dossier " << options.outputDir << "\n";
+        return 1;
+    }
+    // Un contexte par thread de traitement : graphe en série (le parallélisme est entre les frames), cascade propre
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < options.threads; ++i) {
+        std::unique_ptr<Worker> worker(new Worker);
+        QString error;
+        if (!worker->graph.setChain(options.chain, &error)) {
+            QTextStream(stderr) << error << "\n";
+            return 2;
+        }
+        worker->graph.setThreadCount(temporal ? 0 : 1); // Sans parallélisme entre frames, les bandes occupent les cœurs.
+        if (worker->graph.contains(FilterGraph::Faces)) {
+            if (!worker->cascade.load(options.cascadePath.toStdString())) {
+                QTextStream(stderr) << "Impossible de charger le modèle Haar " << options.cascadePath << "\n";
+                return 1;
+            }
+            Worker *context = worker.get();
+            const double faceScale = options.faceScale;
+            worker->graph.setFaceHandler([context, faceScale](cv::Mat &bgr, const cv::Mat &gray) {
+                FaceDetector::drawFaces(bgr, FaceDetector::detect(context->cascade, gray, faceScale)); // Frames indépendantes : pas de suivi.
+            });
+        }
+        workers.push_back(std::move(worker));
+    }
+    WorkerPool pool(options.threads + 1); // options.threads threads de travail : le thread principal ne fait que lire.
+    QTextStream out(stdout);
+    out << "Chaîne " << chainText << ", " << options.threads << " threads, fenêtre de " << options.window << " frames\n";
+    int64_t totalFrames = 0;
+    int failures = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (const QString &input : inputs) {
+        const QString spec = sourceSpec(input);
+        const auto inputStart = std::chrono::steady_clock::now();
+        const int64_t frames = processInput(spec, options, pool, workers);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - inputStart).count();
+        if (frames < 0) {
+            ++failures;
+            continue;
+        }
+        totalFrames += frames;
+        out << qSetRealNumberPrecision(3) << Qt::fixed << input << " : " << frames << " frames en " << seconds << " s, "
+            << (seconds > 0.0 ? frames / seconds : 0.0) << " FPS\n";
+        out.flush();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    out << qSetRealNumberPrecision(3) << Qt::fixed << "Total : " << totalFrames << " frames en " << seconds << " s, "
+        << (seconds > 0.0 ? totalFrames / seconds : 0.0) << " FPS";
+    if (failures > 0) {
+        out << ", " << failures << " entrée(s) en échec";
+    }
+    out << "\n";
+    return failures > 0 ? 1 : 0;
+}
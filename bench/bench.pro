@@ -0,0 +1,18 @@
+# Outils de mesure en ligne de commande (sans interface QML).
+# Usage : bench <suite> [options] ; "bench tiles --help" pour les options d'une suite.
+QT = core
+CONFIG += c++17 console# Utilise la norme C++17 ; application console.
+CONFIG -= app_bundle
+TARGET = bench
+# Mêmes sources de traitement que l'application.
+include(../pipeline.pri)
+include(../opencv.pri)
+SOURCES += \
+        camerabench.cpp \
+        exportbench.cpp \
+        kernelbench.cpp \
+        main.cpp \
+        pipelinebench.cpp \
+        tilebench.cpp
+HEADERS += \
+    benchmarks.h
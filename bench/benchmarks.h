@@ -0,0 +1,15 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+// Inclusion des bibliothèques nécessaires
+#include <QStringList> // Arguments de la ligne de commande.
+#include <opencv2/core.hpp> // cv::Mat pour les images de test.
+// Suites de mesures de l'outil bench (chaque suite reçoit ses propres arguments et renvoie le code de sortie)
+int runTileBenchmark(const QStringList &arguments); // Accélération des filtres exécutés par bandes, de 1 à N threads.
+int runCameraBenchmark(const QStringList &arguments); // Débit total de 1 à N caméras sur le pool partagé.
+int runKernelBenchmark(const QStringList &arguments); // Noyaux pixel à pixel fusionnés face aux appels OpenCV.
+int runPipelineBenchmark(const QStringList &arguments); // Coût par frame de chaque mode, des visages et de l'encodage (JSON, référence).
+int runExportBenchmark(const QStringList &arguments); // Débit et latence de l'anneau en mémoire partagée entre deux processus.
+// Utilitaires communs
+cv::Mat makeTestFrame(int width, int height); // Mire synthétique bruitée (déterministe) pour les mesures.
+bool parseSize(const QString &text, int *width, int *height); // "1920x1080" -> largeur, hauteur.
+#endif // BENCHMARKS_H
@@ -0,0 +1,110 @@
+#include "benchmarks.h" // Déclaration de la suite.
+#include "camerascheduler.h" // Répartition des caméras sur le pool.
+#include "captureengine.h" // Un thread de capture par caméra.
+#include "filtergraph.h" // Traitement de chaque caméra.
+#include "framesource.h" // Mire synthétique.
+#include <QCommandLineParser> // Options de la suite.
+#include <QTextStream> // Sortie du tableau.
+#include <atomic> // Compteurs de frames traitées.
+#include <chrono> // Durée de chaque mesure.
+#include <memory> // Caméras de chaque configuration.
+#include <thread> // Attente pendant la mesure.
+#include <vector> // Caméras et nombres de caméras.
+// Caméra simulée : mire synthétique lue sans cadencement (chaque frame est traitée, rien n'est sauté)
+namespace {
+struct BenchCamera {
+    CaptureEngine engine;
+    FilterGraph graph;
+    cv::Mat work; // Tampon de travail (réutilisé).
+    std::atomic<uint64_t> processed{0};
+    void process() {
+        FrameRing::FrameRef latest = engine.ring().latest();
+        if (!latest.isValid()) {
+            return;
+        }
+        latest.image().copyTo(work);
+        latest.release();
+        graph.process(work);
+        processed.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+}
+// Débit total de 1 à N caméras traitées par l'ordonnanceur sur le pool partagé : doit croître presque
+// linéairement tant que les cœurs ne sont pas saturés.
+int runCameraBenchmark(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Débit de plusieurs caméras traitées sur le pool partagé.");
+    parser.addHelpOption();
+    parser.addOption({"size", "Résolution des frames (LxH).", "size", "640x480"});
+    parser.addOption({"cameras", "Nombre maximal de caméras.", "count", "8"});
+    parser.addOption({"seconds", "Durée de chaque mesure.", "seconds", "3"});
+    parser.addOption({"mode", "Mode de filtre appliqué par chaque caméra.", "mode", QString::number(FilterGraph::Gaussian)});
+    parser.addOption({"tile-threads", "Threads des filtres par bandes de chaque caméra (1 = parallélisme entre caméras seulement).", "count", "1"});
+    parser.process(arguments);
+    int width = 0, height = 0;
+    if (!parseSize(parser.value("size"), &width, &height)) {
+        QTextStream(stderr) << "Résolution invalide : " << parser.value("size") << "\n";
+        return 2;
+    }
+    const int maxCameras = qMax(1, parser.value("cameras").toInt());
+    const double seconds = qMax(0.5, parser.value("seconds").toDouble());
+    const int mode = parser.value("mode").toInt();
+    const int tileThreads = parser.value("tile-threads").toInt();
+    std::vector<int> cameraCounts;
+    for (int cameras = 1; cameras < maxCameras; cameras *= 2) {
+        cameraCounts.push_back(cameras);
+    }
+    cameraCounts.push_back(maxCameras);
+    QTextStream out(stdout);
+    out << "Frames " << width << "x" << height << ", mode " << FilterGraph::nameOfType(static_cast<FilterGraph::StageType>(mode))
+        << ", " << WorkerPool::shared().threadCount() << " threads dans le pool\n";
+    out << qSetFieldWidth(12) << Qt::left << "cameras" << "fps total" << "fps/camera" << "scaling" << qSetFieldWidth(0) << "\n";
+    double singleFps = 0.0;
+    for (int count : cameraCounts) {
+        CameraScheduler scheduler;
+        std::vector<std::unique_ptr<BenchCamera>> cameras;
+        for (int i = 0; i < count; ++i) {
+            std::unique_ptr<BenchCamera> camera(new BenchCamera);
+            camera->graph.setSingleMode(mode);
+            camera->graph.setThreadCount(tileThreads);
+            camera->engine.setFrameListener([&scheduler]() { scheduler.wake(); });
+            std::unique_ptr<FrameSource> source(new SyntheticSource(width, height, 30));
+            source->setPacing(FrameSource::Pacing::Unthrottled); // Rejeu sans perte au débit maximal.
+            if (!camera->engine.start(std::move(source))) {
+                QTextStream(stderr) << "Impossible d'ouvrir la mire synthétique.\n";
+                return 1;
+            }
+            cameras.push_back(std::move(camera));
+        }
+        std::vector<int> ids;
+        for (const std::unique_ptr<BenchCamera> &camera : cameras) {
+            BenchCamera *raw = camera.get();
+            ids.push_back(scheduler.addCamera([raw]() { return !raw->engine.ring().isLatestConsumed(); }, [raw]() { raw->process(); }));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(300)); // Chauffe : remplissage des pools de tampons.
+        uint64_t before = 0;
+        for (const std::unique_ptr<BenchCamera> &camera : cameras) {
+            before += camera->processed.load();
+        }
+        const auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        uint64_t after = 0;
+        for (const std::unique_ptr<BenchCamera> &camera : cameras) {
+            after += camera->processed.load();
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        for (int id : ids) {
+            scheduler.removeCamera(id);
+        }
+        for (const std::unique_ptr<BenchCamera> &camera : cameras) {
+            camera->engine.stop();
+        }
+        const double totalFps = (after - before) / elapsed;
+        if (count == 1) {
+            singleFps = totalFps;
+        }
+        out << qSetFieldWidth(12) << Qt::left << count << QString::number(totalFps, 'f', 1) << QString::number(totalFps / count, 'f', 1)
+            << QString::number(singleFps > 0 ? totalFps / (singleFps * count) : 0.0, 'f', 2) << qSetFieldWidth(0) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "benchmarks.h" // Déclaration de la suite.
+#include "frameexporter.h" // Écrivain de l'anneau partagé.
+#include "sharedframes.h" // Lecteur de référence.
+#include <QCommandLineParser> // Options de la suite.
+#include <QCoreApplication> // Chemin de l'outil (processus lecteur).
+#include <QProcess> // Processus lecteur.
+#include <QTextStream> // Sortie des résultats.
+#include <algorithm> // std::sort.
+#include <chrono> // Horodatages et durée de la mesure.
+#include <thread> // Attente du segment par le lecteur.
+#include <vector> // Latences mesurées.
+namespace {
+int64_t monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); // Même horloge que la capture.
+}
+double percentile(std::vector<double> &values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+}
+// Processus lecteur : lit chaque frame sur place (une lecture par page) jusqu'à la fermeture du segment
+int runReader(const QString &name, double seconds) {
+    QTextStream out(stdout);
+    SharedFrames::Reader reader;
+    const auto openDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!reader.open(name.toStdString())) {
+        if (std::chrono::steady_clock::now() > openDeadline) {
+            QTextStream(stderr) << "Segment introuvable : " << name << "\n";
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    out << "ready" << Qt::endl; // L'écrivain commence la mesure.
+    uint64_t received = 0, torn = 0;
+    volatile uint8_t sink = 0; // Les lectures des pixels ne sont pas éliminées par le compilateur.
+    std::vector<double> latencies; // Microsecondes entre la capture (publication) et la lecture.
+    latencies.reserve(static_cast<size_t>(seconds * 100000));
+    SharedFrames::Reader::Frame frame;
+    for (;;) {
+        if (!reader.next(frame, 2000)) {
+            break; // Segment fermé par l'écrivain (fin de la mesure) ou écrivain arrêté.
+        }
+        const size_t bytes = static_cast<size_t>(frame.step) * frame.height;
+        for (size_t offset = 0; offset < bytes; offset += 4096) {
+            sink = sink + frame.data[offset]; // Une lecture par page : les pixels sont accessibles sans copie.
+        }
+        const int64_t latency = monotonicNs() - frame.timestampNs;
+        if (!reader.isValid(frame)) {
+            ++torn; // Case réécrite pendant la lecture.
+            continue;
+        }
+        ++received;
+        latencies.push_back(latency / 1000.0);
+    }
+    out << "result " << received << " " << reader.skippedFrames() << " " << torn << " " << percentile(latencies, 0.5) << " "
+        << percentile(latencies, 0.99) << " " << (latencies.empty() ? 0.0 : latencies.back()) << Qt::endl;
+    return 0;
+}
+}
+// Débit de l'anneau en mémoire partagée entre deux processus : l'écrivain publie des frames au débit maximal,
+// un second processus (cet outil relancé en lecteur) les lit sur place et mesure la latence de publication.
+int runExportBenchmark(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Débit et latence de l'export en mémoire partagée entre deux processus.");
+    parser.addHelpOption();
+    parser.addOption({"size", "Résolution des frames (LxH).", "size", "1920x1080"});
+    parser.addOption({"seconds", "Durée de la mesure.", "seconds", "3"});
+    parser.addOption({"slots", "Cases de l'anneau.", "count", "4"});
+    parser.addOption({"reader", "Mode lecteur (utilisé par la suite elle-même) : segment à lire.", "name"});
+    parser.process(arguments);
+    const double seconds = qMax(0.5, parser.value("seconds").toDouble());
+    if (parser.isSet("reader")) {
+        return runReader(parser.value("reader"), seconds);
+    }
+    int width = 0, height = 0;
+    if (!parseSize(parser.value("size"), &width, &height)) {
+        QTextStream(stderr) << "Résolution invalide : " << parser.value("size") << "\n";
+        return 2;
+    }
+    const cv::Mat frame = makeTestFrame(width, height);
+    const QString name = QStringLiteral("mauellopencv-bench-%1").arg(QCoreApplication::applicationPid());
+    FrameExporter exporter;
+    exporter.setName(name);
+    exporter.setSlotCount(parser.value("slots").toInt());
+    if (!exporter.publish(frame, monotonicNs())) { // Crée le segment avant de lancer le lecteur.
+        QTextStream(stderr) << "Impossible de créer le segment partagé " << name << "\n";
+        return 1;
+    }
+    QProcess reader;
+    reader.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    reader.start(QCoreApplication::applicationFilePath(), {"export", "--reader", name, "--seconds", QString::number(seconds)});
+    if (!reader.waitForStarted(5000) || !reader.waitForReadyRead(10000) || !reader.readLine().startsWith("ready")) {
+        QTextStream(stderr) << "Le processus lecteur n'a pas démarré.\n";
+        reader.kill();
+        return 1;
+    }
+    const uint64_t before = exporter.publishedFrames();
+    const auto start = std::chrono::steady_clock::now();
+    const auto end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+    while (std::chrono::steady_clock::now() < end) {
+        exporter.publish(frame, monotonicNs());
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const uint64_t published = exporter.publishedFrames() - before;
+    exporter.close(); // Le lecteur voit le segment fermé et rend ses mesures.
+    if (!reader.waitForFinished(10000) || reader.exitCode() != 0) {
+        QTextStream(stderr) << "Le processus lecteur a échoué.\n";
+        return 1;
+    }
+    QStringList result;
+    while (reader.canReadLine()) {
+        const QString line = QString::fromUtf8(reader.readLine()).trimmed();
+        if (line.startsWith("result ")) {
+            result = line.split(' ');
+        }
+    }
+    if (result.size() < 7) {
+        QTextStream(stderr) << "Résultat du lecteur illisible.\n";
+        return 1;
+    }
+    const double frameMegabytes = frame.total() * frame.elemSize() / (1024.0 * 1024.0);
+    QTextStream out(stdout);
+    out << "Frames " << width << "x" << height << " (" << QString::number(frameMegabytes, 'f', 2) << " Mo), "
+        << exporter.name() << ", " << qMax(2, parser.value("slots").toInt()) << " cases\n";
+    out << "écrivain : " << published << " frames, " << QString::number(published / elapsed, 'f', 1) << " fps, "
+        << QString::number(published * frameMegabytes / elapsed, 'f', 0) << " Mo/s\n";
+    out << "lecteur  : " << result[1] << " frames lues (" << QString::number(result[1].toDouble() / elapsed, 'f', 1) << " fps), "
+        << result[2] << " sautées, " << result[3] << " déchirées\n";
+    out << "latence  : p50 " << result[4] << " µs, p99 " << result[5] << " µs, max " << result[6] << " µs\n";
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "benchmarks.h" // Déclaration de la suite.
+#include "pixelkernels.h" // Noyaux fusionnés mesurés.
+#include <QCommandLineParser> // Options de la suite.
+#include <QTextStream> // Sortie du tableau.
+#include <opencv2/imgproc.hpp> // Suites d'appels OpenCV de référence.
+#include <cfloat> // DBL_EPSILON (normalisation min/max).
+#include <chrono> // Mesure du temps.
+#include <functional> // Variantes mesurées.
+#include <vector> // Effets mesurés.
+// Chaque noyau fusionné (effet + conversion BGR -> RGB en une passe), pour chaque jeu d'instructions disponible,
+// face à la suite d'appels OpenCV qu'il remplace ; mesures sur un seul thread, écart maximal à la sortie OpenCV.
+int runKernelBenchmark(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Noyaux pixel à pixel fusionnés face aux appels OpenCV.");
+    parser.addHelpOption();
+    parser.addOption({"size", "Résolution des frames (LxH).", "size", "1920x1080"});
+    parser.addOption({"frames", "Frames mesurées par configuration.", "count", "50"});
+    parser.process(arguments);
+    int width = 0, height = 0;
+    if (!parseSize(parser.value("size"), &width, &height)) {
+        QTextStream(stderr) << "Résolution invalide : " << parser.value("size") << "\n";
+        return 2;
+    }
+    const int frames = qMax(1, parser.value("frames").toInt());
+    const cv::Mat input = makeTestFrame(width, height);
+    if (input.empty()) {
+        QTextStream(stderr) << "Impossible de générer la frame de test.\n";
+        return 1;
+    }
+    const cv::Mat sepiaKernel = (cv::Mat_<float>(3, 3) << 0.272, 0.534, 0.131, 0.349, 0.686, 0.168, 0.393, 0.769, 0.189); // Étape Sepia.
+    // Effet mesuré : suite OpenCV d'origine et noyau fusionné (l'entrée n'est jamais modifiée)
+    struct Effect {
+        const char *name;
+        std::function<void(const cv::Mat &, cv::Mat &)> opencv;
+        std::function<void(const cv::Mat &, cv::Mat &)> fused;
+    };
+    cv::Mat temp, gray;
+    const std::vector<Effect> effects = {
+        {"rgb", [](const cv::Mat &src, cv::Mat &rgb) { cv::cvtColor(src, rgb, cv::COLOR_BGR2RGB); },
+         [](const cv::Mat &src, cv::Mat &rgb) { PixelKernels::bgrToRgb(src, rgb); }},
+        {"invert",
+         [&temp](const cv::Mat &src, cv::Mat &rgb) {
+             cv::bitwise_not(src, temp);
+             cv::cvtColor(temp, rgb, cv::COLOR_BGR2RGB);
+         },
+         [](const cv::Mat &src, cv::Mat &rgb) { PixelKernels::invert(src, rgb); }},
+        {"gray",
+         [&temp, &gray](const cv::Mat &src, cv::Mat &rgb) {
+             cv::cvtColor(src, gray, cv::COLOR_BGR2GRAY);
+             cv::cvtColor(gray, temp, cv::COLOR_GRAY2BGR);
+             cv::cvtColor(temp, rgb, cv::COLOR_BGR2RGB);
+         },
+         [](const cv::Mat &src, cv::Mat &rgb) { PixelKernels::gray(src, rgb); }},
+        {"sepia",
+         [&temp, &sepiaKernel](const cv::Mat &src, cv::Mat &rgb) {
+             cv::transform(src, temp, sepiaKernel);
+             cv::cvtColor(temp, rgb, cv::COLOR_BGR2RGB);
+         },
+         [](const cv::Mat &src, cv::Mat &rgb) { PixelKernels::sepia(src, rgb); }},
+        {"normalize",
+         [&temp](const cv::Mat &src, cv::Mat &rgb) {
+             cv::normalize(src, temp, 0, 255, cv::NORM_MINMAX);
+             cv::cvtColor(temp, rgb, cv::COLOR_BGR2RGB);
+         },
+         [](const cv::Mat &src, cv::Mat &rgb) {
+             double minimum = 0.0, maximum = 0.0; // Le min/max fait partie de la mesure, comme dans cv::normalize.
+             cv::minMaxIdx(src.reshape(1), &minimum, &maximum);
+             const double scale = 255.0 * (maximum - minimum > DBL_EPSILON ? 1.0 / (maximum - minimum) : 0.0);
+             PixelKernels::scale(src, static_cast<float>(scale), static_cast<float>(-minimum * scale), rgb);
+         }},
+    };
+    // Durée moyenne d'une variante (deux passes de chauffe : allocation des sorties)
+    auto measure = [&input, frames](const std::function<void(const cv::Mat &, cv::Mat &)> &function, cv::Mat &output) {
+        double totalMs = 0.0;
+        for (int i = -2; i < frames; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            function(input, output);
+            const auto end = std::chrono::steady_clock::now();
+            if (i >= 0) {
+                totalMs += std::chrono::duration<double, std::milli>(end - start).count();
+            }
+        }
+        return totalMs / frames;
+    };
+    const int openCvThreads = cv::getNumThreads();
+    cv::setNumThreads(1); // Comparaison à cœur égal : cvtColor et transform sont parallélisés par OpenCV.
+    const PixelKernels::Isa defaultIsa = PixelKernels::isa();
+    QTextStream out(stdout);
+    out << "Frames " << width << "x" << height << ", " << frames << " frames par mesure, un thread, jeu par défaut : "
+        << PixelKernels::name(defaultIsa) << "\n";
+    out << qSetFieldWidth(12) << Qt::left << "effect" << "variant" << "ms/frame" << "speedup" << "max diff" << qSetFieldWidth(0) << "\n";
+    for (const Effect &effect : effects) {
+        cv::Mat reference;
+        const double openCvMs = measure(effect.opencv, reference);
+        out << qSetFieldWidth(12) << Qt::left << effect.name << "opencv" << QString::number(openCvMs, 'f', 2) << "1.00" << "-"
+            << qSetFieldWidth(0) << "\n";
+        for (int isa = PixelKernels::Scalar; isa < PixelKernels::IsaCount; ++isa) {
+            if (!PixelKernels::setIsa(static_cast<PixelKernels::Isa>(isa))) {
+                continue; // Jeu non compilé ou non pris en charge par ce processeur.
+            }
+            cv::Mat output;
+            const double ms = measure(effect.fused, output);
+            const double difference = cv::norm(output, reference, cv::NORM_INF); // 0 attendu, 1 pour les calculs en virgule fixe ou flottante simple.
+            out << qSetFieldWidth(12) << Qt::left << effect.name << PixelKernels::name(static_cast<PixelKernels::Isa>(isa))
+                << QString::number(ms, 'f', 2) << QString::number(openCvMs / ms, 'f', 2) << difference << qSetFieldWidth(0) << "\n";
+        }
+    }
+    PixelKernels::setIsa(defaultIsa);
+    cv::setNumThreads(openCvThreads);
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <QCoreApplication> // Application console Qt.
+#include <QTextStream> // Sortie de l'aide.
+#include "benchmarks.h" // Suites de mesures.
+#include "bufferpool.h" // Compteur d'allocations de cv::Mat.
+#include "framesource.h" // Mire synthétique.
+#include <opencv2/core.hpp> // Génération du bruit.
+// Mire synthétique avec un bruit gaussien fixe : les filtres travaillent sur une image texturée, toujours la même
+cv::Mat makeTestFrame(int width, int height) {
+    SyntheticSource source(width, height, 30);
+    source.setPacing(FrameSource::Pacing::Unthrottled);
+    cv::Mat frame;
+    if (!source.open() || !source.grab(frame)) {
+        return cv::Mat();
+    }
+    cv::Mat noisy, noise(frame.size(), CV_16SC3);
+    cv::RNG rng(12345); // Graine fixe : même image d'une exécution à l'autre.
+    rng.fill(noise, cv::RNG::NORMAL, 0, 12);
+    frame.convertTo(noisy, CV_16S);
+    noisy += noise;
+    noisy.convertTo(frame, CV_8U); // Saturation à [0, 255].
+    return frame;
+}
+// "1920x1080" -> largeur, hauteur
+bool parseSize(const QString &text, int *width, int *height) {
+    const QStringList parts = text.toLower().split('x');
+    bool okWidth = false, okHeight = false;
+    if (parts.size() == 2) {
+        *width = parts[0].toInt(&okWidth);
+        *height = parts[1].toInt(&okHeight);
+    }
+    return okWidth && okHeight && *width > 0 && *height > 0;
+}
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    AllocationCounter::install(); // Allocations par frame de la suite pipeline.
+    QStringList arguments = app.arguments();
+    const QString suite = arguments.size() > 1 ? arguments.takeAt(1) : QString();
+    if (suite == "tiles") {
+        return runTileBenchmark(arguments); // arguments[0] reste le nom du programme.
+    }
+    if (suite == "cameras") {
+        return runCameraBenchmark(arguments);
+    }
+    if (suite == "kernels") {
+        return runKernelBenchmark(arguments);
+    }
+    if (suite == "pipeline") {
+        return runPipelineBenchmark(arguments);
+    }
+    if (suite == "export") {
+        return runExportBenchmark(arguments);
+    }
+    QTextStream(stderr) << "Usage : bench <suite> [options]\n"
+                        << "Suites :\n"
+                        << "  tiles   accélération des filtres par bandes, de 1 à N threads\n"
+                        << "  cameras débit total de 1 à N caméras sur le pool partagé\n"
+                        << "  kernels noyaux pixel à pixel fusionnés face aux appels OpenCV\n"
+                        << "  pipeline coût par frame de chaque mode, des visages et de l'encodage (JSON, comparaison à une référence)\n"
+                        << "  export  débit et latence de l'export en mémoire partagée vers un second processus\n";
+    return 2;
+}
@@ -0,0 +1,279 @@
+#include "benchmarks.h" // Déclaration de la suite.
+#include "bufferpool.h" // Compteur d'allocations de cv::Mat.
+#include "facedetector.h" // Détection de visages mesurée.
+#include "filtergraph.h" // Modes de filtre mesurés.
+#include "framesource.h" // Frames enregistrées.
+#include <QByteArray> // Chemin JPEG + Base64.
+#include <QCommandLineParser> // Options de la suite.
+#include <QCoreApplication> // Chemin du modèle Haar par défaut.
+#include <QDateTime> // Date de la mesure.
+#include <QFile> // Résultats JSON et référence.
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream> // Sortie du tableau.
+#include <opencv2/imgcodecs.hpp> // cv::imencode.
+#include <opencv2/imgproc.hpp> // Mise à l'échelle des frames enregistrées.
+#include <algorithm> // std::sort.
+#include <chrono> // Mesure du temps.
+#include <functional> // Cas mesurés.
+#include <map> // Référence par cas.
+#include <memory> // Source des frames enregistrées.
+#include <vector> // Durées par frame.
+// Coût par frame de chaque mode de filtre (avec la conversion d'affichage, comme à la capture), de la détection de
+// visages et des chemins d'encodage, pour chaque résolution et chaque jeu de frames (mire synthétique, vidéo
+// enregistrée) : percentiles de latence, débit et allocations de cv::Mat. Les résultats peuvent être écrits en JSON
+// et comparés à une référence enregistrée (code de sortie 1 en cas de régression).
+namespace {
+// Résultat d'un cas
+struct Result {
+    QString name; // "<frames>/<LxH>/<cas>".
+    double p50Ms = 0.0;
+    double p90Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    double fps = 0.0; // Frames par seconde sur l'ensemble des mesures.
+    double allocationsPerFrame = 0.0; // Allocations de cv::Mat par frame (pendant l'appel mesuré).
+    double bytesPerFrame = 0.0; // Octets alloués par frame.
+};
+// Cas mesuré : préparation hors mesure, puis appel sur une copie de travail de la frame d'entrée (modifiable)
+struct Case {
+    QString name;
+    std::function<void()> prepare;
+    std::function<void(cv::Mat &)> run;
+};
+// Percentile (rang le plus proche) de durées triées
+double percentile(const std::vector<double> &sorted, double p) {
+    const size_t rank = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+// Exécute un cas sur les frames d'entrée (à tour de rôle) ; deux passes de chauffe pour les allocations initiales
+Result measure(const QString &name, const std::function<void(cv::Mat &)> &run, const std::vector<cv::Mat> &inputs, int frames) {
+    std::vector<double> durations;
+    durations.reserve(frames);
+    uint64_t allocations = 0, bytes = 0;
+    cv::Mat work;
+    double totalMs = 0.0;
+    for (int i = -2; i < frames; ++i) {
+        inputs[(i + 2) % inputs.size()].copyTo(work); // Hors mesure.
+        const uint64_t allocationsBefore = AllocationCounter::allocations();
+        const uint64_t bytesBefore = AllocationCounter::bytes();
+        const auto start = std::chrono::steady_clock::now();
+        run(work);
+        const auto end = std::chrono::steady_clock::now();
+        if (i >= 0) {
+            const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            durations.push_back(ms);
+            totalMs += ms;
+            allocations += AllocationCounter::allocations() - allocationsBefore;
+            bytes += AllocationCounter::bytes() - bytesBefore;
+        }
+    }
+    std::sort(durations.begin(), durations.end());
+    Result result;
+    result.name = name;
+    result.p50Ms = percentile(durations, 50);
+    result.p90Ms = percentile(durations, 90);
+    result.p99Ms = percentile(durations, 99);
+    result.maxMs = durations.back();
+    result.fps = totalMs > 0.0 ? 1000.0 * frames / totalMs : 0.0;
+    result.allocationsPerFrame = static_cast<double>(allocations) / frames;
+    result.bytesPerFrame = static_cast<double>(bytes) / frames;
+    return result;
+}
+QJsonObject toJson(const Result &result) {
+    return QJsonObject{{"name", result.name}, {"p50Ms", result.p50Ms}, {"p90Ms", result.p90Ms}, {"p99Ms", result.p99Ms},
+                       {"maxMs", result.maxMs}, {"fps", result.fps}, {"allocationsPerFrame", result.allocationsPerFrame},
+                       {"bytesPerFrame", result.bytesPerFrame}};
+}
+// Premières frames d'une source enregistrée (taille d'origine)
+std::vector<cv::Mat> loadClip(const QString &spec, int count) {
+    std::vector<cv::Mat> clip;
+    std::unique_ptr<FrameSource> source = FrameSource::create(spec, 640, 480, 30);
+    if (!source) {
+        return clip;
+    }
+    source->setPacing(FrameSource::Pacing::Unthrottled);
+    if (!source->open()) {
+        return clip;
+    }
+    cv::Mat frame;
+    while (static_cast<int>(clip.size()) < count && source->grab(frame)) {
+        clip.push_back(frame.clone()); // grab() peut réutiliser le tampon.
+    }
+    source->close();
+    return clip;
+}
+}
+int runPipelineBenchmark(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Coût par frame des modes de filtre, de la détection de visages et de l'encodage.");
+    parser.addHelpOption();
+    parser.addOption({"sizes", "Résolutions mesurées (LxH, séparées par des virgules).", "list", "640x480,1280x720,1920x1080"});
+    parser.addOption({"frames", "Frames mesurées par cas.", "count", "30"});
+    parser.addOption({"input", "Vidéo ou dossier d'images enregistrés, mesurés en plus de la mire (file:..., images:...).", "spec"});
+    parser.addOption({"clip", "Frames lues dans l'entrée enregistrée.", "count", "30"});
+    parser.addOption({"cascade", "Modèle Haar (cas de détection de visages ignorés s'il est introuvable).", "path",
+                      QCoreApplication::applicationDirPath() + "/haarcascade_frontalface_default.xml"});
+    parser.addOption({"threads", "Threads des filtres exécutés par bandes (0 = tous les cœurs).", "count", "0"});
+    parser.addOption({"cases", "Cas mesurés : filtres contenant l'un de ces mots, séparés par des virgules (défaut : tous).", "list"});
+    parser.addOption({"json", "Écrit les résultats en JSON dans ce fichier (\"-\" : sortie standard).", "path"});
+    parser.addOption({"baseline", "Compare à des résultats JSON enregistrés ; code de sortie 1 en cas de régression.", "path"});
+    parser.addOption({"tolerance", "Hausse de la latence médiane tolérée face à la référence, en %.", "percent", "10"});
+    parser.process(arguments);
+    std::vector<cv::Size> sizes;
+    for (const QString &text : parser.value("sizes").split(',', Qt::SkipEmptyParts)) {
+        int width = 0, height = 0;
+        if (!parseSize(text, &width, &height)) {
+            QTextStream(stderr) << "Résolution invalide : " << text << "\n";
+            return 2;
+        }
+        sizes.push_back(cv::Size(width, height));
+    }
+    const int frames = qMax(1, parser.value("frames").toInt());
+    const QStringList filters = parser.value("cases").split(',', Qt::SkipEmptyParts);
+    const double tolerance = parser.value("tolerance").toDouble() / 100.0;
+    // Référence chargée avant les mesures : une erreur de chemin ne coûte pas une exécution complète
+    std::map<QString, QJsonObject> baseline;
+    if (parser.isSet("baseline")) {
+        QFile file(parser.value("baseline"));
+        if (!file.open(QIODevice::ReadOnly)) {
+            QTextStream(stderr) << "Impossible de lire la référence " << file.fileName() << "\n";
+            return 2;
+        }
+        for (const QJsonValue &value : QJsonDocument::fromJson(file.readAll()).object().value("cases").toArray()) {
+            baseline[value.toObject().value("name").toString()] = value.toObject();
+        }
+    }
+    std::vector<cv::Mat> clip;
+    if (parser.isSet("input")) {
+        clip = loadClip(parser.value("input"), qMax(1, parser.value("clip").toInt()));
+        if (clip.empty()) {
+            QTextStream(stderr) << "Impossible de lire " << parser.value("input") << "\n";
+            return 1;
+        }
+    }
+    // Détection de visages : détecteur asynchrone de la capture (étape faces) et détection synchrone seule
+    FaceDetector faceDetector;
+    cv::CascadeClassifier cascade;
+    const bool faces = faceDetector.load(parser.value("cascade").toStdString()) && cascade.load(parser.value("cascade").toStdString());
+    FilterGraph graph;
+    graph.setThreadCount(parser.value("threads").toInt());
+    graph.setFaceHandler([&faceDetector](cv::Mat &bgr, const cv::Mat &gray) { faceDetector.process(bgr, gray); });
+    cv::Mat display, gray;
+    std::vector<uchar> jpeg; // Capacité conservée d'une frame à l'autre, comme VideoCapture::m_jpegBuffer.
+    std::vector<Case> cases;
+    for (int mode = FilterGraph::None; mode < FilterGraph::StageTypeCount; ++mode) {
+        if (mode == FilterGraph::Faces && !faces) {
+            continue;
+        }
+        cases.push_back({"mode/" + FilterGraph::nameOfType(static_cast<FilterGraph::StageType>(mode)),
+                         [&graph, mode]() { graph.setSingleMode(mode); },
+                         [&graph, &display](cv::Mat &frame) { graph.process(frame, &display, false); }}); // Filtre et image RGB d'affichage, comme applyFilters().
+    }
+    // Zone d'intérêt centrée couvrant le quart de l'image : le coût doit suivre la surface (comparer à mode/<nom>)
+    std::vector<cv::Rect> quarter(1);
+    for (int mode : {FilterGraph::Bilateral, FilterGraph::Clahe, FilterGraph::Cartoon}) {
+        cases.push_back({"roi25/" + FilterGraph::nameOfType(static_cast<FilterGraph::StageType>(mode)),
+                         [&graph, mode]() { graph.setSingleMode(mode); },
+                         [&graph, &display, &quarter](cv::Mat &frame) {
+                             quarter[0] = cv::Rect(frame.cols / 4, frame.rows / 4, frame.cols / 2, frame.rows / 2);
+                             graph.processRois(frame, quarter, 0.4, &display); // Hors de la zone : assombri, comme l'option de VideoCapture.
+                         }});
+    }
+    if (faces) {
+        cases.push_back({"faces/detect", nullptr, [&cascade, &gray, &faceDetector](cv::Mat &frame) {
+                             cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+                             FaceDetector::detect(cascade, gray, faceDetector.detectionScale()); // Détection complète (thread de détection).
+                         }});
+    } else {
+        QTextStream(stderr) << "Modèle Haar introuvable (" << parser.value("cascade") << ") : cas de visages ignorés.\n";
+    }
+    cases.push_back({"encode/jpeg", nullptr, [&jpeg](cv::Mat &frame) { cv::imencode(".jpg", frame, jpeg); }});
+    cases.push_back({"encode/base64", nullptr, [&jpeg](cv::Mat &frame) {
+                         cv::imencode(".jpg", frame, jpeg); // Même chemin que VideoCapture::matToBase64().
+                         const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char *>(jpeg.data()), static_cast<int>(jpeg.size()));
+                         const QString base64 = QString::fromLatin1(data.toBase64());
+                         Q_UNUSED(base64);
+                     }});
+    // Jeux de frames : mire synthétique et, si demandé, frames enregistrées mises à chaque résolution
+    struct FrameSet {
+        QString name;
+        std::vector<cv::Mat> frames;
+    };
+    const bool toStdout = parser.value("json") == "-";
+    QTextStream out(toStdout ? stderr : stdout); // Le tableau ne se mêle pas au JSON.
+    out << "Mesures sur " << frames << " frames par cas, filtres sur " << graph.threadCount() << " threads\n";
+    out << qSetFieldWidth(34) << Qt::left << "case" << qSetFieldWidth(10) << "p50 ms" << "p90 ms" << "p99 ms" << "FPS" << "allocs"
+        << qSetFieldWidth(0) << (baseline.empty() ? "" : "  vs référence") << "\n";
+    std::vector<Result> results;
+    int regressions = 0;
+    for (const cv::Size &size : sizes) {
+        std::vector<FrameSet> sets = {{"synthetic", {makeTestFrame(size.width, size.height)}}};
+        if (!clip.empty()) {
+            FrameSet recorded{"recorded", {}};
+            for (const cv::Mat &frame : clip) {
+                cv::Mat scaled;
+                cv::resize(frame, scaled, size, 0, 0, cv::INTER_AREA);
+                recorded.frames.push_back(scaled);
+            }
+            sets.push_back(recorded);
+        }
+        for (const FrameSet &set : sets) {
+            faceDetector.reset(); // Visages suivis de la résolution précédente.
+            for (const Case &current : cases) {
+                const QString name = QStringLiteral("%1/%2x%3/%4").arg(set.name).arg(size.width).arg(size.height).arg(current.name);
+                if (!filters.isEmpty() && std::none_of(filters.begin(), filters.end(), [&name](const QString &f) { return name.contains(f); })) {
+                    continue;
+                }
+                if (current.prepare) {
+                    current.prepare();
+                }
+                const Result result = measure(name, current.run, set.frames, frames);
+                results.push_back(result);
+                out << qSetFieldWidth(34) << Qt::left << name << qSetFieldWidth(10) << QString::number(result.p50Ms, 'f', 2)
+                    << QString::number(result.p90Ms, 'f', 2) << QString::number(result.p99Ms, 'f', 2) << QString::number(result.fps, 'f', 1)
+                    << QString::number(result.allocationsPerFrame, 'f', 1) << qSetFieldWidth(0);
+                auto reference = baseline.find(name);
+                if (reference != baseline.end()) {
+                    // Régression : latence médiane au-delà de la tolérance, ou allocations en plus
+                    const double referenceMs = reference->second.value("p50Ms").toDouble();
+                    const double referenceAllocations = reference->second.value("allocationsPerFrame").toDouble();
+                    const bool slower = referenceMs > 0.0 && result.p50Ms > referenceMs * (1.0 + tolerance);
+                    const bool allocates = result.allocationsPerFrame > referenceAllocations + 0.5;
+                    out << "  " << (referenceMs > 0.0 ? QString::asprintf("%+.1f %%", 100.0 * (result.p50Ms / referenceMs - 1.0)) : QString("-"));
+                    if (slower || allocates) {
+                        out << (slower ? "  PLUS LENT" : "") << (allocates ? "  ALLOUE PLUS" : "");
+                        ++regressions;
+                    }
+                } else if (!baseline.empty()) {
+                    out << "  nouveau";
+                }
+                out << "\n";
+                out.flush();
+            }
+        }
+    }
+    if (parser.isSet("json")) {
+        QJsonArray array;
+        for (const Result &result : results) {
+            array.append(toJson(result));
+        }
+        const QJsonObject root{{"date", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)}, {"opencv", CV_VERSION},
+                               {"threads", graph.threadCount()}, {"frames", frames}, {"cases", array}};
+        const QByteArray json = QJsonDocument(root).toJson();
+        if (toStdout) {
+            QTextStream(stdout) << json;
+        } else {
+            QFile file(parser.value("json"));
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+                QTextStream(stderr) << "Impossible d'écrire " << file.fileName() << "\n";
+                return 1;
+            }
+        }
+    }
+    if (!baseline.empty()) {
+        out << regressions << " régression(s) face à la référence (tolérance " << parser.value("tolerance") << " %)\n";
+    }
+    return regressions > 0 ? 1 : 0;
+}
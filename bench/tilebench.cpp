@@ -0,0 +1,92 @@
+#include "benchmarks.h" // Déclaration de la suite.
+#include "filtergraph.h" // Chaîne de filtres mesurée.
+#include "workerpool.h" // Nombre de cœurs disponibles.
+#include <QCommandLineParser> // Options de la suite.
+#include <QTextStream> // Sortie du tableau.
+#include <chrono> // Mesure du temps.
+#include <vector> // Liste des modes et des nombres de threads.
+// Accélération de chaque mode de filtre de 1 à N threads, avec vérification que la sortie est identique
+// au bit près à l'exécution en série.
+int runTileBenchmark(const QStringList &arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Accélération des filtres exécutés par bandes.");
+    parser.addHelpOption();
+    parser.addOption({"size", "Résolution des frames (LxH).", "size", "1920x1080"});
+    parser.addOption({"frames", "Frames mesurées par configuration.", "count", "20"});
+    parser.addOption({"threads", "Nombre maximal de threads (défaut : tous les cœurs).", "count", "0"});
+    parser.addOption({"modes", "Modes de filtre mesurés, séparés par des virgules (défaut : tous les modes déterministes).", "list"});
+    parser.process(arguments);
+    int width = 0, height = 0;
+    if (!parseSize(parser.value("size"), &width, &height)) {
+        QTextStream(stderr) << "Résolution invalide : " << parser.value("size") << "\n";
+        return 2;
+    }
+    const int frames = qMax(1, parser.value("frames").toInt());
+    int maxThreads = parser.value("threads").toInt();
+    if (maxThreads <= 0 || maxThreads > WorkerPool::shared().threadCount()) {
+        maxThreads = WorkerPool::shared().threadCount();
+    }
+    std::vector<int> modes;
+    if (parser.isSet("modes")) {
+        for (const QString &mode : parser.value("modes").split(',', Qt::SkipEmptyParts)) {
+            modes.push_back(mode.toInt());
+        }
+    } else {
+        for (int mode = FilterGraph::Gray; mode < FilterGraph::Faces; ++mode) {
+            if (mode != FilterGraph::SaltPepper) { // Sortie aléatoire : pas de comparaison possible.
+                modes.push_back(mode);
+            }
+        }
+    }
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+    const cv::Mat input = makeTestFrame(width, height);
+    if (input.empty()) {
+        QTextStream(stderr) << "Impossible de générer la frame de test.\n";
+        return 1;
+    }
+    QTextStream out(stdout);
+    out << "Frames " << width << "x" << height << ", " << frames << " frames par mesure, jusqu'à " << maxThreads << " threads\n";
+    out << qSetFieldWidth(12) << Qt::left << "mode" << "threads" << "ms/frame" << "speedup" << "identical" << qSetFieldWidth(0) << "\n";
+    bool allIdentical = true;
+    for (int mode : modes) {
+        FilterGraph graph;
+        graph.setSingleMode(mode);
+        cv::Mat buffer(input.size(), input.type()); // Copie de l'entrée, refaite avant chaque frame (hors mesure).
+        cv::Mat reference; // Sortie en série.
+        double serialMs = 0.0;
+        for (int threads : threadCounts) {
+            graph.setThreadCount(threads);
+            cv::Mat output;
+            double totalMs = 0.0;
+            for (int i = -2; i < frames; ++i) { // Deux frames de chauffe : remplissage des pools.
+                input.copyTo(buffer);
+                cv::Mat work = buffer;
+                const auto start = std::chrono::steady_clock::now();
+                graph.process(work);
+                const auto end = std::chrono::steady_clock::now();
+                if (i >= 0) {
+                    totalMs += std::chrono::duration<double, std::milli>(end - start).count();
+                }
+                output = work;
+            }
+            const double ms = totalMs / frames;
+            bool identical = true;
+            if (threads == 1) {
+                reference = output.clone();
+                serialMs = ms;
+            } else {
+                identical = output.size() == reference.size() && output.type() == reference.type()
+                            && cv::norm(output, reference, cv::NORM_INF) == 0;
+                allIdentical = allIdentical && identical;
+            }
+            out << qSetFieldWidth(12) << Qt::left << FilterGraph::nameOfType(static_cast<FilterGraph::StageType>(mode)) << threads
+                << QString::number(ms, 'f', 2) << QString::number(serialMs / ms, 'f', 2) << (identical ? "yes" : "NO")
+                << qSetFieldWidth(0) << "\n";
+        }
+    }
+    return allIdentical ? 0 : 1; // Échec si une sortie parallèle diffère de la sortie en série.
+}
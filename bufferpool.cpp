@@ -0,0 +1,61 @@
+#include "bufferpool.h" // Déclaration des classes BufferPool et AllocationCounter.
+// Renvoie un tampon libre de la taille et du type demandés
+cv::Mat BufferPool::acquire(int rows, int cols, int type) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    std::vector<cv::Mat> &buffers = m_buffers[Key(rows, cols, type)];
+    for (const cv::Mat &buffer : buffers) {
+        if (buffer.u && buffer.u->refcount == 1) { // Seul le pool le référence : tampon libre.
+            return buffer; // Copie d'en-tête : le tampon est de nouveau occupé.
+        }
+    }
+    buffers.emplace_back(rows, cols, type); // Aucun tampon libre : allocation (seulement pendant la montée en charge).
+    return buffers.back();
+}
+// Oublie les tampons libres (ceux encore utilisés seront libérés par leurs utilisateurs)
+void BufferPool::clear() {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_buffers.clear();
+}
+// Nombre de tampons détenus
+size_t BufferPool::bufferCount() const {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    size_t count = 0;
+    for (const auto &entry : m_buffers) {
+        count += entry.second.size();
+    }
+    return count;
+}
+// ---------------------------------------------------------------------------
+// AllocationCounter
+static std::atomic<uint64_t> allocationCount(0); // Nombre d'allocations.
+static std::atomic<uint64_t> allocationBytes(0); // Octets alloués.
+// Allocateur qui compte puis délègue à l'allocateur standard d'OpenCV
+class CountingAllocator : public cv::MatAllocator {
+public:
+    cv::UMatData *allocate(int dims, const int *sizes, int type, void *data, size_t *step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override {
+        cv::UMatData *u = cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+        if (u && !data) { // Les données fournies par l'appelant ne sont pas une allocation.
+            allocationCount.fetch_add(1, std::memory_order_relaxed);
+            allocationBytes.fetch_add(u->size, std::memory_order_relaxed);
+        }
+        return u; // u->currAllocator reste l'allocateur standard : c'est lui qui libérera.
+    }
+    bool allocate(cv::UMatData *data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override {
+        return cv::Mat::getStdAllocator()->allocate(data, accessFlags, usageFlags);
+    }
+    void deallocate(cv::UMatData *data) const override {
+        cv::Mat::getStdAllocator()->deallocate(data);
+    }
+};
+// Installe le compteur comme allocateur par défaut
+void AllocationCounter::install() {
+    static CountingAllocator allocator; // Doit vivre jusqu'à la fin du programme.
+    cv::Mat::setDefaultAllocator(&allocator);
+}
+uint64_t AllocationCounter::allocations() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+uint64_t AllocationCounter::bytes() {
+    return allocationBytes.load(std::memory_order_relaxed);
+}
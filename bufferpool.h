@@ -0,0 +1,34 @@
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat et cv::MatAllocator.
+#include <atomic> // Compteurs d'allocations.
+#include <cstdint> // Types entiers de taille fixe.
+#include <map> // Tampons rangés par taille et type.
+#include <mutex> // Accès concurrents au pool (les tampons d'affichage sont rendus par le thread de rendu).
+#include <tuple> // Clé (lignes, colonnes, type).
+#include <vector> // Tampons d'une même clé.
+// Pool de tampons d'image rangés par taille et type. Un tampon est libre quand le pool est seul à le
+// référencer (compteur de références de la cv::Mat égal à 1) : il suffit donc de laisser tomber la
+// cv::Mat obtenue pour le rendre, quel que soit le thread. À résolution fixe, le régime établi
+// ne fait plus aucune allocation.
+class BufferPool {
+public:
+    BufferPool() = default;
+    cv::Mat acquire(int rows, int cols, int type); // Renvoie un tampon libre (alloué seulement si aucun ne convient).
+    void clear(); // Oublie les tampons libres (changement de résolution).
+    size_t bufferCount() const; // Nombre de tampons détenus par le pool.
+private:
+    using Key = std::tuple<int, int, int>; // (lignes, colonnes, type).
+    mutable std::mutex m_mutex; // Protège m_buffers.
+    std::map<Key, std::vector<cv::Mat>> m_buffers; // Tampons par clé.
+};
+// Compteur d'allocations de cv::Mat : allocateur par défaut d'OpenCV qui délègue à l'allocateur standard
+// en comptant chaque allocation de pixels. Sert à vérifier que le chemin de traitement n'alloue plus rien.
+class AllocationCounter {
+public:
+    static void install(); // Installe le compteur comme allocateur par défaut (à appeler au démarrage).
+    static uint64_t allocations(); // Nombre total d'allocations de cv::Mat depuis l'installation.
+    static uint64_t bytes(); // Nombre total d'octets alloués.
+};
+#endif // BUFFERPOOL_H
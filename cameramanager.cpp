@@ -0,0 +1,122 @@
+#include "cameramanager.h" // Déclaration de la classe CameraManager.
+#include <QQmlEngine> // Propriété des objets renvoyés à QML.
+#include <QDebug> // Messages d'erreur.
+// Constructeur : aucune caméra ouverte
+CameraManager::CameraManager(QObject *parent) : QAbstractListModel(parent) {
+}
+// Destructeur : les caméras (enfants) sont détruites avant l'ordonnanceur qu'elles utilisent
+CameraManager::~CameraManager() {
+    qDeleteAll(m_cameras);
+}
+int CameraManager::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : m_cameras.size();
+}
+QVariant CameraManager::data(const QModelIndex &index, int role) const {
+    VideoCapture *capture = camera(index.row());
+    if (!index.isValid() || !capture) {
+        return QVariant();
+    }
+    switch (role) {
+    case CameraRole:
+        return QVariant::fromValue(capture);
+    case SourceIdRole:
+        return capture->sourceId();
+    case Qt::DisplayRole:
+    case FrameSourceRole:
+        return capture->frameSource();
+    case PriorityRole:
+        return capture->priority();
+    case MaxFpsRole:
+        return capture->maxFps();
+    case StatusRole:
+        return capture->status();
+    default:
+        return QVariant();
+    }
+}
+QHash<int, QByteArray> CameraManager::roleNames() const {
+    return {{CameraRole, "camera"}, {SourceIdRole, "sourceId"}, {FrameSourceRole, "frameSource"},
+            {PriorityRole, "priority"}, {MaxFpsRole, "maxFps"}, {StatusRole, "status"}};
+}
+int CameraManager::count() const {
+    return m_cameras.size();
+}
+int CameraManager::threadCount() const {
+    return WorkerPool::shared().threadCount();
+}
+VideoCapture *CameraManager::camera(int row) const {
+    return row >= 0 && row < m_cameras.size() ? m_cameras.at(row) : nullptr;
+}
+// Ouvre une source ("camera:1", "file:...", "synthetic"...) et l'inscrit auprès de l'ordonnanceur ; renvoie sa ligne
+int CameraManager::addCamera(const QString &spec, int priority, double maxFps) {
+    VideoCapture *capture = new VideoCapture(spec, &m_scheduler, this);
+    QQmlEngine::setObjectOwnership(capture, QQmlEngine::CppOwnership); // QML ne doit jamais la détruire.
+    capture->setPriority(priority);
+    capture->setMaxFps(maxFps);
+    connect(capture, &VideoCapture::statusChanged, this, [this, capture, spec]() {
+        if (capture->status() == QLatin1String("failed")) {
+            qWarning() << "Erreur : Impossible d'ouvrir la source :" << spec;
+            if (m_probing.removeOne(capture)) {
+                // Index de caméra absent (openCameras) : retiré hors de l'émission du signal par la caméra elle-même
+                QMetaObject::invokeMethod(this, [this, capture]() { removeCamera(m_cameras.indexOf(capture)); }, Qt::QueuedConnection);
+                return;
+            }
+        } else if (capture->status() == QLatin1String("ready")) {
+            m_probing.removeOne(capture);
+        }
+        cameraChanged(capture); // L'entrée reste : startCapture() pourra réessayer.
+    });
+    capture->startCapture(); // Rend la main aussitôt : l'ouverture se poursuit sur le thread de capture.
+    const int row = m_cameras.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_cameras.append(capture);
+    endInsertRows();
+    connect(capture, &VideoCapture::schedulingChanged, this, [this, capture]() { cameraChanged(capture); });
+    connect(capture, &VideoCapture::frameSourceChanged, this, [this, capture]() { cameraChanged(capture); });
+    emit countChanged();
+    return row;
+}
+// Ouvre les caméras 0 à count - 1 en parallèle ; renvoie le nombre de caméras en cours d'ouverture
+// (les index absents sont retirés du modèle quand leur ouverture échoue)
+int CameraManager::openCameras(int count, int priority, double maxFps) {
+    int opening = 0;
+    for (int i = 0; i < count; ++i) {
+        const int row = addCamera(QStringLiteral("camera:%1").arg(i), priority, maxFps);
+        VideoCapture *capture = m_cameras.at(row);
+        if (capture->status() == QLatin1String("failed") || !capture->isCapturing()) {
+            removeCamera(row);
+        } else {
+            m_probing.append(capture);
+            ++opening;
+        }
+    }
+    return opening;
+}
+void CameraManager::removeCamera(int row) {
+    VideoCapture *capture = camera(row);
+    if (!capture) {
+        return;
+    }
+    beginRemoveRows(QModelIndex(), row, row);
+    m_cameras.removeAt(row);
+    m_probing.removeOne(capture);
+    endRemoveRows();
+    delete capture; // Se désinscrit de l'ordonnanceur et libère la caméra.
+    emit countChanged();
+}
+void CameraManager::setPriority(int row, int priority) {
+    if (VideoCapture *capture = camera(row)) {
+        capture->setPriority(priority);
+    }
+}
+void CameraManager::setMaxFps(int row, double maxFps) {
+    if (VideoCapture *capture = camera(row)) {
+        capture->setMaxFps(maxFps);
+    }
+}
+void CameraManager::cameraChanged(VideoCapture *camera) {
+    const int row = m_cameras.indexOf(camera);
+    if (row >= 0) {
+        emit dataChanged(index(row), index(row));
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef CAMERAMANAGER_H
+#define CAMERAMANAGER_H
+// Inclusion des bibliothèques nécessaires
+#include <QAbstractListModel> // Modèle de liste pour QML (une entrée par caméra).
+#include <QVector> // Caméras ouvertes.
+#include "camerascheduler.h" // Ordonnanceur commun à toutes les caméras.
+#include "videocapture.h" // Une capture par caméra.
+// Gestionnaire multi-caméras : ouvre N sources, confie le traitement de leurs frames à un seul ordonnanceur
+// sur le pool de threads partagé (un thread par cœur) et expose chaque caméra à QML comme une entrée du modèle.
+// Rôles : camera (l'objet VideoCapture), sourceId, frameSource, priority, maxFps, status.
+// Les sources s'ouvrent en parallèle, chacune sur son thread de capture : addCamera() rend la main aussitôt.
+class CameraManager : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged) // Nombre de caméras ouvertes.
+    Q_PROPERTY(int threadCount READ threadCount CONSTANT) // Threads du pool partagé.
+public:
+    enum Roles { CameraRole = Qt::UserRole + 1, SourceIdRole, FrameSourceRole, PriorityRole, MaxFpsRole, StatusRole };
+    explicit CameraManager(QObject *parent = nullptr);
+    ~CameraManager(); // Arrête les caméras avant l'ordonnanceur.
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+    int count() const; // Nombre de caméras.
+    int threadCount() const; // Threads du pool partagé.
+    Q_INVOKABLE VideoCapture *camera(int row) const; // Caméra d'une ligne (nullptr si hors limites).
+    Q_INVOKABLE int addCamera(const QString &spec, int priority = 0, double maxFps = 0.0); // Ouvre une source ; renvoie sa ligne (gardée même si l'ouverture échoue).
+    Q_INVOKABLE int openCameras(int count, int priority = 0, double maxFps = 0.0); // Ouvre "camera:0" à "camera:<count-1>" ; les index absents sont retirés dès leur échec.
+    Q_INVOKABLE void removeCamera(int row); // Arrête et retire une caméra.
+    Q_INVOKABLE void setPriority(int row, int priority); // Priorité d'une caméra.
+    Q_INVOKABLE void setMaxFps(int row, double maxFps); // Budget de FPS d'une caméra.
+signals:
+    void countChanged(); // Signal émis lorsqu'une caméra est ajoutée ou retirée.
+private:
+    void cameraChanged(VideoCapture *camera); // Notifie la vue qu'une entrée a changé.
+    CameraScheduler m_scheduler; // Répartition des traitements (déclaré avant les caméras qui s'y inscrivent).
+    QVector<VideoCapture *> m_cameras; // Caméras ouvertes (enfants du gestionnaire).
+    QVector<VideoCapture *> m_probing; // Caméras d'openCameras() dont l'ouverture n'a pas abouti (retirées si elle échoue).
+};
+#endif // CAMERAMANAGER_H
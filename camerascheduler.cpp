@@ -0,0 +1,151 @@
+#include "camerascheduler.h" // Déclaration de la classe CameraScheduler.
+#include <algorithm> // std::sort, std::max.
+#include <chrono> // Budgets de FPS.
+static int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static int64_t intervalFor(double maxFps) {
+    return maxFps > 0.0 ? static_cast<int64_t>(1e9 / maxFps) : 0;
+}
+// Constructeur : lance le thread de répartition
+CameraScheduler::CameraScheduler(WorkerPool *pool) : m_pool(pool) {
+    m_thread = std::thread(&CameraScheduler::dispatchLoop, this);
+}
+// Destructeur : arrête la répartition puis attend les traitements en cours
+CameraScheduler::~CameraScheduler() {
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeUp.notify_all();
+    m_thread.join();
+    std::unique_lock<std::mutex> locker(m_mutex);
+    m_jobDone.wait(locker, [this]() { return m_running == 0; });
+}
+int CameraScheduler::addCamera(std::function<bool()> ready, std::function<void()> process, int priority, double maxFps) {
+    auto camera = std::make_shared<Camera>();
+    camera->ready = std::move(ready);
+    camera->process = std::move(process);
+    camera->priority = priority;
+    camera->intervalNs = intervalFor(maxFps);
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        camera->id = m_nextId++;
+        m_cameras.push_back(camera);
+    }
+    wake(); // Une frame attend peut-être déjà.
+    return camera->id;
+}
+void CameraScheduler::removeCamera(int id) {
+    std::unique_lock<std::mutex> locker(m_mutex);
+    const std::shared_ptr<Camera> camera = find(id);
+    if (!camera) {
+        return;
+    }
+    m_cameras.erase(std::find(m_cameras.begin(), m_cameras.end(), camera));
+    camera->removed = true; // Le thread de répartition peut encore la tenir dans sa liste de caméras prêtes.
+    m_jobDone.wait(locker, [&]() { return !camera->inFlight; }); // Le propriétaire peut ensuite détruire ce que process() utilise.
+}
+void CameraScheduler::setPriority(int id, int priority) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    if (const std::shared_ptr<Camera> camera = find(id)) {
+        camera->priority = priority;
+    }
+}
+void CameraScheduler::setMaxFps(int id, double maxFps) {
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        if (const std::shared_ptr<Camera> camera = find(id)) {
+            camera->intervalNs = intervalFor(maxFps);
+        }
+    }
+    wake(); // L'échéance attendue a pu changer.
+}
+void CameraScheduler::setMaxConcurrent(int jobs) {
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_maxConcurrent = std::max(0, jobs);
+    }
+    wake();
+}
+void CameraScheduler::wake() {
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_wakePending = true;
+    }
+    m_wakeUp.notify_one();
+}
+std::shared_ptr<CameraScheduler::Camera> CameraScheduler::find(int id) const {
+    for (const std::shared_ptr<Camera> &camera : m_cameras) {
+        if (camera->id == id) {
+            return camera;
+        }
+    }
+    return nullptr;
+}
+// Fin du traitement : libère la place et relance la répartition
+void CameraScheduler::finished(Camera &camera) {
+    std::lock_guard<std::mutex> locker(m_mutex); // Notifie sous le verrou : l'attente réveillée peut détruire l'ordonnanceur.
+    camera.inFlight = false;
+    --m_running;
+    m_wakePending = true;
+    m_wakeUp.notify_one();
+    m_jobDone.notify_all();
+}
+// Boucle du thread de répartition : lance le traitement des caméras prêtes dans la limite des places libres
+void CameraScheduler::dispatchLoop() {
+    std::vector<std::shared_ptr<Camera>> due; // Réutilisé d'un passage à l'autre.
+    std::unique_lock<std::mutex> locker(m_mutex);
+    while (!m_stopping) {
+        m_wakePending = false;
+        const int64_t now = nowNs();
+        int64_t nextDeadline = INT64_MAX; // Prochaine fin de budget d'une caméra prête.
+        due.clear();
+        for (const std::shared_ptr<Camera> &camera : m_cameras) {
+            if (camera->inFlight || !camera->ready()) {
+                continue;
+            }
+            const int64_t dueAt = camera->lastDispatchNs + camera->intervalNs;
+            if (now < dueAt) {
+                nextDeadline = std::min(nextDeadline, dueAt); // Frame prête mais budget de FPS atteint.
+                continue;
+            }
+            due.push_back(camera);
+        }
+        // Attente pondérée par la priorité : une caméra de priorité p passe avant une caméra de priorité 0
+        // qui attend depuis moins de p + 1 fois plus longtemps (aucune caméra n'est affamée)
+        std::sort(due.begin(), due.end(), [now](const std::shared_ptr<Camera> &a, const std::shared_ptr<Camera> &b) {
+            const double waitA = static_cast<double>(now - a->lastDispatchNs) * (1 + std::max(0, a->priority));
+            const double waitB = static_cast<double>(now - b->lastDispatchNs) * (1 + std::max(0, b->priority));
+            return waitA > waitB;
+        });
+        const int capacity = m_maxConcurrent > 0 ? m_maxConcurrent : std::max(1, m_pool->workerCount());
+        for (const std::shared_ptr<Camera> &camera : due) {
+            if (m_running >= capacity) {
+                break; // Les suivantes attendent une place (fin de traitement = réveil).
+            }
+            if (camera->removed) {
+                continue; // Désinscrite pendant la soumission précédente (verrou relâché).
+            }
+            camera->inFlight = true;
+            camera->lastDispatchNs = now;
+            ++m_running;
+            std::shared_ptr<Camera> job = camera; // La tâche garde la caméra même si elle est désinscrite entre-temps.
+            locker.unlock();
+            m_pool->submit([this, job]() {
+                job->process();
+                finished(*job);
+            });
+            locker.lock();
+        }
+        if (m_wakePending) {
+            continue; // Réveil pendant la soumission : nouveau passage immédiat.
+        }
+        if (nextDeadline == INT64_MAX) {
+            m_wakeUp.wait(locker, [this]() { return m_stopping || m_wakePending; });
+        } else {
+            const std::chrono::steady_clock::time_point deadline(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(nextDeadline)));
+            m_wakeUp.wait_until(locker, deadline, [this]() { return m_stopping || m_wakePending; });
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef CAMERASCHEDULER_H
+#define CAMERASCHEDULER_H
+// Inclusion des bibliothèques nécessaires
+#include "workerpool.h" // Pool partagé qui exécute les traitements.
+#include <condition_variable> // Réveil du thread de répartition.
+#include <cstdint> // Horodatages.
+#include <functional> // Fonctions de chaque caméra.
+#include <memory> // std::shared_ptr pour les caméras (une tâche en cours garde la sienne).
+#include <mutex> // État partagé avec les tâches.
+#include <thread> // Thread de répartition.
+#include <vector> // Caméras inscrites.
+// Ordonnanceur multi-caméras : remplace le QTimer de chaque capture par un seul thread de répartition qui
+// confie le traitement de chaque nouvelle frame au pool de threads partagé. Une caméra a au plus un
+// traitement en cours (ses frames restent dans l'ordre, son état n'est jamais partagé entre deux threads) ;
+// sa cadence est plafonnée par son budget de FPS. Quand toutes les places sont prises, la caméra qui attend
+// depuis le plus longtemps passe d'abord, son attente comptant p + 1 fois pour une priorité p.
+// La lecture des caméras reste sur leur thread de capture : une lecture bloque jusqu'à l'arrivée de la
+// frame suivante et immobiliserait un thread de calcul.
+class CameraScheduler {
+public:
+    explicit CameraScheduler(WorkerPool *pool = &WorkerPool::shared());
+    ~CameraScheduler(); // Attend la fin des traitements en cours.
+    // Inscrit une caméra : ready() dit si une nouvelle frame attend (appelée souvent, doit être immédiate),
+    // process() la traite sur un thread du pool. Renvoie l'identifiant de la caméra.
+    int addCamera(std::function<bool()> ready, std::function<void()> process, int priority = 0, double maxFps = 0.0);
+    void removeCamera(int id); // Désinscrit une caméra (attend la fin de son traitement en cours).
+    void setPriority(int id, int priority); // Plus grand = servi plus souvent quand le pool est saturé (0 par défaut).
+    void setMaxFps(int id, double maxFps); // Budget de FPS (0 = cadence de la source).
+    void setMaxConcurrent(int jobs); // Traitements simultanés (0 = threads de travail du pool).
+    void wake(); // Une nouvelle frame est disponible (appelé par les threads de capture).
+private:
+    // Caméra inscrite
+    struct Camera {
+        int id;
+        std::function<bool()> ready;
+        std::function<void()> process;
+        int priority = 0;
+        int64_t intervalNs = 0; // Intervalle minimal entre deux traitements (budget de FPS).
+        int64_t lastDispatchNs = 0; // Dernier traitement lancé.
+        bool inFlight = false; // Traitement en cours.
+        bool removed = false; // Désinscrite : plus aucun traitement ne doit être lancé.
+    };
+    void dispatchLoop(); // Boucle du thread de répartition.
+    void finished(Camera &camera); // Fin du traitement d'une caméra (thread du pool).
+    std::shared_ptr<Camera> find(int id) const; // Caméra d'identifiant donné (sous m_mutex).
+    WorkerPool *m_pool;
+    mutable std::mutex m_mutex; // Protège tout l'état ci-dessous.
+    std::condition_variable m_wakeUp; // Nouvelle frame, fin de traitement, réglage ou arrêt.
+    std::condition_variable m_jobDone; // Fin de traitement (désinscription, destruction).
+    std::vector<std::shared_ptr<Camera>> m_cameras; // Caméras inscrites.
+    int m_nextId = 1;
+    int m_maxConcurrent = 0; // 0 = threads de travail du pool.
+    int m_running = 0; // Traitements en cours.
+    bool m_wakePending = false; // Un réveil est arrivé depuis le dernier passage.
+    bool m_stopping = false;
+    std::thread m_thread; // Thread de répartition (dernier membre : démarré quand tout le reste est construit).
+};
+#endif // CAMERASCHEDULER_H
@@ -0,0 +1,152 @@
+#include "captureengine.h" // Déclaration de la classe CaptureEngine.
+#include <chrono> // Horodatage des frames.
+// Constructeur
+CaptureEngine::CaptureEngine(int ringCapacity) : m_ring(ringCapacity) {
+}
+// Destructeur
+CaptureEngine::~CaptureEngine() {
+    stop();
+}
+// Démarre le thread de capture, qui ouvre la source avant de lire les frames
+bool CaptureEngine::start(std::unique_ptr<FrameSource> source) {
+    stop(); // Un seul thread de capture à la fois.
+    if (!source) {
+        return false;
+    }
+    m_source = std::move(source);
+    m_ring.reset();
+    m_endOfStream = false;
+    m_openNs = -1;
+    m_firstFrameNs = -1;
+    {
+        std::lock_guard<std::mutex> locker(m_configMutex);
+        m_configPending = false; // La source est ouverte avec ses propres réglages.
+    }
+    m_startTime = std::chrono::steady_clock::now();
+    m_state = State::Opening;
+    m_running = true;
+    m_thread = std::thread(&CaptureEngine::run, this); // À partir d'ici, seul le thread de capture touche la source.
+    return true;
+}
+// Arrête le thread et ferme la source
+void CaptureEngine::stop() {
+    m_running = false;
+    if (m_thread.joinable()) {
+        m_thread.join(); // Attend la fin de la lecture en cours.
+    }
+    if (m_source) {
+        m_source->close(); // Libère la caméra ou le fichier
+        m_source.reset();
+    }
+    m_state = State::Stopped;
+}
+// Vrai si le thread de capture tourne
+bool CaptureEngine::isRunning() const {
+    return m_running;
+}
+CaptureEngine::State CaptureEngine::state() const {
+    return m_state;
+}
+int64_t CaptureEngine::openNs() const {
+    return m_openNs;
+}
+int64_t CaptureEngine::firstFrameNs() const {
+    return m_firstFrameNs;
+}
+// Demande au thread de capture de changer les réglages de la source ouverte (appliqués entre deux lectures)
+bool CaptureEngine::configure(int width, int height, int fps) {
+    if (!m_running || !m_source || !m_source->isConfigurable()) {
+        return false; // Pas de source, ou source à rouvrir (fichier, séquence).
+    }
+    std::lock_guard<std::mutex> locker(m_configMutex);
+    m_configPending = true;
+    m_configWidth = width;
+    m_configHeight = height;
+    m_configFps = fps;
+    return true;
+}
+// Anneau des frames capturées
+FrameRing &CaptureEngine::ring() {
+    return m_ring;
+}
+const FrameRing &CaptureEngine::ring() const {
+    return m_ring;
+}
+// Vrai si la source a atteint la fin du flux
+bool CaptureEngine::endOfStream() const {
+    return m_endOfStream;
+}
+// Nombre de lectures échouées
+uint64_t CaptureEngine::grabFailures() const {
+    return m_grabFailures;
+}
+void CaptureEngine::setMetrics(PipelineMetrics *metrics) {
+    m_metrics = metrics;
+}
+void CaptureEngine::setFrameListener(std::function<void()> listener) {
+    m_frameListener = std::move(listener);
+}
+void CaptureEngine::setStateListener(std::function<void()> listener) {
+    m_stateListener = std::move(listener);
+}
+void CaptureEngine::setState(State state) {
+    m_state = state;
+    if (m_stateListener) {
+        m_stateListener();
+    }
+}
+// Boucle du thread de capture : ouvre la source puis la lit aussi vite qu'elle livre les frames
+void CaptureEngine::run() {
+    if (!m_source->open()) {
+        m_running = false;
+        setState(State::Failed);
+        return;
+    }
+    m_openNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_startTime).count();
+    setState(State::Running);
+    const bool lossless = !m_source->isLive() && m_source->pacing() == FrameSource::Pacing::Unthrottled; // Rejeu sans perte.
+    while (m_running) {
+        {
+            std::unique_lock<std::mutex> locker(m_configMutex);
+            if (m_configPending) {
+                m_configPending = false;
+                const int width = m_configWidth, height = m_configHeight, fps = m_configFps;
+                locker.unlock();
+                m_source->configure(width, height, fps); // Entre deux lectures : le pilote n'est pas en train de livrer une frame.
+            }
+        }
+        if (lossless && !m_ring.isLatestConsumed()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50)); // Attend que la frame précédente soit traitée.
+            continue;
+        }
+        cv::Mat *buffer = m_ring.beginWrite(); // Tampon d'une case libre (réutilisé, pas d'allocation en régime établi).
+        if (!buffer) {
+            m_source->skip(); // Toutes les cases sont lues : on vide quand même le tampon du pilote pour rester à jour.
+            continue;
+        }
+        if (!m_source->grab(*buffer)) {
+            m_ring.abortWrite();
+            if (!m_source->isLive()) { // Fin du fichier ou de la séquence : le thread s'arrête.
+                m_endOfStream = true;
+                m_running = false;
+                setState(State::Stopped);
+                break;
+            }
+            ++m_grabFailures;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10)); // Évite de boucler à vide si la caméra ne répond plus.
+            continue;
+        }
+        if (m_metrics) {
+            m_metrics->record(PipelineMetrics::Grab, m_source->lastReadNs());
+        }
+        const auto now = std::chrono::steady_clock::now().time_since_epoch();
+        m_ring.commitWrite(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()); // Publie la frame horodatée.
+        if (m_firstFrameNs < 0) {
+            m_firstFrameNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_startTime).count();
+            setState(State::Running); // Prévient l'écouteur : délai de la première frame connu.
+        }
+        if (m_frameListener) {
+            m_frameListener();
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef CAPTUREENGINE_H
+#define CAPTUREENGINE_H
+// Inclusion des bibliothèques nécessaires
+#include "framering.h" // Anneau "dernière frame" partagé avec les consommateurs.
+#include "framesource.h" // Source des frames (caméra, fichier, séquence d'images, mire).
+#include "metrics.h" // Durée des lectures.
+#include <atomic> // Indicateur d'arrêt et compteurs.
+#include <chrono> // Délai de la première frame.
+#include <functional> // Notification des nouvelles frames.
+#include <memory> // std::unique_ptr pour la source.
+#include <mutex> // Reconfiguration demandée au thread de capture.
+#include <thread> // Thread de capture dédié.
+// Moteur de capture : un thread dédié possède la source (caméra, fichier...) et publie chaque frame lue,
+// horodatée, dans un FrameRing. Les consommateurs (affichage, enregistrement, instantanés)
+// prennent la dernière frame sans bloquer la lecture de la caméra.
+// Une source enregistrée lue sans cadencement est rejouée sans perte : le thread attend que chaque
+// frame ait été lue avant de publier la suivante, pour un rejeu déterministe au débit maximal.
+// La source est ouverte par le thread de capture lui-même : start() rend la main aussitôt (une caméra peut mettre
+// plusieurs secondes à négocier son format) et l'état passe de Opening à Running ou Failed.
+class CaptureEngine {
+public:
+    enum class State { Stopped, Opening, Running, Failed }; // Arrêté, ouverture en cours, frames en cours de lecture, ouverture impossible.
+    explicit CaptureEngine(int ringCapacity = 4); // Capacité de l'anneau (consommateurs simultanés + 2).
+    ~CaptureEngine(); // Arrête le thread et libère la caméra.
+    bool start(std::unique_ptr<FrameSource> source); // Lance le thread de capture, qui ouvre la source ; faux sans source.
+    void stop(); // Arrête le thread et ferme la source.
+    bool isRunning() const; // Vrai si le thread de capture tourne (ouverture comprise).
+    State state() const; // État de la source.
+    int64_t openNs() const; // Durée de l'ouverture de la source (-1 tant qu'elle n'est pas ouverte).
+    int64_t firstFrameNs() const; // Temps entre start() et la première frame publiée (-1 tant qu'il n'y en a pas).
+    bool configure(int width, int height, int fps); // Change résolution et FPS sans rouvrir la source ; faux si elle ne le permet pas.
+    bool endOfStream() const; // Vrai si la source s'est arrêtée en fin de flux (fichier, séquence).
+    FrameRing &ring(); // Anneau des frames capturées.
+    const FrameRing &ring() const;
+    uint64_t grabFailures() const; // Nombre de lectures caméra échouées.
+    void setMetrics(PipelineMetrics *metrics); // Mesures de l'étape "grab" (à régler avant start()).
+    void setFrameListener(std::function<void()> listener); // Appelée par le thread de capture après chaque frame publiée (à régler avant start()).
+    void setStateListener(std::function<void()> listener); // Appelée par le thread de capture à l'ouverture, à l'échec et à la première frame (à régler avant start()).
+private:
+    void run(); // Boucle du thread de capture.
+    void setState(State state); // Change l'état et prévient l'écouteur.
+    std::unique_ptr<FrameSource> m_source; // Source (utilisée uniquement par le thread de capture une fois lancé).
+    FrameRing m_ring; // Frames publiées.
+    std::thread m_thread; // Thread de capture.
+    std::atomic<bool> m_running{false}; // Demande d'exécution de la boucle.
+    std::atomic<uint64_t> m_grabFailures{0}; // Compteur de lectures échouées.
+    std::atomic<bool> m_endOfStream{false}; // Fin du flux atteinte.
+    PipelineMetrics *m_metrics = nullptr; // Mesures (facultatives).
+    std::function<void()> m_frameListener; // Réveil d'un ordonnanceur (facultatif).
+    std::function<void()> m_stateListener; // Suivi de l'ouverture (facultatif).
+    std::atomic<State> m_state{State::Stopped}; // État de la source.
+    std::chrono::steady_clock::time_point m_startTime; // Appel de start().
+    std::atomic<int64_t> m_openNs{-1}; // Durée de l'ouverture.
+    std::atomic<int64_t> m_firstFrameNs{-1}; // Délai de la première frame.
+    std::mutex m_configMutex; // Protège la reconfiguration en attente.
+    bool m_configPending = false; // Une reconfiguration attend le thread de capture.
+    int m_configWidth = 0; // Résolution et FPS demandés.
+    int m_configHeight = 0;
+    int m_configFps = 0;
+};
+#endif // CAPTUREENGINE_H
@@ -0,0 +1,117 @@
+#include "changedetector.h" // Déclaration de la classe ChangeDetector.
+#include <opencv2/imgproc.hpp> // cv::resize, cv::cvtColor.
+#include <algorithm> // std::max, std::min.
+static const int reduction = 4; // Facteur de réduction de la luminance comparée.
+void ChangeDetector::setTileSize(int pixels) {
+    m_tileSize = std::max(4 * reduction, (pixels + reduction - 1) / reduction * reduction);
+    reset(); // La grille change.
+}
+int ChangeDetector::tileSize() const {
+    return m_tileSize;
+}
+void ChangeDetector::setThreshold(int levels) {
+    m_threshold = std::max(0, levels);
+}
+int ChangeDetector::threshold() const {
+    return m_threshold;
+}
+int ChangeDetector::tileCount() const {
+    return m_grid.area();
+}
+void ChangeDetector::reset() {
+    m_reference.release(); // La prochaine frame sert de référence et est entièrement modifiée.
+}
+// Compare une frame à la référence et met à jour la référence des tuiles modifiées
+int ChangeDetector::detect(const cv::Mat &bgr) {
+    if (bgr.empty()) {
+        return 0;
+    }
+    const cv::Size small(std::max(1, bgr.cols / reduction), std::max(1, bgr.rows / reduction));
+    if (bgr.size() != m_frameSize) {
+        // Nouvelle taille : grille de tuiles et correspondance image réduite -> tuile
+        m_frameSize = bgr.size();
+        m_grid = cv::Size((bgr.cols + m_tileSize - 1) / m_tileSize, (bgr.rows + m_tileSize - 1) / m_tileSize);
+        m_columnTile.resize(small.width);
+        for (int x = 0; x < small.width; ++x) {
+            m_columnTile[x] = std::min(m_grid.width - 1, x * bgr.cols / small.width / m_tileSize);
+        }
+        m_rowTile.resize(small.height);
+        for (int y = 0; y < small.height; ++y) {
+            m_rowTile[y] = std::min(m_grid.height - 1, y * bgr.rows / small.height / m_tileSize);
+        }
+        m_reference.release();
+    }
+    cv::resize(bgr, m_small, small, 0, 0, cv::INTER_AREA); // Moyenne par zone : le bruit du capteur s'y annule en grande partie.
+    if (m_small.channels() == 3) {
+        cv::cvtColor(m_small, m_luma, cv::COLOR_BGR2GRAY);
+    } else {
+        m_small.copyTo(m_luma);
+    }
+    m_dirty.create(m_grid, CV_8U);
+    if (m_reference.empty()) {
+        m_luma.copyTo(m_reference); // Pas de référence : tout est à traiter.
+        m_dirty.setTo(cv::Scalar::all(1));
+        return m_grid.area();
+    }
+    // SAD point à point sur l'image réduite, puis un dépassement du seuil suffit à marquer la tuile
+    cv::absdiff(m_luma, m_reference, m_diff);
+    m_dirty.setTo(cv::Scalar::all(0));
+    const uchar limit = static_cast<uchar>(std::min(m_threshold, 255));
+    for (int y = 0; y < m_diff.rows; ++y) {
+        const uchar *diff = m_diff.ptr<uchar>(y);
+        uchar *dirty = m_dirty.ptr<uchar>(m_rowTile[y]);
+        for (int x = 0; x < m_diff.cols; ++x) {
+            dirty[m_columnTile[x]] |= static_cast<uchar>(diff[x] > limit);
+        }
+    }
+    const int count = cv::countNonZero(m_dirty);
+    // Nouvelle référence pour les points des tuiles modifiées seulement (elles vont être retraitées)
+    for (int y = 0; count > 0 && y < m_luma.rows; ++y) {
+        const uchar *dirty = m_dirty.ptr<uchar>(m_rowTile[y]);
+        const uchar *luma = m_luma.ptr<uchar>(y);
+        uchar *reference = m_reference.ptr<uchar>(y);
+        for (int x = 0; x < m_luma.cols; ++x) {
+            if (dirty[m_columnTile[x]]) {
+                reference[x] = luma[x];
+            }
+        }
+    }
+    return count;
+}
+// Tuiles à retraiter : les tuiles modifiées, étendues aux voisines qu'un noyau de rayon margin atteint
+std::vector<cv::Rect> ChangeDetector::dirtyTiles(int margin) const {
+    std::vector<cv::Rect> tiles;
+    if (m_dirty.empty()) {
+        return tiles;
+    }
+    const int reach = (std::max(0, margin) + m_tileSize - 1) / m_tileSize; // Tuiles voisines touchées par le halo.
+    const cv::Rect frame(cv::Point(), m_frameSize);
+    for (int ty = 0; ty < m_grid.height; ++ty) {
+        for (int tx = 0; tx < m_grid.width; ++tx) {
+            bool dirty = false;
+            for (int y = std::max(0, ty - reach); y <= std::min(m_grid.height - 1, ty + reach) && !dirty; ++y) {
+                for (int x = std::max(0, tx - reach); x <= std::min(m_grid.width - 1, tx + reach) && !dirty; ++x) {
+                    dirty = m_dirty.at<uchar>(y, x) != 0;
+                }
+            }
+            if (dirty) {
+                tiles.push_back(cv::Rect(tx * m_tileSize, ty * m_tileSize, m_tileSize, m_tileSize) & frame);
+            }
+        }
+    }
+    return tiles;
+}
+// Compte une frame examinée
+void ChangeDetector::account(int processedTiles) {
+    ++m_stats.frames;
+    m_stats.tiles += m_grid.area();
+    m_stats.processedTiles += processedTiles;
+    if (processedTiles == 0) {
+        ++m_stats.skippedFrames;
+    }
+}
+ChangeDetector::Stats ChangeDetector::takeStats() {
+    const Stats stats = m_stats;
+    m_stats = Stats();
+    return stats;
+}
@@ -0,0 +1,45 @@
+#ifndef CHANGEDETECTOR_H
+#define CHANGEDETECTOR_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat pour les images.
+#include <cstdint> // Compteurs.
+#include <vector> // Tuiles modifiées.
+// Détection de changement entre frames, par tuiles. La luminance est réduite d'un facteur 4 (moyenne par zone, qui
+// efface l'essentiel du bruit du capteur) puis comparée point à point (SAD) à une référence : une tuile est modifiée
+// dès qu'un point réduit s'en écarte de plus du seuil. La référence d'une tuile n'est remplacée que lorsque la tuile
+// est déclarée modifiée : une dérive lente (éclairage) finit par dépasser le seuil au lieu de passer inaperçue.
+// Non protégée : utilisée par un seul thread à la fois (le traitement des frames, sous son verrou).
+class ChangeDetector {
+public:
+    // Compteurs d'une fenêtre de mesure
+    struct Stats {
+        uint64_t frames = 0; // Frames examinées.
+        uint64_t skippedFrames = 0; // Frames dont la sortie précédente a été réutilisée telle quelle.
+        uint64_t tiles = 0; // Tuiles examinées.
+        uint64_t processedTiles = 0; // Tuiles retraitées (toutes quand la frame a été traitée en entier).
+    };
+    void setTileSize(int pixels); // Côté des tuiles en pixels de la frame (arrondi à un multiple de 4, 64 par défaut).
+    int tileSize() const;
+    void setThreshold(int levels); // Écart de luminance (moyenne de 4x4 pixels) à partir duquel un point a changé.
+    int threshold() const;
+    int detect(const cv::Mat &bgr); // Compare une frame BGR à la référence ; renvoie le nombre de tuiles modifiées.
+    int tileCount() const; // Nombre de tuiles de la dernière frame examinée.
+    std::vector<cv::Rect> dirtyTiles(int margin) const; // Tuiles modifiées et leurs voisines à moins de margin pixels (coordonnées de la frame).
+    void account(int processedTiles); // Compte une frame examinée et ses tuiles retraitées (0 = sortie réutilisée).
+    Stats takeStats(); // Compteurs depuis le dernier appel (remis à zéro).
+    void reset(); // Oublie la référence : la prochaine frame est entièrement modifiée.
+private:
+    int m_tileSize = 64; // Côté d'une tuile (pixels de la frame).
+    int m_threshold = 10; // Seuil de changement d'un point réduit.
+    cv::Size m_frameSize; // Taille des frames comparées.
+    cv::Size m_grid; // Nombre de tuiles en largeur et en hauteur.
+    std::vector<int> m_columnTile; // Colonne de tuile de chaque colonne de l'image réduite.
+    std::vector<int> m_rowTile; // Ligne de tuile de chaque ligne de l'image réduite.
+    cv::Mat m_reference; // Luminance réduite de référence.
+    cv::Mat m_small; // Frame réduite (BGR).
+    cv::Mat m_luma; // Luminance réduite de la frame courante.
+    cv::Mat m_diff; // Écart absolu à la référence.
+    cv::Mat m_dirty; // Tuiles modifiées de la dernière frame (CV_8U, une valeur par tuile).
+    Stats m_stats; // Fenêtre de mesure courante.
+};
+#endif // CHANGEDETECTOR_H
@@ -0,0 +1,298 @@
+#include "facedetector.h" // Déclaration de la classe FaceDetector.
+#include "metrics.h" // Logs du pipeline.
+#include <opencv2/imgproc.hpp> // resize, matchTemplate, dessin.
+#include <algorithm> // std::max, std::remove_if, std::any_of.
+#include <cmath> // std::lround.
+static const double trackingThreshold = 0.5; // Corrélation minimale pour considérer un visage retrouvé.
+static const int maxMisses = 3; // Suivis manqués consécutifs avant d'abandonner un visage.
+static const int minFaceSize = 30; // Taille minimale d'un visage à pleine résolution (comme l'ancien appel).
+// Constructeur : le thread de détection ne démarre qu'au premier envoi
+FaceDetector::FaceDetector()
+    : m_fpsWindowStart(std::chrono::steady_clock::now()) {
+}
+// Destructeur : arrête le thread (une détection en cours se termine d'abord)
+FaceDetector::~FaceDetector() {
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeUp.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+// Charge le modèle (avant la première frame : le thread de détection ne le lit qu'après un envoi)
+bool FaceDetector::load(const std::string &path) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    const bool loaded = m_cascade.load(path);
+    m_model = loaded ? Model::Loaded : Model::Failed;
+    return loaded;
+}
+// Retient le modèle sans le lire : le thread de détection le charge avant sa première analyse
+void FaceDetector::setModelPath(const std::string &path) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    if (m_model != Model::Loaded || path != m_modelPath) {
+        m_modelPath = path;
+        m_model = path.empty() ? Model::None : Model::Pending;
+    }
+}
+bool FaceDetector::isLoaded() const {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_model == Model::Loaded;
+}
+bool FaceDetector::modelFailed() const {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_model == Model::Failed;
+}
+void FaceDetector::setDetectionInterval(int frames) {
+    m_interval = std::max(1, frames);
+}
+int FaceDetector::detectionInterval() const {
+    return m_interval;
+}
+void FaceDetector::setIntervalFactor(int factor) {
+    m_intervalFactor = std::max(1, factor);
+}
+// Change l'échelle d'analyse : les visages suivis (coordonnées réduites) ne sont plus valables
+void FaceDetector::setDetectionScale(double scale) {
+    scale = std::min(1.0, std::max(0.1, scale));
+    if (scale != m_scale) {
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_scale = scale; // Lu par le thread de détection pour la taille minimale et le contrôle du résultat.
+        }
+        reset();
+    }
+}
+double FaceDetector::detectionScale() const {
+    return m_scale;
+}
+// Zones analysées : les visages suivis ailleurs sont oubliés
+void FaceDetector::setRegions(const std::vector<cv::Rect2d> &regions) {
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        if (regions == m_regions) {
+            return;
+        }
+        m_regions = regions; // Reprises par le thread de détection à la prochaine image.
+    }
+    reset();
+}
+// Oublie les visages suivis et le résultat en attente
+void FaceDetector::reset() {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_faces.clear();
+    m_detected.clear();
+    m_hasResult = false;
+    m_trackAttempts = 0;
+    m_trackHits = 0;
+    m_stats.faceCount = 0;
+    m_stats.trackingHitRate = 0.0;
+}
+FaceDetector::Stats FaceDetector::stats() const {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_stats;
+}
+// Traitement d'une frame : ne fait que du travail borné (réduction, corrélations locales, dessin)
+void FaceDetector::process(cv::Mat &bgr, const cv::Mat &gray) {
+    if (bgr.empty() || gray.empty()) {
+        return;
+    }
+    cv::resize(gray, m_small, cv::Size(), m_scale, m_scale, cv::INTER_AREA);
+    cv::equalizeHist(m_small, m_small); // Égalisation sur l'image réduite : même rôle que l'ancien equalizeHist pleine résolution.
+    ++m_framesSinceSubmit;
+    bool submitted = false;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        if (m_hasResult) {
+            m_faces.swap(m_detected); // Résultat neuf : il remplace les visages suivis (recalés ci-dessous sur la frame courante).
+            m_hasResult = false;
+        }
+        const bool usable = m_model == Model::Loaded || m_model == Model::Pending; // Modèle chargé ou à charger au premier envoi.
+        if (usable && !m_busy && !m_pending && m_framesSinceSubmit >= m_interval * m_intervalFactor) {
+            m_small.copyTo(m_input); // Le détecteur est libre : il ne lit plus m_input.
+            m_submitTime = std::chrono::steady_clock::now();
+            m_inputScale = m_scale;
+            m_pending = true;
+            m_framesSinceSubmit = 0;
+            submitted = true;
+        }
+    }
+    if (submitted) {
+        if (!m_thread.joinable()) {
+            m_thread = std::thread(&FaceDetector::detectionLoop, this); // Première détection demandée.
+        }
+        m_wakeUp.notify_one();
+    }
+    track(m_small);
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_stats.faceCount = static_cast<int>(m_faces.size());
+        m_stats.trackingHitRate = m_trackAttempts ? static_cast<double>(m_trackHits) / m_trackAttempts : 0.0;
+    }
+    draw(bgr, m_scale);
+}
+// Suivi : corrélation normalisée du modèle de chaque visage dans une fenêtre autour de sa dernière position
+void FaceDetector::track(const cv::Mat &small) {
+    const cv::Rect bounds(0, 0, small.cols, small.rows);
+    for (Face &face : m_faces) {
+        ++m_trackAttempts;
+        const int marginX = face.rect.width / 2; // Déplacement maximal d'une frame à l'autre.
+        const int marginY = face.rect.height / 2;
+        const cv::Rect window = cv::Rect(face.rect.x - marginX, face.rect.y - marginY,
+                                         face.rect.width + 2 * marginX, face.rect.height + 2 * marginY) & bounds;
+        if (window.width < face.patch.cols || window.height < face.patch.rows) {
+            ++face.misses; // Visage sorti de l'image.
+            continue;
+        }
+        cv::matchTemplate(small(window), face.patch, m_scores, cv::TM_CCOEFF_NORMED);
+        double best = 0.0;
+        cv::Point location;
+        cv::minMaxLoc(m_scores, nullptr, &best, nullptr, &location);
+        if (best >= trackingThreshold) {
+            face.rect.x = window.x + location.x;
+            face.rect.y = window.y + location.y;
+            face.misses = 0;
+            ++m_trackHits;
+        } else {
+            ++face.misses;
+        }
+    }
+    m_faces.erase(std::remove_if(m_faces.begin(), m_faces.end(), [](const Face &face) { return face.misses > maxMisses; }),
+                  m_faces.end());
+}
+// Dessine les visages suivis à pleine résolution
+void FaceDetector::draw(cv::Mat &bgr, double scale) const {
+    std::vector<cv::Rect> faces;
+    faces.reserve(m_faces.size());
+    for (const Face &face : m_faces) {
+        const cv::Rect &small = face.rect;
+        faces.push_back(cv::Rect(static_cast<int>(std::lround(small.x / scale)), static_cast<int>(std::lround(small.y / scale)),
+                                 static_cast<int>(std::lround(small.width / scale)), static_cast<int>(std::lround(small.height / scale))));
+    }
+    drawFaces(bgr, faces);
+}
+// Annotations des visages (mêmes que l'ancienne détection synchrone)
+void FaceDetector::drawFaces(cv::Mat &bgr, const std::vector<cv::Rect> &faces) {
+    const cv::Scalar color(0, 255, 0); // Couleur verte pour dessiner le rectangle
+    for (size_t i = 0; i < faces.size(); ++i) {
+        const cv::Rect &face = faces[i];
+        cv::rectangle(bgr, face, color, 2);
+        const std::string text = "Visage " + std::to_string(i + 1);
+        const cv::Point textOrg(face.x, face.y - 10); // Position du texte au-dessus du visage
+        cv::putText(bgr, text, textOrg, cv::FONT_HERSHEY_SIMPLEX, 0.5, color, 1);
+        cv::putText(bgr, text, textOrg + cv::Point(2, 2), cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 0, 0), 1); // Ombre
+    }
+}
+// Détection synchrone : même réduction, égalisation et paramètres que le thread de détection
+std::vector<cv::Rect> FaceDetector::detect(cv::CascadeClassifier &cascade, const cv::Mat &gray, double scale) {
+    std::vector<cv::Rect> faces;
+    if (cascade.empty() || gray.empty()) {
+        return faces;
+    }
+    scale = std::max(0.1, std::min(1.0, scale));
+    cv::Mat small;
+    cv::resize(gray, small, cv::Size(), scale, scale, cv::INTER_AREA);
+    cv::equalizeHist(small, small);
+    const int minSize = std::max(12, static_cast<int>(std::lround(minFaceSize * scale)));
+    cascade.detectMultiScale(small, faces, 1.1, 3, 0, cv::Size(minSize, minSize));
+    for (cv::Rect &face : faces) {
+        face = cv::Rect(static_cast<int>(std::lround(face.x / scale)), static_cast<int>(std::lround(face.y / scale)),
+                        static_cast<int>(std::lround(face.width / scale)), static_cast<int>(std::lround(face.height / scale)));
+    }
+    return faces;
+}
+// Boucle du thread de détection : analyse la dernière image envoyée, publie les visages et leurs modèles
+void FaceDetector::detectionLoop() {
+    for (;;) {
+        cv::Mat image;
+        std::chrono::steady_clock::time_point submitTime;
+        double scale;
+        std::string modelPath; // Modèle à charger avant l'analyse (vide si déjà chargé).
+        std::vector<cv::Rect2d> regions; // Zones à analyser (vide = image entière).
+        {
+            std::unique_lock<std::mutex> locker(m_mutex);
+            m_wakeUp.wait(locker, [this]() { return m_stopping || m_pending; });
+            if (m_stopping) {
+                return;
+            }
+            image = m_input; // Partage l'en-tête : process() ne réécrit m_input qu'une fois m_busy retombé.
+            submitTime = m_submitTime;
+            scale = m_inputScale;
+            regions = m_regions;
+            m_pending = false;
+            m_busy = true;
+            if (m_model == Model::Pending) {
+                modelPath = m_modelPath;
+            }
+        }
+        if (!modelPath.empty()) {
+            // Chargement différé : hors verrou, process() continue de suivre et de dessiner pendant ce temps
+            const auto loadStart = std::chrono::steady_clock::now();
+            const bool loaded = m_cascade.load(modelPath);
+            const double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+            if (!loaded) {
+                qCWarning(lcPipeline) << "Erreur : Impossible de charger le modèle Haarcascade depuis :" << QString::fromStdString(modelPath);
+            }
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_stats.modelLoadMs = loadMs;
+            if (modelPath == m_modelPath && m_model == Model::Pending) {
+                m_model = loaded ? Model::Loaded : Model::Failed;
+            }
+            if (!loaded) {
+                m_busy = false; // Plus aucun envoi : process() ne voit plus de modèle utilisable.
+                continue;
+            }
+        }
+        std::vector<cv::Rect> rects;
+        const int minSize = std::max(12, static_cast<int>(std::lround(minFaceSize * scale)));
+        if (regions.empty()) {
+            m_cascade.detectMultiScale(image, rects, 1.1, 3, 0, cv::Size(minSize, minSize));
+        } else {
+            // Cascade limitée aux zones : son coût suit leur surface
+            const cv::Rect bounds(0, 0, image.cols, image.rows);
+            std::vector<cv::Rect> found;
+            for (const cv::Rect2d &region : regions) {
+                const cv::Rect area = cv::Rect(cvRound(region.x * image.cols), cvRound(region.y * image.rows),
+                                               cvRound(region.width * image.cols), cvRound(region.height * image.rows)) & bounds;
+                if (area.width < minSize || area.height < minSize) {
+                    continue;
+                }
+                m_cascade.detectMultiScale(image(area), found, 1.1, 3, 0, cv::Size(minSize, minSize));
+                for (const cv::Rect &rect : found) {
+                    const cv::Rect face = rect + area.tl();
+                    const cv::Point center(face.x + face.width / 2, face.y + face.height / 2);
+                    const bool duplicate = std::any_of(rects.begin(), rects.end(), [&center](const cv::Rect &other) { return other.contains(center); });
+                    if (!duplicate) { // Zones qui se chevauchent : le même visage trouvé deux fois.
+                        rects.push_back(face);
+                    }
+                }
+            }
+        }
+        std::vector<Face> faces;
+        faces.reserve(rects.size());
+        for (const cv::Rect &rect : rects) {
+            Face face;
+            face.rect = rect;
+            face.patch = image(rect).clone(); // Modèle de suivi pris sur l'image analysée.
+            faces.push_back(std::move(face));
+        }
+        const auto now = std::chrono::steady_clock::now();
+        const double latencyMs = std::chrono::duration<double, std::milli>(now - submitTime).count();
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_busy = false;
+        if (scale == m_scale) { // Résultat obtenu à une autre échelle : coordonnées inutilisables.
+            m_detected.swap(faces);
+            m_hasResult = true;
+        }
+        m_stats.detectionLatencyMs = m_stats.detections ? 0.8 * m_stats.detectionLatencyMs + 0.2 * latencyMs : latencyMs; // Moyenne glissante.
+        ++m_stats.detections;
+        ++m_fpsWindowCount;
+        const double windowSeconds = std::chrono::duration<double>(now - m_fpsWindowStart).count();
+        if (windowSeconds >= 1.0) {
+            m_stats.detectionFps = m_fpsWindowCount / windowSeconds;
+            m_fpsWindowCount = 0;
+            m_fpsWindowStart = now;
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef FACEDETECTOR_H
+#define FACEDETECTOR_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat et cv::Rect.
+#include <opencv2/objdetect.hpp> // cv::CascadeClassifier.
+#include <chrono> // Mesure de la latence de détection.
+#include <condition_variable> // Réveil du thread de détection.
+#include <cstdint> // Compteurs.
+#include <mutex> // Échanges avec le thread de détection.
+#include <string> // Chemin du modèle.
+#include <thread> // Thread de détection.
+#include <vector> // Liste des visages.
+// Détection de visages asynchrone : la cascade tourne sur un thread dédié, sur une image réduite (égalisée après
+// réduction) et seulement toutes les N frames ; entre deux détections, chaque visage est suivi par corrélation
+// de son modèle dans une fenêtre autour de sa dernière position. process() ne bloque jamais : il dessine les derniers résultats connus.
+// Le thread et le modèle ne coûtent rien tant qu'aucune frame ne demande de visages : avec setModelPath(), le thread de
+// détection démarre au premier envoi et charge lui-même la cascade avant sa première analyse.
+class FaceDetector {
+public:
+    // Mesures exposées à l'interface
+    struct Stats {
+        double detectionLatencyMs = 0.0; // Temps entre l'envoi d'une frame au détecteur et son résultat.
+        double detectionFps = 0.0; // Détections terminées par seconde.
+        double trackingHitRate = 0.0; // Part des suivis réussis (visage retrouvé entre deux détections).
+        int faceCount = 0; // Visages actuellement suivis.
+        uint64_t detections = 0; // Nombre total de détections terminées.
+        double modelLoadMs = 0.0; // Durée du chargement différé du modèle (0 tant qu'il n'a pas eu lieu).
+    };
+    FaceDetector();
+    ~FaceDetector(); // Arrête le thread de détection (s'il a démarré).
+    bool load(const std::string &path); // Charge le modèle Haar tout de suite (appelé avant la première frame).
+    void setModelPath(const std::string &path); // Modèle Haar chargé par le thread de détection à la première frame à analyser.
+    bool isLoaded() const;
+    bool modelFailed() const; // Vrai si le chargement (immédiat ou différé) du modèle a échoué.
+    void setDetectionInterval(int frames); // Une détection au plus toutes les N frames (1 = dès que le détecteur est libre).
+    int detectionInterval() const;
+    void setIntervalFactor(int factor); // Multiplie l'intervalle de détection (régulateur de qualité), sans changer le réglage.
+    void setDetectionScale(double scale); // Facteur de réduction de l'image analysée (0.5 = moitié de la résolution).
+    double detectionScale() const;
+    void setRegions(const std::vector<cv::Rect2d> &regions); // Zones analysées par la cascade, en fractions de l'image (vide = image entière).
+    void process(cv::Mat &bgr, const cv::Mat &gray); // Suit les visages, lance une détection si besoin et dessine.
+    Stats stats() const; // Dernières mesures.
+    void reset(); // Oublie les visages suivis (changement de source).
+    // Détection synchrone d'une image isolée, sans thread ni suivi (traitement hors ligne de frames indépendantes)
+    static std::vector<cv::Rect> detect(cv::CascadeClassifier &cascade, const cv::Mat &gray, double scale); // Visages en coordonnées de gray.
+    static void drawFaces(cv::Mat &bgr, const std::vector<cv::Rect> &faces); // Mêmes annotations que process().
+private:
+    // Visage suivi (coordonnées dans l'image réduite)
+    struct Face {
+        cv::Rect rect; // Position courante.
+        cv::Mat patch; // Modèle de corrélation (gris égalisé réduit).
+        int misses = 0; // Suivis manqués consécutifs.
+    };
+    void detectionLoop(); // Boucle du thread de détection.
+    void track(const cv::Mat &small); // Met à jour la position des visages suivis.
+    void draw(cv::Mat &bgr, double scale) const; // Dessine les visages suivis sur l'image affichée.
+    enum class Model { None, Pending, Loaded, Failed }; // Aucun modèle, chargement différé, chargé, illisible.
+    cv::CascadeClassifier m_cascade; // Modèle Haar (utilisé seulement par le thread de détection).
+    std::thread m_thread; // Thread de détection (démarré par le premier envoi).
+    mutable std::mutex m_mutex; // Protège les champs partagés ci-dessous.
+    std::condition_variable m_wakeUp; // Nouvelle image à analyser ou arrêt.
+    bool m_stopping = false; // Demande d'arrêt du thread.
+    Model m_model = Model::None; // État du modèle.
+    std::string m_modelPath; // Modèle à charger par le thread de détection.
+    bool m_pending = false; // Une image attend le détecteur.
+    bool m_busy = false; // Le détecteur analyse une image.
+    cv::Mat m_input; // Image réduite envoyée au détecteur (tampon réutilisé).
+    std::chrono::steady_clock::time_point m_submitTime; // Heure d'envoi de m_input.
+    double m_inputScale = 0.5; // Échelle de m_input.
+    std::vector<cv::Rect2d> m_regions; // Zones analysées (fractions de l'image).
+    std::vector<Face> m_detected; // Résultat de la dernière détection, pas encore repris par process().
+    bool m_hasResult = false; // Vrai si m_detected contient un résultat neuf.
+    Stats m_stats; // Mesures (latence, débit, taux de suivi).
+    std::chrono::steady_clock::time_point m_fpsWindowStart; // Fenêtre de calcul du débit de détection.
+    int m_fpsWindowCount = 0; // Détections terminées dans la fenêtre.
+    // État propre au thread appelant process()
+    std::vector<Face> m_faces; // Visages suivis.
+    cv::Mat m_small; // Gris égalisé réduit de la frame courante (tampon réutilisé).
+    cv::Mat m_scores; // Carte de corrélation (tampon réutilisé).
+    int m_framesSinceSubmit = 0; // Frames depuis le dernier envoi au détecteur.
+    int m_interval = 5; // Intervalle de détection en frames.
+    int m_intervalFactor = 1; // Multiplicateur de l'intervalle (charge élevée).
+    double m_scale = 0.5; // Facteur de réduction.
+    uint64_t m_trackAttempts = 0; // Suivis tentés.
+    uint64_t m_trackHits = 0; // Suivis réussis.
+};
+#endif // FACEDETECTOR_H
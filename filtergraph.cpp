@@ -0,0 +1,757 @@
+#include "filtergraph.h" // Déclaration de la classe FilterGraph.
+#include "metrics.h" // Logs limités du pipeline.
+#include "pixelkernels.h" // Noyaux fusionnés avec la conversion d'affichage.
+#include "temporalfilters.h" // Accumulateurs des étapes temporelles.
+#include <algorithm> // std::max.
+#include <cfloat> // DBL_EPSILON (normalisation min/max).
+// Noms QML des étapes, dans l'ordre de l'énumération StageType
+static const char *const stageNames[FilterGraph::StageTypeCount] = {
+    "none", "gray", "invert", "gaussian", "median", "clahe", "sobel", "saltpepper", "normalize", "canny",
+    "bilateral", "laplacian", "sharpen", "cartoon", "motionblur", "emboss", "sepia", "faces",
+    "denoise", "background", "trails", "longexposure"};
+// Bruit sel & poivre : xorshift32 sur quatre voies indépendantes. Les quatre pas d'une itération sont identiques et
+// sans dépendance entre eux : le compilateur les exécute dans un registre vectoriel (SSE2, NEON). count est un multiple de 4.
+static void fillRandom(uint32_t state[4], uint32_t *out, int count) {
+    uint32_t lanes[4] = {state[0], state[1], state[2], state[3]};
+    for (int i = 0; i < count; i += 4) {
+        for (int lane = 0; lane < 4; ++lane) {
+            uint32_t x = lanes[lane];
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            lanes[lane] = x;
+            out[i + lane] = x;
+        }
+    }
+    for (int lane = 0; lane < 4; ++lane) {
+        state[lane] = lanes[lane];
+    }
+}
+// Constructeur : chaîne vide
+FilterGraph::FilterGraph() {
+}
+// Nom QML -> type d'étape
+FilterGraph::StageType FilterGraph::typeFromName(const QString &name) {
+    for (int i = 0; i < StageTypeCount; ++i) {
+        if (name.compare(QLatin1String(stageNames[i]), Qt::CaseInsensitive) == 0) {
+            return static_cast<StageType>(i);
+        }
+    }
+    return None;
+}
+// Type d'étape -> nom QML
+QString FilterGraph::nameOfType(StageType type) {
+    return (type >= 0 && type < StageTypeCount) ? QString::fromLatin1(stageNames[type]) : QString();
+}
+// Construit une étape avec ses paramètres (valeurs par défaut = anciens modes de filtre)
+FilterGraph::Stage FilterGraph::makeStage(StageType type, const QVariantMap &params, bool lightweight) {
+    // Taille de noyau, réduite de moitié en mode allégé (coût en carré de la taille pour les noyaux 2D)
+    auto kernelSize = [lightweight](int size) {
+        size |= 1; // Taille impaire obligatoire.
+        return lightweight ? std::max(3, (size / 2) | 1) : size;
+    };
+    Stage stage;
+    stage.type = type;
+    switch (type) {
+    case Gaussian:
+        stage.size = kernelSize(params.value("size", 5).toInt());
+        stage.a = params.value("sigma", 0.0).toDouble();
+        break;
+    case Median:
+        stage.size = kernelSize(params.value("size", 5).toInt());
+        break;
+    case Clahe:
+        stage.a = params.value("clipLimit", 2.0).toDouble();
+        stage.size = params.value("tiles", 8).toInt();
+        stage.clahe = cv::createCLAHE(stage.a, cv::Size(stage.size, stage.size)); // Créé une fois, réutilisé à chaque frame.
+        break;
+    case Sobel:
+        stage.size = params.value("size", 3).toInt() | 1;
+        break;
+    case SaltPepper:
+        stage.size = params.value("count", 500).toInt();
+        break;
+    case Canny:
+        stage.a = params.value("low", 100.0).toDouble();
+        stage.b = params.value("high", 200.0).toDouble();
+        break;
+    case Bilateral:
+        stage.size = params.value("diameter", 9).toInt();
+        if (lightweight && stage.size > 3) {
+            stage.size = std::max(3, stage.size / 2); // Voisinage quatre fois plus petit.
+        }
+        stage.a = params.value("sigmaColor", 75.0).toDouble();
+        stage.b = params.value("sigmaSpace", 75.0).toDouble();
+        break;
+    case Laplacian:
+        stage.size = params.value("size", 3).toInt() | 1;
+        break;
+    case Sharpen:
+        stage.kernel = (cv::Mat_<float>(3, 3) << 0, -1, 0, -1, 5, -1, 0, -1, 0);
+        break;
+    case Cartoon:
+        stage.size = kernelSize(params.value("size", 7).toInt()); // Médiane appliquée au gris.
+        stage.a = params.value("block", 9).toInt() | 1; // Taille du voisinage du seuillage adaptatif.
+        stage.b = params.value("c", 2.0).toDouble(); // Constante soustraite à la moyenne.
+        break;
+    case MotionBlur:
+        stage.size = kernelSize(params.value("size", 15).toInt()); // Longueur du filé horizontal.
+        break;
+    case Emboss:
+        stage.kernel = (cv::Mat_<float>(3, 3) << -2, -1, 0, -1, 1, 1, 0, 1, 2);
+        break;
+    case Sepia:
+        stage.kernel = (cv::Mat_<float>(3, 3) <<
+                            0.272, 0.534, 0.131,
+                        0.349, 0.686, 0.168,
+                        0.393, 0.769, 0.189);
+        break;
+    case Denoise:
+        stage.size = TemporalFilters::shiftForFrames(params.value("frames", 4).toInt()); // Fenêtre de la moyenne.
+        break;
+    case Background:
+        stage.size = TemporalFilters::shiftForFrames(params.value("frames", 128).toInt()); // Vitesse d'apprentissage du fond.
+        stage.a = params.value("threshold", 30).toInt(); // Écart au fond d'un pixel de premier plan.
+        break;
+    case Trails:
+        stage.size = TemporalFilters::shiftForFrames(params.value("frames", 16).toInt()); // Durée de vie des traînées.
+        break;
+    case LongExposure:
+        stage.size = TemporalFilters::shiftForFrames(params.value("frames", 32).toInt());
+        stage.a = params.value("blend", "lighten").toString() == "average" ? 1.0 : 0.0; // Moyenne, ou maximum (traînées lumineuses).
+        break;
+    default:
+        break; // Étapes sans paramètre.
+    }
+    return stage;
+}
+// Compile une chaîne décrite depuis QML
+bool FilterGraph::setChain(const QVariantList &chain, QString *error) {
+    std::vector<Stage> stages;
+    if (!compile(chain, m_lightweight, &stages, error)) {
+        return false; // La chaîne précédente reste active.
+    }
+    m_stages.swap(stages);
+    m_chain = chain;
+    simplify();
+    return true;
+}
+// Construit les étapes d'une chaîne (false si une étape est inconnue)
+bool FilterGraph::compile(const QVariantList &chain, bool lightweight, std::vector<Stage> *stages, QString *error) {
+    for (const QVariant &item : chain) {
+        const QVariantMap params = item.toMap(); // Objet {type: "...", ...} ou simple nom.
+        const QString name = params.isEmpty() ? item.toString() : params.value("type").toString();
+        bool isMode = false;
+        const int mode = name.toInt(&isMode); // Un numéro d'ancien mode est aussi accepté.
+        const StageType type = isMode ? static_cast<StageType>(mode) : typeFromName(name);
+        if ((isMode && (mode < 0 || mode >= StageTypeCount)) || (!isMode && type == None && name.compare("none", Qt::CaseInsensitive) != 0)) {
+            if (error) {
+                *error = QStringLiteral("Étape de filtre inconnue : %1").arg(name);
+            }
+            return false;
+        }
+        stages->push_back(makeStage(type, params, lightweight));
+    }
+    return true;
+}
+// Chaîne d'une seule étape (ancien mode entier)
+void FilterGraph::setSingleMode(int mode) {
+    const StageType type = (mode > 0 && mode < StageTypeCount) ? static_cast<StageType>(mode) : None;
+    m_stages.clear();
+    m_stages.push_back(makeStage(type, QVariantMap(), m_lightweight));
+    m_chain = QVariantList{nameOfType(type)};
+    simplify();
+}
+QVariantList FilterGraph::chain() const {
+    return m_chain;
+}
+BufferPool &FilterGraph::pool() {
+    return m_pool;
+}
+bool FilterGraph::isEmpty() const {
+    return m_stages.empty();
+}
+void FilterGraph::setThreadCount(int count) {
+    m_tiles.setThreadCount(count);
+}
+int FilterGraph::threadCount() const {
+    return m_tiles.threadCount();
+}
+// Recompile la chaîne avec des noyaux plus petits (ou d'origine)
+void FilterGraph::setLightweight(bool lightweight) {
+    if (lightweight == m_lightweight) {
+        return;
+    }
+    m_lightweight = lightweight;
+    std::vector<Stage> stages;
+    compile(m_chain, m_lightweight, &stages, nullptr); // Chaîne déjà validée.
+    m_stages.swap(stages);
+    simplify();
+    if (stages.size() == m_stages.size()) {
+        for (size_t i = 0; i < stages.size(); ++i) {
+            m_stages[i].history.swap(stages[i].history); // Les accumulateurs temporels survivent au changement de palier.
+        }
+    }
+}
+bool FilterGraph::isLightweight() const {
+    return m_lightweight;
+}
+bool FilterGraph::contains(StageType type) const {
+    for (const Stage &stage : m_stages) {
+        if (stage.type == type) {
+            return true;
+        }
+    }
+    return false;
+}
+// Sortie entièrement déterminée par l'image d'entrée (réutilisable tant que l'image ne change pas)
+bool FilterGraph::isDeterministic() const {
+    return !contains(SaltPepper) && !contains(Faces) && !isTemporal();
+}
+bool FilterGraph::isTemporal() const {
+    return contains(Denoise) || contains(Background) || contains(Trails) || contains(LongExposure);
+}
+// Portée spatiale de la chaîne : un pixel de sortie ne dépend que des pixels d'entrée à moins de halo() pixels
+int FilterGraph::halo() const {
+    int halo = 0;
+    for (const Stage &stage : m_stages) {
+        switch (stage.type) {
+        case Gray:
+        case Invert:
+        case Sepia:
+        case Denoise:
+        case Background:
+        case Trails:
+        case LongExposure:
+            break; // Pixel à pixel (dans l'espace ; les étapes temporelles dépendent aussi des frames précédentes).
+        case Gaussian:
+        case Median:
+            halo += stage.size / 2;
+            break;
+        case Sobel:
+        case Laplacian:
+            halo += std::max(1, stage.size / 2); // Taille 1 : noyau 3x1 ou 3x3.
+            break;
+        case Bilateral:
+            halo += bilateralRadius(stage);
+            break;
+        case Sharpen:
+        case Emboss:
+            halo += stage.kernel.rows / 2;
+            break;
+        case MotionBlur:
+            halo += stage.size / 2; // Horizontal seulement : la portée reste un majorant.
+            break;
+        case Cartoon:
+            halo += stage.size / 2 + static_cast<int>(stage.a) / 2; // Médiane puis seuillage adaptatif.
+            break;
+        default:
+            return -1; // CLAHE, normalisation, Canny (hystérésis), bruit et visages dépendent de toute l'image.
+        }
+    }
+    return halo;
+}
+void FilterGraph::setFaceHandler(const FaceHandler &handler) {
+    m_faceHandler = handler;
+}
+// Retire les étapes neutres et celles qui s'annulent deux à deux
+void FilterGraph::simplify() {
+    std::vector<Stage> simplified;
+    for (Stage &stage : m_stages) {
+        if (stage.type == None) {
+            continue; // Étape sans effet.
+        }
+        if (!simplified.empty()) {
+            const StageType previous = simplified.back().type;
+            if (stage.type == Invert && previous == Invert) {
+                simplified.pop_back(); // Deux inversions successives s'annulent.
+                continue;
+            }
+            if (stage.type == Gray && previous == Gray) {
+                continue; // Le passage en gris est idempotent.
+            }
+        }
+        simplified.push_back(std::move(stage));
+    }
+    m_stages.swap(simplified);
+}
+// Exécute la chaîne sur une frame (et produit l'image d'affichage si display est fourni)
+void FilterGraph::process(cv::Mat &frame, cv::Mat *display, bool keepFrame) {
+    if (frame.empty()) {
+        return;
+    }
+    // Dernière étape pixel à pixel : exécutée avec la conversion d'affichage si l'appelant en veut une
+    const bool fuse = display && !m_stages.empty() && isFusable(m_stages.back().type);
+    const size_t count = m_stages.size() - (fuse ? 1 : 0);
+    imageChanged(); // Nouvelle frame : aucun produit n'est valide.
+    m_frameStale = false;
+    m_expandGray = false;
+    for (size_t i = 0; i < count; ++i) {
+        runStage(m_stages[i], frame);
+    }
+    materialize(frame); // Reconstruit l'image si la dernière étape a travaillé dans les plans Lab.
+    if (fuse && runFused(m_stages.back(), frame, *display, keepFrame)) {
+        return;
+    }
+    if (fuse) {
+        runStage(m_stages.back(), frame); // Image sur un canal : pas de noyau fusionné.
+    }
+    if (m_expandGray && frame.channels() == 1) {
+        cv::Mat expanded = acquireLike(frame, CV_8UC3);
+        cv::cvtColor(frame, expanded, cv::COLOR_GRAY2BGR); // Sortie de l'étape Gray : gris sur trois canaux, comme l'ancien mode 1.
+        frame = expanded; // L'ancien tampon retourne au pool.
+    }
+    if (display) {
+        toDisplay(frame, *display);
+    }
+}
+// Recalcule des régions de la sortie précédente : chaque région, étendue du halo de la chaîne, est filtrée isolément
+bool FilterGraph::processRegions(const cv::Mat &source, cv::Mat &output, const std::vector<cv::Rect> &regions) {
+    const int margin = halo();
+    if (margin < 0 || source.empty() || output.size() != source.size()) {
+        return false;
+    }
+    const int threads = m_tiles.threadCount();
+    m_tiles.setThreadCount(1); // Petites images : le découpage en bandes coûterait plus qu'il ne rapporte.
+    const cv::Rect bounds(cv::Point(), source.size());
+    bool done = true;
+    for (const cv::Rect &region : regions) {
+        const cv::Rect extended = cv::Rect(region.x - margin, region.y - margin, region.width + 2 * margin,
+                                           region.height + 2 * margin) & bounds; // Bords de l'image : même extrapolation qu'en entier.
+        cv::Mat tile = m_pool.acquire(extended.height, extended.width, source.type());
+        source(extended).copyTo(tile);
+        process(tile);
+        if (tile.type() != output.type()) {
+            done = false; // Sortie d'un autre format (chaîne modifiée depuis output).
+            break;
+        }
+        tile(cv::Rect(region.tl() - extended.tl(), region.size())).copyTo(output(region));
+    }
+    m_tiles.setThreadCount(threads);
+    return done;
+}
+// Zones d'intérêt : chaque zone est filtrée à partir de l'image d'origine, puis le reste est assombri et les zones recopiées
+void FilterGraph::processRois(cv::Mat &frame, const std::vector<cv::Rect> &regions, double outsideGain, cv::Mat *display) {
+    if (frame.empty()) {
+        return;
+    }
+    const int margin = std::max(0, halo()); // Chaîne globale (CLAHE, Normalize...) : la zone est l'image.
+    const cv::Rect bounds(cv::Point(), frame.size());
+    std::vector<cv::Rect> placed;
+    placed.reserve(regions.size());
+    m_skipFaces = true;
+    m_historySlot = 0;
+    for (const cv::Rect &region : regions) {
+        const cv::Rect area = region & bounds;
+        ++m_historySlot; // Chaque zone garde son propre état temporel (l'image entière utilise le premier).
+        if (area.empty()) {
+            continue;
+        }
+        const cv::Rect extended = cv::Rect(area.x - margin, area.y - margin, area.width + 2 * margin,
+                                           area.height + 2 * margin) & bounds;
+        cv::Mat tile = m_pool.acquire(extended.height, extended.width, frame.type());
+        frame(extended).copyTo(tile); // Les zones qui se chevauchent lisent toutes l'image d'origine.
+        process(tile);
+        m_roiOutputs.push_back(tile(cv::Rect(area.tl() - extended.tl(), area.size())));
+        placed.push_back(area);
+    }
+    m_skipFaces = false;
+    m_historySlot = 0;
+    if (outsideGain < 1.0) {
+        const double gain = std::max(0.0, outsideGain);
+        m_tiles.forEachBand(frame.rows, [&frame, gain](int begin, int end) {
+            cv::Mat band = frame.rowRange(begin, end);
+            band.convertTo(band, -1, gain); // Une seule passe, vectorisée par OpenCV.
+        });
+    }
+    for (size_t i = 0; i < placed.size(); ++i) {
+        cv::Mat target = frame(placed[i]);
+        if (m_roiOutputs[i].channels() == frame.channels()) {
+            m_roiOutputs[i].copyTo(target);
+        } else {
+            cv::cvtColor(m_roiOutputs[i], target, frame.channels() == 3 ? cv::COLOR_GRAY2BGR : cv::COLOR_BGR2GRAY); // Sortie grise (Canny) dans l'image couleur.
+        }
+    }
+    m_roiOutputs.clear(); // Les tampons retournent au pool.
+    if (contains(Faces) && m_faceHandler) {
+        imageChanged(); // Les produits sont ceux de la dernière zone.
+        m_frameStale = false;
+        ensureColor(frame);
+        m_faceHandler(frame, gray(frame));
+        imageChanged();
+    }
+    if (display) {
+        toDisplay(frame, *display);
+    }
+}
+// Conversion d'affichage par bandes (BGR -> RGB vectorisé, ou gris -> RGB)
+void FilterGraph::toDisplay(const cv::Mat &frame, cv::Mat &rgb) {
+    rgb.create(frame.rows, frame.cols, CV_8UC3);
+    m_tiles.forEachBand(frame.rows, [&frame, &rgb](int begin, int end) {
+        const cv::Mat src = frame.rowRange(begin, end);
+        cv::Mat dst = rgb.rowRange(begin, end);
+        if (src.channels() == 1) {
+            cv::cvtColor(src, dst, cv::COLOR_GRAY2RGB); // Filtres qui produisent une image en niveaux de gris (Canny).
+        } else {
+            PixelKernels::bgrToRgb(src, dst);
+        }
+    });
+}
+// Rayon du voisinage, calculé comme dans cv::bilateralFilter (diamètre <= 0 : déduit de sigmaSpace)
+int FilterGraph::bilateralRadius(const Stage &stage) {
+    return stage.size > 0 ? stage.size / 2 : cvRound((stage.b > 0 ? stage.b : 1.0) * 1.5);
+}
+bool FilterGraph::isFusable(StageType type) {
+    return type == Gray || type == Invert || type == Normalize || type == Sepia;
+}
+// Exécute une étape pixel à pixel en écrivant directement l'image RGB (et la frame BGR si keepFrame)
+bool FilterGraph::runFused(Stage &stage, cv::Mat &frame, cv::Mat &rgb, bool keepFrame) {
+    if (stage.type == Sepia) {
+        ensureColor(frame); // Comme l'étape non fusionnée.
+    }
+    if (frame.channels() != 3) {
+        return false;
+    }
+    float alpha = 1.0f, beta = 0.0f;
+    if (stage.type == Normalize) {
+        // Min/max global comme dans runStage() ; la conversion elle-même est fusionnée
+        double minimum = 0.0, maximum = 0.0;
+        cv::minMaxIdx(frame.reshape(1), &minimum, &maximum);
+        const double scale = 255.0 * (maximum - minimum > DBL_EPSILON ? 1.0 / (maximum - minimum) : 0.0);
+        alpha = static_cast<float>(scale);
+        beta = static_cast<float>(-minimum * scale);
+    }
+    rgb.create(frame.rows, frame.cols, CV_8UC3);
+    const StageType type = stage.type;
+    m_tiles.forEachBand(frame.rows, [&frame, &rgb, keepFrame, type, alpha, beta](int begin, int end) {
+        const cv::Mat src = frame.rowRange(begin, end);
+        cv::Mat dst = rgb.rowRange(begin, end);
+        cv::Mat bgr = src; // Résultat BGR écrit sur place.
+        cv::Mat *out = keepFrame ? &bgr : nullptr;
+        switch (type) {
+        case Gray:
+            PixelKernels::gray(src, dst, out); // Le gris sur trois canaux : même sortie que Gray suivi de l'extension finale.
+            break;
+        case Invert:
+            PixelKernels::invert(src, dst, out);
+            break;
+        case Normalize:
+            PixelKernels::scale(src, alpha, beta, dst, out);
+            break;
+        default:
+            PixelKernels::sepia(src, dst, out);
+            break;
+        }
+    });
+    imageChanged();
+    return true;
+}
+// Tampon du pool de même taille que la frame
+cv::Mat FilterGraph::acquireLike(const cv::Mat &frame, int type) {
+    return m_pool.acquire(frame.rows, frame.cols, type);
+}
+// Exécute une étape sur l'image courante
+void FilterGraph::runStage(Stage &stage, cv::Mat &frame) {
+    switch (stage.type) {
+    case Gray:
+        if (frame.channels() != 1) {
+            frame = gray(frame); // L'image devient le gris (calculé ou réutilisé) ; l'ancien tampon BGR retourne au pool.
+            imageChanged(); // Le produit "gris" est désormais l'image elle-même.
+        }
+        m_expandGray = true; // Les étapes suivantes travaillent sur un seul canal ; extension en BGR seulement à la fin.
+        break;
+    case Invert:
+        materialize(frame);
+        m_tiles.run(frame, frame, 0, [](const cv::Mat &src, cv::Mat &dst) {
+            cv::bitwise_not(src, dst);
+        });
+        imageChanged();
+        break;
+    case Gaussian: {
+        materialize(frame);
+        const cv::Size size(stage.size, stage.size);
+        const double sigma = stage.a;
+        cv::Mat blurred = acquireLike(frame, frame.type()); // Hors place : les bandes voisines relisent leur halo.
+        m_tiles.run(frame, blurred, stage.size / 2, [size, sigma](const cv::Mat &src, cv::Mat &dst) {
+            cv::GaussianBlur(src, dst, size, sigma, 0, TileExecutor::border());
+        });
+        frame = blurred;
+        imageChanged();
+        break;
+    }
+    case Median: {
+        materialize(frame);
+        const int size = stage.size;
+        cv::Mat filtered = acquireLike(frame, frame.type());
+        m_tiles.run(frame, filtered, size / 2, [size](const cv::Mat &src, cv::Mat &dst) {
+            cv::medianBlur(src, dst, size); // Bord toujours répliqué à l'intérieur de l'image reçue.
+        });
+        frame = filtered;
+        imageChanged();
+        break;
+    }
+    case Clahe:
+        if (frame.channels() == 1) {
+            stage.clahe->apply(frame, frame); // Image en gris : égalisation directe, sans passer par Lab.
+            imageChanged();
+        } else {
+            std::vector<cv::Mat> &planes = labPlanes(frame); // Réutilise les plans si l'étape précédente était déjà un CLAHE.
+            stage.clahe->apply(planes[0], planes[0]);
+            const bool labValid = m_labValid;
+            imageChanged();
+            m_labValid = labValid; // Les plans Lab sont la nouvelle vérité...
+            m_frameStale = true; // ... l'image BGR ne sera reconstruite que si une étape en a besoin.
+        }
+        break;
+    case Sobel:
+        materialize(frame);
+        cv::Sobel(frame, stage.temp[0], CV_64F, 1, 0, stage.size); // Plans de gradient conservés dans l'état de l'étape.
+        cv::Sobel(frame, stage.temp[1], CV_64F, 0, 1, stage.size);
+        cv::magnitude(stage.temp[0], stage.temp[1], stage.temp[2]);
+        stage.temp[2].convertTo(frame, CV_8U);
+        imageChanged();
+        break;
+    case SaltPepper: {
+        materialize(frame);
+        cv::Mat &randoms = stage.temp[0]; // Deux tirages par point, alloués une fois.
+        randoms.create(1, (2 * stage.size + 3) / 4 * 4, CV_32S);
+        uint32_t *random = reinterpret_cast<uint32_t *>(randoms.data);
+        fillRandom(stage.random, random, randoms.cols);
+        for (int i = 0; i < stage.size; i++) {
+            const int x = static_cast<int>((static_cast<uint64_t>(random[2 * i]) * frame.cols) >> 32); // Réduction par produit : sans division ni biais du modulo.
+            const int y = static_cast<int>((static_cast<uint64_t>(random[2 * i + 1]) * frame.rows) >> 32);
+            const uchar value = (i % 2 == 0) ? 255 : 0; // Alternance sel (blanc) / poivre (noir).
+            if (frame.channels() == 1) {
+                frame.at<uchar>(y, x) = value;
+            } else {
+                frame.at<cv::Vec3b>(y, x) = cv::Vec3b(value, value, value);
+            }
+        }
+        imageChanged();
+        break;
+    }
+    case Normalize: {
+        materialize(frame);
+        // Même calcul que cv::normalize(frame, frame, 0, 255, NORM_MINMAX) : min/max global, puis conversion par bandes
+        double minimum = 0.0, maximum = 0.0;
+        cv::minMaxIdx(frame.reshape(1), &minimum, &maximum);
+        const double scale = 255.0 * (maximum - minimum > DBL_EPSILON ? 1.0 / (maximum - minimum) : 0.0);
+        const double shift = -minimum * scale;
+        m_tiles.run(frame, frame, 0, [scale, shift](const cv::Mat &src, cv::Mat &dst) {
+            src.convertTo(dst, -1, scale, shift);
+        });
+        imageChanged();
+        break;
+    }
+    case Canny: {
+        cv::Mat edges = acquireLike(frame, CV_8UC1);
+        cv::Canny(gray(frame), edges, stage.a, stage.b); // Réutilise le gris déjà calculé (étape Gray, Cartoon...).
+        frame = edges;
+        imageChanged();
+        m_expandGray = false; // La sortie de Canny reste sur un canal, comme l'ancien mode 9.
+        break;
+    }
+    case Bilateral: {
+        materialize(frame);
+        if (frame.channels() != 1 && frame.channels() != 3) {
+            static LogRateLimiter limiter; // Le message se répéterait à chaque frame.
+            if (limiter.allow()) {
+                qCWarning(lcPipeline) << "Format d'image non pris en charge pour Bilateral Filter.";
+            }
+            break;
+        }
+        const int diameter = stage.size;
+        const double sigmaColor = stage.a;
+        const double sigmaSpace = stage.b;
+        const int radius = bilateralRadius(stage);
+        cv::Mat filtered = acquireLike(frame, frame.type()); // Ne peut pas travailler sur place.
+        m_tiles.run(frame, filtered, radius, [diameter, sigmaColor, sigmaSpace](const cv::Mat &src, cv::Mat &dst) {
+            cv::bilateralFilter(src, dst, diameter, sigmaColor, sigmaSpace, TileExecutor::border());
+        });
+        frame = filtered; // L'ancien tampon retourne au pool.
+        imageChanged();
+        break;
+    }
+    case Laplacian:
+        materialize(frame);
+        cv::Laplacian(frame, stage.temp[0], CV_16S, stage.size); // CV_16S pour capturer les valeurs négatives/positives des gradients
+        cv::convertScaleAbs(stage.temp[0], frame); // Convertit en un format affichable (CV_8U)
+        imageChanged();
+        break;
+    case MotionBlur: {
+        // Filé horizontal : moyenne glissante sur stage.size pixels (coût indépendant de la longueur)
+        materialize(frame);
+        const int size = stage.size;
+        cv::Mat filtered = acquireLike(frame, frame.type());
+        m_tiles.run(frame, filtered, 0, [size](const cv::Mat &src, cv::Mat &dst) {
+            cv::blur(src, dst, cv::Size(size, 1), cv::Point(-1, -1), TileExecutor::border()); // Bandes pleine largeur : aucun recouvrement vertical.
+        });
+        frame = filtered;
+        imageChanged();
+        break;
+    }
+    case Denoise:
+    case Background:
+    case Trails:
+    case LongExposure:
+        materialize(frame);
+        runTemporal(stage, frame);
+        imageChanged();
+        break;
+    case Sharpen:
+    case Emboss: {
+        materialize(frame);
+        const cv::Mat kernel = stage.kernel; // Partagé en lecture seule par les bandes.
+        cv::Mat filtered = acquireLike(frame, frame.type()); // Même profondeur que l'entrée (CV_8U) pour les deux noyaux.
+        m_tiles.run(frame, filtered, kernel.rows / 2, [kernel](const cv::Mat &src, cv::Mat &dst) {
+            cv::filter2D(src, dst, -1, kernel, cv::Point(-1, -1), 0, TileExecutor::border());
+        });
+        frame = filtered;
+        imageChanged();
+        break;
+    }
+    case Cartoon: {
+        // Contours sombres : seuillage adaptatif du gris filtré, puis mise à zéro des pixels de contour
+        cv::Mat &edges = stage.temp[0];
+        cv::adaptiveThreshold(blurredGray(frame, stage.size), edges, 255, cv::ADAPTIVE_THRESH_MEAN_C,
+                              cv::THRESH_BINARY_INV, static_cast<int>(stage.a), stage.b);
+        frame.setTo(cv::Scalar::all(0), edges);
+        imageChanged();
+        break;
+    }
+    case Sepia:
+        ensureColor(frame); // La matrice sépia mélange les trois canaux.
+        m_tiles.run(frame, frame, 0, [&stage](const cv::Mat &src, cv::Mat &dst) {
+            cv::transform(src, dst, stage.kernel);
+        });
+        imageChanged();
+        break;
+    case Faces:
+        ensureColor(frame); // Les visages sont entourés en couleur.
+        if (m_faceHandler && !m_skipFaces) {
+            m_faceHandler(frame, gray(frame)); // Le gris est partagé avec les autres étapes ; le détecteur l'égalise après réduction.
+            imageChanged(); // Les annotations modifient l'image.
+        }
+        break;
+    default:
+        break;
+    }
+}
+// Étape temporelle : accumulateurs (re)créés à la première frame ou quand la taille change, puis mis à jour par bandes
+void FilterGraph::runTemporal(Stage &stage, cv::Mat &frame) {
+    const size_t slot = static_cast<size_t>(m_historySlot) * 2;
+    if (stage.history.size() < slot + 2) {
+        stage.history.resize(slot + 2);
+    }
+    cv::Mat &state = stage.history[slot]; // Accumulateur 8.8 (fond, moyenne, pose longue) ou traînée.
+    cv::Mat &previous = stage.history[slot + 1]; // Frame précédente (traînées).
+    const int shift = stage.size;
+    const StageType type = stage.type;
+    if (type == Trails) {
+        if (previous.size() != frame.size() || previous.type() != frame.type()) {
+            TemporalFilters::seedTrails(frame, previous, state);
+        }
+    } else if (state.size() != frame.size() || state.channels() != frame.channels()) {
+        TemporalFilters::seed(frame, state);
+    }
+    const int threshold = static_cast<int>(stage.a);
+    const bool average = stage.a != 0.0;
+    m_tiles.forEachBand(frame.rows, [&frame, &state, &previous, type, shift, threshold, average](int begin, int end) {
+        cv::Mat band = frame.rowRange(begin, end);
+        cv::Mat accumulator = state.rowRange(begin, end);
+        switch (type) {
+        case Denoise:
+            TemporalFilters::average(band, accumulator, shift);
+            break;
+        case Background:
+            TemporalFilters::foreground(band, accumulator, shift, threshold);
+            break;
+        case Trails: {
+            cv::Mat before = previous.rowRange(begin, end);
+            TemporalFilters::trails(band, before, accumulator, shift);
+            break;
+        }
+        default:
+            if (average) {
+                TemporalFilters::average(band, accumulator, shift); // Pose longue moyennée : même calcul, fenêtre plus longue.
+            } else {
+                TemporalFilters::lighten(band, accumulator, shift);
+            }
+            break;
+        }
+    });
+}
+// Invalide les produits dérivés de l'image
+void FilterGraph::imageChanged() {
+    m_grayValid = false;
+    m_blurredValid = false;
+    m_labValid = false;
+}
+// Reconstruit l'image BGR depuis les plans Lab si nécessaire
+void FilterGraph::materialize(cv::Mat &frame) {
+    if (m_frameStale) {
+        m_tiles.forEachBand(frame.rows, [this, &frame](int begin, int end) {
+            const cv::Mat planes[3] = {m_labPlanes[0].rowRange(begin, end), m_labPlanes[1].rowRange(begin, end),
+                                       m_labPlanes[2].rowRange(begin, end)};
+            cv::Mat lab = m_lab.rowRange(begin, end);
+            cv::merge(planes, 3, lab);
+            cv::Mat bgr = frame.rowRange(begin, end);
+            cv::cvtColor(lab, bgr, cv::COLOR_Lab2BGR); // Conversion pixel à pixel : pas de halo.
+        });
+        m_frameStale = false; // Les plans Lab restent valides : ils décrivent la même image.
+    }
+}
+// Garantit une image BGR 3 canaux
+void FilterGraph::ensureColor(cv::Mat &frame) {
+    materialize(frame);
+    if (frame.channels() == 1) {
+        cv::Mat expanded = acquireLike(frame, CV_8UC3);
+        cv::cvtColor(frame, expanded, cv::COLOR_GRAY2BGR);
+        frame = expanded;
+        m_expandGray = false; // Déjà étendue.
+    }
+}
+// Niveaux de gris de l'image courante (l'image elle-même si elle est déjà sur un canal)
+const cv::Mat &FilterGraph::gray(cv::Mat &frame) {
+    materialize(frame);
+    if (frame.channels() == 1) {
+        return frame;
+    }
+    if (!m_grayValid) {
+        m_gray = acquireLike(frame, CV_8UC1);
+        cv::cvtColor(frame, m_gray, cv::COLOR_BGR2GRAY);
+        m_grayValid = true;
+    }
+    return m_gray;
+}
+// Gris filtré par médiane
+const cv::Mat &FilterGraph::blurredGray(cv::Mat &frame, int size) {
+    if (!m_blurredValid || m_blurredSize != size) {
+        const cv::Mat &source = gray(frame);
+        m_blurred = acquireLike(frame, CV_8UC1);
+        cv::medianBlur(source, m_blurred, size);
+        m_blurredSize = size;
+        m_blurredValid = true;
+    }
+    return m_blurred;
+}
+// Plans Lab de l'image courante
+std::vector<cv::Mat> &FilterGraph::labPlanes(cv::Mat &frame) {
+    if (!m_labValid) {
+        ensureColor(frame);
+        m_lab.create(frame.rows, frame.cols, CV_8UC3);
+        m_labPlanes.resize(3);
+        for (cv::Mat &plane : m_labPlanes) {
+            plane.create(frame.rows, frame.cols, CV_8UC1); // Alloués une fois : les bandes écrivent dedans.
+        }
+        m_tiles.forEachBand(frame.rows, [this, &frame](int begin, int end) {
+            cv::Mat lab = m_lab.rowRange(begin, end);
+            cv::cvtColor(frame.rowRange(begin, end), lab, cv::COLOR_BGR2Lab);
+            cv::Mat planes[3] = {m_labPlanes[0].rowRange(begin, end), m_labPlanes[1].rowRange(begin, end),
+                                 m_labPlanes[2].rowRange(begin, end)};
+            cv::split(lab, planes);
+        });
+        m_labValid = true;
+    }
+    return m_labPlanes;
+}
@@ -0,0 +1,116 @@
+#ifndef FILTERGRAPH_H
+#define FILTERGRAPH_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat pour les images.
+#include <opencv2/imgproc.hpp> // cv::CLAHE et filtres.
+#include "bufferpool.h" // Pool de tampons réutilisés d'une frame à l'autre.
+#include "tileexecutor.h" // Exécution des filtres coûteux par bandes sur plusieurs cœurs.
+#include <QString> // Noms des étapes.
+#include <QVariantList> // Description de la chaîne depuis QML.
+#include <QVariantMap> // Paramètres d'une étape.
+#include <cstdint> // État du générateur de bruit.
+#include <functional> // std::function pour la détection de visages.
+#include <vector> // Liste des étapes.
+// Graphe de filtres : chaîne ordonnée d'étapes paramétrées, compilée une fois puis exécutée à chaque frame.
+// Les produits intermédiaires (niveaux de gris, plans Lab, gris flouté) sont calculés au plus
+// une fois par état de l'image et partagés entre les étapes ; les conversions qui s'annulent
+// (Lab -> BGR -> Lab entre deux CLAHE, gris -> BGR -> gris) ne sont jamais exécutées.
+// Tous les tampons viennent du pool ou de l'état des étapes : à résolution fixe, aucune allocation par frame.
+// Les filtres à noyau et les conversions pixel à pixel sont exécutés par bandes (TileExecutor) avec un résultat
+// identique à l'exécution en série ; Canny, Sobel, Laplacien, Cartoon et le CLAHE lui-même restent en série.
+// Une chaîne de filtres locaux peut aussi n'être recalculée que sur des régions (tuiles modifiées, processRegions),
+// et toute chaîne peut être limitée à des zones d'intérêt choisies par l'utilisateur (processRois).
+// Les étapes temporelles (Denoise, Background, Trails, LongExposure) gardent d'une frame à l'autre un accumulateur par
+// pixel (TemporalFilters) : frames à traiter dans l'ordre, par le même graphe.
+// Quand l'appelant demande aussi l'image d'affichage, une dernière étape pixel à pixel (Gray, Invert, Normalize, Sepia)
+// est fusionnée avec la conversion BGR -> RGB (PixelKernels) : une seule passe sur l'image au lieu de deux ou trois.
+class FilterGraph {
+public:
+    // Types d'étapes : la numérotation reprend les anciens modes de filtre (m_filterMode 0 à 17), puis les étapes temporelles.
+    enum StageType {
+        None = 0, Gray, Invert, Gaussian, Median, Clahe, Sobel, SaltPepper, Normalize, Canny,
+        Bilateral, Laplacian, Sharpen, Cartoon, MotionBlur, Emboss, Sepia, Faces,
+        Denoise, Background, Trails, LongExposure, StageTypeCount
+    };
+    // Fonction appelée pour l'étape Faces : reçoit l'image BGR (à annoter) et le gris partagé.
+    using FaceHandler = std::function<void(cv::Mat &bgr, const cv::Mat &gray)>;
+    FilterGraph();
+    bool setChain(const QVariantList &chain, QString *error = nullptr); // Compile une chaîne (chaînes de caractères ou objets {type, ...}).
+    void setSingleMode(int mode); // Chaîne d'une seule étape (ancien mode de filtre entier).
+    QVariantList chain() const; // Chaîne telle que décrite par l'appelant.
+    bool isEmpty() const; // Vrai si la chaîne compilée ne fait rien.
+    bool contains(StageType type) const; // Vrai si la chaîne compilée contient une étape de ce type.
+    bool isDeterministic() const; // Faux si la sortie peut changer sans que l'image change (bruit aléatoire, visages, étapes temporelles).
+    bool isTemporal() const; // Vrai si la sortie dépend des frames précédentes (frames à traiter dans l'ordre).
+    int halo() const; // Portée de la chaîne en pixels (somme des demi-noyaux) ; -1 si une étape dépend de toute l'image.
+    void setFaceHandler(const FaceHandler &handler); // Définit la détection de visages utilisée par l'étape Faces.
+    void setThreadCount(int count); // Threads utilisés par les étapes exécutées par bandes (1 = série, 0 = tous les cœurs).
+    void setLightweight(bool lightweight); // Noyaux réduits de moitié (flous, médianes, bilatéral) pour alléger la charge.
+    bool isLightweight() const;
+    int threadCount() const;
+    // Exécute la chaîne sur une frame BGR (la sortie peut être en niveaux de gris). Si display est fourni, y écrit aussi
+    // l'image RGB d'affichage ; avec keepFrame = false, frame peut ne pas refléter la dernière étape (personne ne la relit).
+    void process(cv::Mat &frame, cv::Mat *display = nullptr, bool keepFrame = true);
+    // Recalcule seulement les régions données de output (sortie BGR d'une frame précédente de même taille) à partir de
+    // source : chaque région est traitée, avec son halo, comme une image isolée. Faux si la chaîne n'est pas locale
+    // (halo() < 0) ou si output n'a pas le format de sortie de la chaîne ; output doit alors être recalculée en entier.
+    bool processRegions(const cv::Mat &source, cv::Mat &output, const std::vector<cv::Rect> &regions);
+    // Exécute la chaîne seulement dans les zones d'intérêt données (coordonnées de frame) : le coût suit leur surface.
+    // Chaque zone est filtrée comme une image isolée (étendue du halo d'une chaîne locale : mêmes bords qu'en entier) ;
+    // hors des zones, les pixels sont gardés tels quels ou multipliés par outsideGain (< 1 : assombris). L'étape Faces
+    // s'exécute une fois sur l'image entière, après les zones (le détecteur limite lui-même son analyse aux zones).
+    void processRois(cv::Mat &frame, const std::vector<cv::Rect> &regions, double outsideGain = 1.0, cv::Mat *display = nullptr);
+    void toDisplay(const cv::Mat &frame, cv::Mat &rgb); // Convertit une image BGR (ou grise) en RGB d'affichage, par bandes.
+    BufferPool &pool(); // Pool de tampons partagé avec l'appelant (frame de travail, affichage).
+    static StageType typeFromName(const QString &name); // Nom QML -> type ("gaussian", "clahe"...), None si inconnu.
+    static QString nameOfType(StageType type); // Type -> nom QML.
+private:
+    // Étape compilée : paramètres et état créés une fois, réutilisés à chaque frame
+    struct Stage {
+        StageType type = None; // Type de l'étape.
+        int size = 0; // Taille de noyau / de bloc / nombre de points selon l'étape.
+        double a = 0.0; // Premier paramètre réel (sigma, seuil bas, clipLimit...).
+        double b = 0.0; // Second paramètre réel (seuil haut, sigmaSpace, constante C...).
+        cv::Mat kernel; // Noyau constant construit à la compilation (filter2D, transform).
+        cv::Ptr<cv::CLAHE> clahe; // Objet CLAHE créé une seule fois.
+        cv::Mat temp[3]; // Tampons intermédiaires propres à l'étape (plans Sobel, Laplacien 16 bits...).
+        std::vector<cv::Mat> history; // État des étapes temporelles : accumulateur et frame précédente, par zone d'intérêt.
+        uint32_t random[4] = {0x9E3779B9u, 0x7F4A7C15u, 0x85EBCA6Bu, 0xC2B2AE35u}; // Générateur du bruit (quatre voies xorshift).
+    };
+    static Stage makeStage(StageType type, const QVariantMap &params, bool lightweight); // Construit une étape et ses objets constants.
+    static bool compile(const QVariantList &chain, bool lightweight, std::vector<Stage> *stages, QString *error); // Chaîne décrite -> étapes.
+    void simplify(); // Retire les étapes neutres ou qui s'annulent.
+    void runStage(Stage &stage, cv::Mat &frame); // Exécute une étape.
+    void runTemporal(Stage &stage, cv::Mat &frame); // Met à jour l'accumulateur d'une étape temporelle et écrit sa sortie.
+    static int bilateralRadius(const Stage &stage); // Rayon du voisinage du filtre bilatéral.
+    static bool isFusable(StageType type); // Vrai si l'étape a un noyau fusionné avec la conversion d'affichage.
+    bool runFused(Stage &stage, cv::Mat &frame, cv::Mat &rgb, bool keepFrame); // Étape + conversion RGB en une passe ; false si non applicable.
+    // Produits intermédiaires partagés (recalculés seulement si l'image a changé)
+    void imageChanged(); // Invalide les produits après une modification de l'image.
+    void materialize(cv::Mat &frame); // Reconstruit l'image BGR si la vérité est dans les plans Lab.
+    void ensureColor(cv::Mat &frame); // Garantit une image BGR 3 canaux (étapes qui en ont besoin).
+    cv::Mat acquireLike(const cv::Mat &frame, int type); // Tampon du pool de même taille que la frame.
+    const cv::Mat &gray(cv::Mat &frame); // Niveaux de gris de l'image courante.
+    const cv::Mat &blurredGray(cv::Mat &frame, int size); // Gris filtré par médiane.
+    std::vector<cv::Mat> &labPlanes(cv::Mat &frame); // Plans L, a, b de l'image courante.
+    std::vector<Stage> m_stages; // Chaîne compilée.
+    QVariantList m_chain; // Chaîne décrite par l'appelant.
+    FaceHandler m_faceHandler; // Détection de visages.
+    cv::Mat m_gray; // Produit : niveaux de gris.
+    cv::Mat m_blurred; // Produit : gris filtré par médiane.
+    int m_blurredSize = 0; // Taille de médiane du produit m_blurred.
+    cv::Mat m_lab; // Image Lab entrelacée.
+    std::vector<cv::Mat> m_labPlanes; // Produit : plans Lab.
+    BufferPool m_pool; // Tampons de la taille d'une frame (sorties hors place, produits).
+    TileExecutor m_tiles; // Découpage en bandes sur le pool de threads partagé.
+    bool m_grayValid = false; // Validité des produits pour l'état courant de l'image.
+    bool m_blurredValid = false;
+    bool m_labValid = false;
+    bool m_frameStale = false; // Vrai si l'image a été modifiée dans les plans Lab mais pas encore reconstruite.
+    bool m_expandGray = false; // Vrai si une sortie en gris doit être réétendue en BGR à la fin (étape Gray).
+    bool m_lightweight = false; // Paramètres allégés (régulateur de qualité).
+    bool m_skipFaces = false; // Étape Faces différée à l'image entière (zones d'intérêt).
+    int m_historySlot = 0; // Zone d'intérêt en cours : chacune a son propre état temporel.
+    std::vector<cv::Mat> m_roiOutputs; // Sorties des zones d'intérêt avant recopie (tampons du pool).
+};
+#endif // FILTERGRAPH_H
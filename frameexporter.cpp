@@ -0,0 +1,110 @@
+#include "frameexporter.h" // Déclaration de la classe FrameExporter.
+#include "metrics.h" // Logs limités du pipeline.
+#include <QCoreApplication> // Identifiant du processus écrivain.
+#include <algorithm> // std::max.
+#include <cstring> // std::memcpy.
+#include <new> // Construction des en-têtes dans le segment.
+static size_t alignTo64(size_t bytes) {
+    return (bytes + 63) / 64 * 64; // Cases et pixels alignés sur une ligne de cache.
+}
+FrameExporter::~FrameExporter() {
+    close();
+}
+void FrameExporter::setName(const QString &name) {
+    if (name != m_name) {
+        close(); // Les lecteurs de l'ancien nom voient le segment fermé.
+        m_name = name;
+    }
+}
+QString FrameExporter::name() const {
+    return m_name;
+}
+void FrameExporter::setSlotCount(int slots) {
+    m_slotCount = std::max(2, slots); // Une seule case serait réécrite pendant que le lecteur la lit.
+}
+bool FrameExporter::isOpen() const {
+    return m_header != nullptr;
+}
+uint64_t FrameExporter::publishedFrames() const {
+    return m_sequence;
+}
+// Crée le segment : en-tête, puis les cases ; l'état Live est écrit en dernier, quand tout est prêt
+bool FrameExporter::create(size_t frameBytes) {
+    close();
+    const size_t slotBytes = alignTo64(SharedFrames::slotHeaderBytes + frameBytes);
+    const size_t slotOffset = alignTo64(sizeof(SharedFrames::Header));
+    if (slotBytes > UINT32_MAX || !m_segment.create(m_name.toStdString(), slotOffset + slotBytes * m_slotCount)) {
+        static LogRateLimiter limiter(60000);
+        if (limiter.allow()) {
+            qCWarning(lcPipeline) << "Erreur : Impossible de créer le segment de mémoire partagée" << m_name;
+        }
+        return false;
+    }
+    uint8_t *base = static_cast<uint8_t *>(m_segment.data());
+    SharedFrames::Header *header = new (base) SharedFrames::Header;
+    header->magic = SharedFrames::magic;
+    header->version = SharedFrames::version;
+    header->slotCount = static_cast<uint32_t>(m_slotCount);
+    header->slotBytes = static_cast<uint32_t>(slotBytes);
+    header->slotOffset = slotOffset;
+    header->wakeCounter.store(0, std::memory_order_relaxed);
+    header->sequence.store(0, std::memory_order_relaxed);
+    header->writerPid = static_cast<uint64_t>(QCoreApplication::applicationPid());
+    for (int i = 0; i < m_slotCount; ++i) {
+        SharedFrames::SlotHeader *slot = new (base + slotOffset + i * slotBytes) SharedFrames::SlotHeader;
+        slot->sequence.store(0, std::memory_order_relaxed);
+    }
+    header->state.store(SharedFrames::Live, std::memory_order_release); // Les lecteurs peuvent s'attacher.
+    m_header = header;
+    m_frameBytes = frameBytes;
+    qCDebug(lcPipeline) << "Export en mémoire partagée :" << QString::fromStdString(SharedFrames::Segment::systemName(m_name.toStdString()))
+                        << m_slotCount << "cases de" << frameBytes << "octets";
+    return true;
+}
+// Copie la frame dans la case suivante (verrou de séquence), publie sa séquence et réveille les lecteurs
+bool FrameExporter::publish(const cv::Mat &frame, int64_t timestampNs) {
+    if (frame.empty() || m_name.isEmpty()) {
+        return false;
+    }
+    const size_t rowBytes = frame.cols * frame.elemSize();
+    const size_t bytes = rowBytes * frame.rows;
+    if ((!m_header || bytes > m_frameBytes) && !create(bytes)) {
+        return false;
+    }
+    const uint64_t sequence = ++m_sequence;
+    uint8_t *slotBase = reinterpret_cast<uint8_t *>(m_header) + m_header->slotOffset + ((sequence - 1) % m_header->slotCount) * m_header->slotBytes;
+    SharedFrames::SlotHeader *slot = reinterpret_cast<SharedFrames::SlotHeader *>(slotBase);
+    slot->sequence.store(0, std::memory_order_relaxed); // Case en cours d'écriture : un lecteur qui la lit la verra invalide.
+    std::atomic_thread_fence(std::memory_order_release);
+    uint8_t *pixels = slotBase + SharedFrames::slotHeaderBytes;
+    if (frame.isContinuous()) {
+        std::memcpy(pixels, frame.data, bytes);
+    } else {
+        for (int y = 0; y < frame.rows; ++y) {
+            std::memcpy(pixels + y * rowBytes, frame.ptr(y), rowBytes);
+        }
+    }
+    slot->timestampNs = timestampNs;
+    slot->width = frame.cols;
+    slot->height = frame.rows;
+    slot->type = frame.type();
+    slot->step = static_cast<int32_t>(rowBytes);
+    slot->bytes = static_cast<uint32_t>(bytes);
+    slot->sequence.store(sequence, std::memory_order_release); // Case complète.
+    m_header->sequence.store(sequence, std::memory_order_release);
+    m_header->wakeCounter.fetch_add(1, std::memory_order_release);
+    SharedFrames::wakeAll(&m_header->wakeCounter);
+    return true;
+}
+// Marque le segment abandonné (les lecteurs se rattacheront au suivant) puis le supprime
+void FrameExporter::close() {
+    if (!m_header) {
+        return;
+    }
+    m_header->state.store(SharedFrames::Closed, std::memory_order_release);
+    m_header->wakeCounter.fetch_add(1, std::memory_order_release);
+    SharedFrames::wakeAll(&m_header->wakeCounter);
+    m_header = nullptr;
+    m_segment.release();
+    m_frameBytes = 0;
+}
@@ -0,0 +1,34 @@
+#ifndef FRAMEEXPORTER_H
+#define FRAMEEXPORTER_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat pour les frames exportées.
+#include "sharedframes.h" // Disposition de l'anneau partagé.
+#include <QString> // Nom du segment.
+#include <cstdint> // Compteurs et horodatages.
+// Écrivain de l'anneau de frames en mémoire partagée (voir sharedframes.h) : chaque frame publiée est copiée une fois
+// dans la case suivante, puis les lecteurs des autres processus la lisent sur place. Le segment est créé à la première
+// frame, à sa taille ; une frame plus grande (changement de résolution) le recrée et les lecteurs s'y rattachent.
+// Non protégé : utilisé par un seul thread à la fois (le traitement des frames, sous son verrou).
+class FrameExporter {
+public:
+    FrameExporter() = default;
+    ~FrameExporter(); // Abandonne le segment (les lecteurs le voient fermé).
+    FrameExporter(const FrameExporter &) = delete;
+    FrameExporter &operator=(const FrameExporter &) = delete;
+    void setName(const QString &name); // Nom du segment ("mauellopencv-cam0") ; ferme le segment courant s'il change.
+    QString name() const;
+    void setSlotCount(int slots); // Cases de l'anneau (au moins 2, 4 par défaut) ; appliqué à la prochaine création.
+    bool publish(const cv::Mat &frame, int64_t timestampNs); // Copie la frame dans la case suivante et réveille les lecteurs.
+    void close(); // Abandonne et supprime le segment.
+    bool isOpen() const;
+    uint64_t publishedFrames() const; // Frames publiées depuis la création de l'écrivain.
+private:
+    bool create(size_t frameBytes); // (Re)crée le segment pour des frames de frameBytes octets au plus.
+    SharedFrames::Segment m_segment; // Segment partagé.
+    SharedFrames::Header *m_header = nullptr; // En-tête du segment (nul s'il n'est pas créé).
+    QString m_name; // Nom du segment.
+    int m_slotCount = 4; // Cases de l'anneau.
+    size_t m_frameBytes = 0; // Octets de pixels par case.
+    uint64_t m_sequence = 0; // Dernière séquence publiée.
+};
+#endif // FRAMEEXPORTER_H
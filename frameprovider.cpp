@@ -0,0 +1,31 @@
+#include "frameprovider.h" // Déclaration de la classe FrameProvider.
+#include <QMutexLocker> // Verrouillage automatique du mutex.
+QMutex FrameProvider::s_mutex; // Mutex partagé par toutes les sources.
+QHash<QString, QImage> FrameProvider::s_frames; // Table des dernières frames.
+// Constructeur : le fournisseur renvoie des QImage
+FrameProvider::FrameProvider() : QQuickImageProvider(QQuickImageProvider::Image) {
+}
+// Renvoie la dernière frame de la source demandée
+QImage FrameProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize) {
+    Q_UNUSED(requestedSize); // L'image est servie à sa taille native, QML se charge de la mise à l'échelle.
+    const QString sourceId = id.section('/', 0, 0); // Extrait l'identifiant de la source (avant le premier '/').
+    QImage image;
+    {
+        QMutexLocker locker(&s_mutex);
+        image = s_frames.value(sourceId); // Copie superficielle : les pixels sont partagés.
+    }
+    if (size) {
+        *size = image.size(); // Indique la taille réelle de l'image à QML.
+    }
+    return image;
+}
+// Publie la dernière frame d'une source
+void FrameProvider::publish(const QString &sourceId, const QImage &image) {
+    QMutexLocker locker(&s_mutex);
+    s_frames.insert(sourceId, image); // Remplace l'ancienne frame (libérée quand plus aucune vue ne l'utilise).
+}
+// Retire une source de la table
+void FrameProvider::remove(const QString &sourceId) {
+    QMutexLocker locker(&s_mutex);
+    s_frames.remove(sourceId);
+}
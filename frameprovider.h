@@ -0,0 +1,22 @@
+#ifndef FRAMEPROVIDER_H
+#define FRAMEPROVIDER_H
+// Inclusion des bibliothèques nécessaires
+#include <QQuickImageProvider> // Fournisseur d'images pour les URL "image://" de QML.
+#include <QImage> // Représente des images en Qt.
+#include <QHash> // Table associative identifiant -> image.
+#include <QMutex> // Protection des accès concurrents à la table des images.
+#include <QString> // Gestion des chaînes de caractères dans Qt.
+// Fournisseur d'images servant la dernière frame de chaque source vidéo à QML, sans encodage.
+// Les URL ont la forme "image://camera/<sourceId>/<frameId>" ; seul <sourceId> sert à la recherche,
+// <frameId> change à chaque frame pour forcer QML à redemander l'image.
+class FrameProvider : public QQuickImageProvider {
+public:
+    FrameProvider(); // Constructeur (type Image : les frames sont servies sous forme de QImage).
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override; // Appelé par QML pour obtenir une image.
+    static void publish(const QString &sourceId, const QImage &image); // Publie la dernière frame d'une source (partage implicite, pas de copie).
+    static void remove(const QString &sourceId); // Retire une source (appelé à la destruction de la capture).
+private:
+    static QMutex s_mutex; // Protège s_frames (publication et lecture depuis des threads différents).
+    static QHash<QString, QImage> s_frames; // Dernière frame publiée pour chaque source.
+};
+#endif // FRAMEPROVIDER_H
@@ -0,0 +1,110 @@
+#include "framering.h" // Déclaration de la classe FrameRing.
+#include <algorithm> // std::max.
+// Constructeur : alloue les cases (les tampons d'image sont alloués à la première frame)
+FrameRing::FrameRing(int capacity)
+    : m_slots(new Slot[std::max(capacity, 2)]), m_capacity(std::max(capacity, 2)) {
+}
+// Réserve une case libre pour la prochaine frame
+cv::Mat *FrameRing::beginWrite() {
+    const int latest = m_latest.load(std::memory_order_acquire);
+    const int start = (m_writeIndex >= 0 ? m_writeIndex : latest) + 1; // Parcours circulaire après la dernière case écrite.
+    for (int i = 0; i < m_capacity; ++i) {
+        const int index = (start + i) % m_capacity;
+        if (index == latest) {
+            continue; // Ne jamais réécrire la dernière frame publiée : les lecteurs doivent toujours en trouver une.
+        }
+        Slot &slot = m_slots[index];
+        int expected = 0;
+        if (slot.state.compare_exchange_strong(expected, -1, std::memory_order_acquire)) { // Libre -> réservée.
+            if (slot.sequence != 0 && !slot.consumed.load(std::memory_order_relaxed)) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed); // La frame écrasée n'a été lue par personne.
+            }
+            slot.sequence = 0; // Contenu invalide pendant l'écriture.
+            slot.consumed.store(false, std::memory_order_relaxed);
+            m_writeIndex = index;
+            m_reserved = true;
+            return &slot.image;
+        }
+    }
+    m_overruns.fetch_add(1, std::memory_order_relaxed); // Toutes les cases sont épinglées par des lecteurs.
+    return nullptr;
+}
+// Publie la case réservée
+void FrameRing::commitWrite(int64_t timestampNs) {
+    if (!m_reserved) {
+        return;
+    }
+    m_reserved = false;
+    Slot &slot = m_slots[m_writeIndex];
+    slot.timestampNs = timestampNs;
+    slot.sequence = m_nextSequence++;
+    slot.state.store(0, std::memory_order_release); // Rend la case lisible (publie aussi image et horodatage).
+    m_latest.store(m_writeIndex, std::memory_order_release); // Devient la dernière frame.
+    m_published.fetch_add(1, std::memory_order_relaxed);
+}
+// Annule la réservation en cours
+void FrameRing::abortWrite() {
+    if (!m_reserved) {
+        return;
+    }
+    m_reserved = false;
+    m_slots[m_writeIndex].state.store(0, std::memory_order_release); // La case reste vide (sequence = 0).
+}
+// Épingle la dernière frame publiée
+FrameRing::FrameRef FrameRing::latest() const {
+    for (;;) {
+        const int index = m_latest.load(std::memory_order_acquire);
+        if (index < 0) {
+            return FrameRef(); // Aucune frame encore publiée.
+        }
+        Slot &slot = m_slots[index];
+        int state = slot.state.load(std::memory_order_relaxed);
+        while (state >= 0 && !slot.state.compare_exchange_weak(state, state + 1, std::memory_order_acquire)) {
+        }
+        if (state < 0) {
+            continue; // Le producteur a repris la case entre-temps : relire la dernière frame.
+        }
+        if (slot.sequence == 0) { // Case vidée par une écriture annulée.
+            slot.state.fetch_sub(1, std::memory_order_release);
+            continue;
+        }
+        slot.consumed.store(true, std::memory_order_relaxed);
+        return FrameRef(&slot);
+    }
+}
+// Vrai si la dernière frame a déjà été lue par un consommateur
+bool FrameRing::isLatestConsumed() const {
+    const int index = m_latest.load(std::memory_order_acquire);
+    return index < 0 || m_slots[index].consumed.load(std::memory_order_relaxed);
+}
+// Vide l'anneau (aucun producteur actif)
+void FrameRing::reset() {
+    m_latest.store(-1, std::memory_order_release);
+    m_writeIndex = -1;
+    m_reserved = false;
+    for (int i = 0; i < m_capacity; ++i) {
+        m_slots[i].sequence = 0; // Les tampons sont conservés pour être réutilisés.
+    }
+}
+// Déplacement d'une référence
+FrameRing::FrameRef::FrameRef(FrameRef &&other) noexcept : m_slot(other.m_slot) {
+    other.m_slot = nullptr;
+}
+FrameRing::FrameRef &FrameRing::FrameRef::operator=(FrameRef &&other) noexcept {
+    if (this != &other) {
+        release();
+        m_slot = other.m_slot;
+        other.m_slot = nullptr;
+    }
+    return *this;
+}
+FrameRing::FrameRef::~FrameRef() {
+    release();
+}
+// Libère l'épinglage de la case
+void FrameRing::FrameRef::release() {
+    if (m_slot) {
+        m_slot->state.fetch_sub(1, std::memory_order_release);
+        m_slot = nullptr;
+    }
+}
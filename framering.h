@@ -0,0 +1,65 @@
+#ifndef FRAMERING_H
+#define FRAMERING_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat pour stocker les frames.
+#include <atomic> // Compteurs et états sans verrou.
+#include <cstdint> // Types entiers de taille fixe.
+#include <memory> // std::unique_ptr pour le tableau de cases.
+// Anneau borné "dernière frame" : un seul producteur (le thread de capture), plusieurs consommateurs
+// (affichage, enregistrement, instantanés). Aucun verrou : chaque case porte un état atomique
+// (-1 = en écriture, 0 = libre, n > 0 = n lecteurs). Le producteur ne bloque jamais : il saute les
+// cases occupées et compte un dépassement si toutes le sont. Les lecteurs prennent toujours la
+// dernière frame publiée, sans jamais attendre le producteur.
+class FrameRing {
+    struct Slot {
+        cv::Mat image; // Pixels de la frame (tampon réutilisé d'une frame à l'autre).
+        int64_t timestampNs = 0; // Horodatage de capture (horloge monotone, en nanosecondes).
+        uint64_t sequence = 0; // Numéro de séquence (0 = case vide ou en cours de réécriture).
+        std::atomic<int> state{0}; // -1 = réservée par le producteur, 0 = libre, n > 0 = n lecteurs.
+        std::atomic<bool> consumed{false}; // Vrai si au moins un consommateur a lu la frame.
+    };
+public:
+    // Référence vers une frame publiée ; la case reste épinglée tant que la référence existe.
+    class FrameRef {
+    public:
+        FrameRef() = default;
+        FrameRef(FrameRef &&other) noexcept; // Déplacement : transfère l'épinglage.
+        FrameRef &operator=(FrameRef &&other) noexcept;
+        FrameRef(const FrameRef &) = delete; // Non copiable (un épinglage = une référence).
+        FrameRef &operator=(const FrameRef &) = delete;
+        ~FrameRef(); // Libère l'épinglage.
+        bool isValid() const { return m_slot != nullptr; } // Vrai si la référence pointe sur une frame.
+        const cv::Mat &image() const { return m_slot->image; } // Pixels (lecture seule : partagés avec les autres lecteurs).
+        int64_t timestampNs() const { return m_slot->timestampNs; } // Horodatage de capture.
+        uint64_t sequence() const { return m_slot ? m_slot->sequence : 0; } // Numéro de séquence (0 si invalide).
+        void release(); // Libère l'épinglage avant la destruction.
+    private:
+        friend class FrameRing;
+        explicit FrameRef(Slot *slot) : m_slot(slot) {}
+        Slot *m_slot = nullptr; // Case épinglée.
+    };
+    explicit FrameRing(int capacity = 4); // Capacité = nombre de cases (au moins 2).
+    // Côté producteur (un seul thread)
+    cv::Mat *beginWrite(); // Réserve une case libre et renvoie son tampon, ou nullptr si toutes sont occupées.
+    void commitWrite(int64_t timestampNs); // Publie la case réservée comme dernière frame.
+    void abortWrite(); // Annule la réservation (lecture caméra échouée).
+    // Côté consommateurs (n'importe quel thread)
+    FrameRef latest() const; // Épingle et renvoie la dernière frame publiée (invalide si aucune).
+    bool isLatestConsumed() const; // Vrai si la dernière frame publiée a été lue (ou si aucune n'a été publiée).
+    // Statistiques
+    uint64_t publishedFrames() const { return m_published.load(std::memory_order_relaxed); } // Frames publiées.
+    uint64_t droppedFrames() const { return m_dropped.load(std::memory_order_relaxed); } // Frames écrasées sans avoir été lues.
+    uint64_t overrunFrames() const { return m_overruns.load(std::memory_order_relaxed); } // Frames perdues faute de case libre.
+    void reset(); // Vide l'anneau (à appeler quand le producteur est arrêté).
+private:
+    std::unique_ptr<Slot[]> m_slots; // Cases de l'anneau.
+    int m_capacity; // Nombre de cases.
+    int m_writeIndex = -1; // Dernière case réservée par le producteur (-1 = aucune).
+    bool m_reserved = false; // Vrai entre beginWrite() et commitWrite()/abortWrite().
+    uint64_t m_nextSequence = 1; // Prochain numéro de séquence (producteur uniquement).
+    std::atomic<int> m_latest{-1}; // Index de la dernière case publiée (-1 = aucune).
+    std::atomic<uint64_t> m_published{0}; // Compteur de frames publiées.
+    std::atomic<uint64_t> m_dropped{0}; // Compteur de frames jamais lues.
+    std::atomic<uint64_t> m_overruns{0}; // Compteur de dépassements.
+};
+#endif // FRAMERING_H
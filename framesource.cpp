@@ -0,0 +1,314 @@
+#include "framesource.h" // Déclaration des sources de frames.
+#include "metrics.h" // Logs limités du pipeline.
+#include <QDebug> // Messages de debug.
+#include <QDir> // Parcours du dossier d'images.
+#include <opencv2/imgcodecs.hpp> // cv::imread pour les séquences d'images.
+#include <opencv2/imgproc.hpp> // Dessin de la mire synthétique.
+#include <algorithm> // std::max.
+#include <string> // std::to_string.
+#include <thread> // std::this_thread::sleep_until.
+// ---------------------------------------------------------------------------
+// FrameSource : cadencement et fabrique
+FrameSource::~FrameSource() = default;
+// Par défaut, une source ne dicte pas son rythme : c'est le cadencement qui s'en charge
+bool FrameSource::isLive() const {
+    return false;
+}
+// Par défaut, sauter une frame revient à la lire dans un tampon jetable
+void FrameSource::skip() {
+    cv::Mat discarded;
+    read(discarded);
+}
+// Par défaut, changer de résolution ou de FPS demande de recréer la source
+bool FrameSource::isConfigurable() const {
+    return false;
+}
+bool FrameSource::configure(int width, int height, int fps) {
+    Q_UNUSED(width);
+    Q_UNUSED(height);
+    Q_UNUSED(fps);
+    return false;
+}
+// Par défaut, une source ne sait pas revenir au début
+bool FrameSource::rewind() {
+    return false;
+}
+// Lit la frame suivante ; en temps réel, attend l'échéance de la frame
+bool FrameSource::grab(cv::Mat &frame) {
+    if (m_pacing == Pacing::RealTime && !isLive()) { // Une caméra se cadence elle-même.
+        const double fps = nominalFps() > 0.0 ? nominalFps() : 30.0;
+        const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps));
+        const auto now = std::chrono::steady_clock::now();
+        if (m_nextDeadline + period < now) {
+            m_nextDeadline = now; // Trop de retard (ou première frame) : on repart de maintenant au lieu de rattraper en rafale.
+        } else {
+            std::this_thread::sleep_until(m_nextDeadline);
+        }
+        m_nextDeadline += period;
+    }
+    const auto start = std::chrono::steady_clock::now(); // Durée de lecture, sans l'attente du cadencement.
+    bool ok = read(frame);
+    if (!ok && m_loop && rewind()) { // Fin de flux : reboucle si demandé.
+        ok = read(frame);
+    }
+    m_lastReadNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return ok;
+}
+// Durée de la dernière lecture
+int64_t FrameSource::lastReadNs() const {
+    return m_lastReadNs;
+}
+void FrameSource::setPacing(Pacing pacing) {
+    m_pacing = pacing;
+}
+FrameSource::Pacing FrameSource::pacing() const {
+    return m_pacing;
+}
+void FrameSource::setLoop(bool loop) {
+    m_loop = loop;
+}
+bool FrameSource::loop() const {
+    return m_loop;
+}
+// Crée une source à partir de sa description textuelle
+std::unique_ptr<FrameSource> FrameSource::create(const QString &spec, int width, int height, int fps) {
+    const QString kind = spec.section(':', 0, 0).trimmed().toLower(); // Type de source (avant le premier ':').
+    const QString argument = spec.section(':', 1); // Reste de la description (chemin ou index).
+    bool isIndex = false;
+    const int index = spec.toInt(&isIndex);
+    if (isIndex) {
+        return std::unique_ptr<FrameSource>(new CameraSource(index, width, height, fps)); // "0" : caméra 0.
+    }
+    if (kind == "camera") {
+        return std::unique_ptr<FrameSource>(new CameraSource(argument.toInt(), width, height, fps));
+    }
+    if (kind == "file") {
+        return std::unique_ptr<FrameSource>(new VideoFileSource(argument));
+    }
+    if (kind == "images") {
+        return std::unique_ptr<FrameSource>(new ImageSequenceSource(argument, fps));
+    }
+    if (kind == "synthetic") {
+        return std::unique_ptr<FrameSource>(new SyntheticSource(width, height, fps, argument.toInt())); // "synthetic:300" : 300 frames.
+    }
+    qWarning() << "Erreur : Source de frames inconnue :" << spec;
+    return nullptr;
+}
+// ---------------------------------------------------------------------------
+// CameraSource
+CameraSource::CameraSource(int deviceIndex, int width, int height, int fps)
+    : m_deviceIndex(deviceIndex), m_width(width), m_height(height), m_fps(fps) {
+}
+bool CameraSource::open() {
+    if (!m_cap.open(m_deviceIndex)) {
+        qWarning("Erreur : Impossible d'accéder à la caméra !");
+        return false;
+    }
+    // Configuration de la caméra
+    m_cap.set(cv::CAP_PROP_BUFFERSIZE, 1); // Définit la taille du buffer
+    applySettings();
+    return true;
+}
+// Transmet résolution et FPS au pilote, qui retient le mode le plus proche qu'il sait fournir
+void CameraSource::applySettings() {
+    m_cap.set(cv::CAP_PROP_FRAME_WIDTH, m_width); // Largeur des images
+    m_cap.set(cv::CAP_PROP_FRAME_HEIGHT, m_height); // Hauteur des images
+    m_cap.set(cv::CAP_PROP_FPS, m_fps); // Définit le nombre d'images par seconde
+    // Affiche les propriétés actuelles de la caméra
+    qDebug() << "Propriétés caméra : "
+             << m_cap.get(cv::CAP_PROP_FRAME_WIDTH) << "x"
+             << m_cap.get(cv::CAP_PROP_FRAME_HEIGHT) << "@"
+             << m_cap.get(cv::CAP_PROP_FPS) << "FPS";
+}
+bool CameraSource::isConfigurable() const {
+    return true;
+}
+// Nouveaux réglages sur le périphérique déjà ouvert : pas de nouvelle négociation complète
+bool CameraSource::configure(int width, int height, int fps) {
+    m_width = width;
+    m_height = height;
+    m_fps = fps;
+    if (!m_cap.isOpened()) {
+        return false;
+    }
+    applySettings();
+    return true;
+}
+void CameraSource::close() {
+    if (m_cap.isOpened()) {
+        m_cap.release(); // Libère les ressources liées à la caméra
+    }
+}
+bool CameraSource::isOpened() const {
+    return m_cap.isOpened();
+}
+bool CameraSource::isLive() const {
+    return true; // La caméra livre les frames à son propre rythme.
+}
+double CameraSource::nominalFps() const {
+    const double fps = m_cap.get(cv::CAP_PROP_FPS);
+    return fps > 0.0 ? fps : m_fps;
+}
+QString CameraSource::description() const {
+    return QStringLiteral("camera:%1").arg(m_deviceIndex);
+}
+void CameraSource::skip() {
+    m_cap.grab(); // Vide le tampon du pilote sans décoder la frame.
+}
+bool CameraSource::read(cv::Mat &frame) {
+    return m_cap.read(frame) && !frame.empty();
+}
+// ---------------------------------------------------------------------------
+// VideoFileSource
+VideoFileSource::VideoFileSource(const QString &path) : m_path(path) {
+}
+bool VideoFileSource::open() {
+    if (!m_cap.open(m_path.toStdString())) {
+        qWarning() << "Erreur : Impossible d'ouvrir le fichier vidéo :" << m_path;
+        return false;
+    }
+    m_fps = m_cap.get(cv::CAP_PROP_FPS);
+    qDebug() << "Fichier vidéo ouvert :" << m_path << "@" << m_fps << "FPS";
+    return true;
+}
+void VideoFileSource::close() {
+    if (m_cap.isOpened()) {
+        m_cap.release();
+    }
+}
+bool VideoFileSource::isOpened() const {
+    return m_cap.isOpened();
+}
+double VideoFileSource::nominalFps() const {
+    return m_fps > 0.0 ? m_fps : 30.0; // Certains conteneurs n'indiquent pas de FPS.
+}
+QString VideoFileSource::description() const {
+    return QStringLiteral("file:%1").arg(m_path);
+}
+bool VideoFileSource::read(cv::Mat &frame) {
+    return m_cap.read(frame) && !frame.empty();
+}
+bool VideoFileSource::rewind() {
+    return m_cap.set(cv::CAP_PROP_POS_FRAMES, 0);
+}
+// ---------------------------------------------------------------------------
+// ImageSequenceSource
+ImageSequenceSource::ImageSequenceSource(const QString &directory, int fps) : m_directory(directory), m_fps(fps) {
+}
+bool ImageSequenceSource::open() {
+    const QDir dir(m_directory);
+    const QStringList filters = {"*.png", "*.jpg", "*.jpeg", "*.bmp", "*.tif", "*.tiff"}; // Formats lus par cv::imread.
+    m_files = dir.entryList(filters, QDir::Files, QDir::Name); // Ordre alphabétique = ordre de lecture.
+    for (QString &file : m_files) {
+        file = dir.absoluteFilePath(file);
+    }
+    m_index = 0;
+    if (m_files.isEmpty()) {
+        qWarning() << "Erreur : Aucune image trouvée dans :" << m_directory;
+        return false;
+    }
+    qDebug() << "Séquence d'images ouverte :" << m_directory << "(" << m_files.size() << "images )";
+    return true;
+}
+void ImageSequenceSource::close() {
+    m_files.clear();
+    m_index = 0;
+}
+bool ImageSequenceSource::isOpened() const {
+    return !m_files.isEmpty();
+}
+double ImageSequenceSource::nominalFps() const {
+    return m_fps > 0 ? m_fps : 30.0;
+}
+QString ImageSequenceSource::description() const {
+    return QStringLiteral("images:%1").arg(m_directory);
+}
+bool ImageSequenceSource::read(cv::Mat &frame) {
+    while (m_index < m_files.size()) {
+        frame = cv::imread(m_files.at(m_index++).toStdString(), cv::IMREAD_COLOR); // Toujours en BGR 3 canaux.
+        if (!frame.empty()) {
+            return true;
+        }
+        static LogRateLimiter limiter; // Un dossier entier de fichiers illisibles ne doit pas inonder les logs.
+        uint64_t skipped = 0;
+        if (limiter.allow(&skipped)) {
+            qCWarning(lcPipeline) << "Image illisible ignorée :" << m_files.at(m_index - 1) << "(" << skipped << "autres depuis le dernier message )";
+        }
+    }
+    return false;
+}
+bool ImageSequenceSource::rewind() {
+    m_index = 0;
+    return !m_files.isEmpty();
+}
+// ---------------------------------------------------------------------------
+// SyntheticSource
+SyntheticSource::SyntheticSource(int width, int height, int fps, int frameCount)
+    : m_width(width), m_height(height), m_fps(fps), m_frameCount(frameCount) {
+}
+bool SyntheticSource::open() {
+    drawBackground();
+    m_index = 0;
+    return true;
+}
+void SyntheticSource::drawBackground() {
+    // Barres de couleur (BGR) sur les trois quarts supérieurs, dégradé de gris en dessous
+    static const cv::Scalar bars[] = {
+        cv::Scalar(255, 255, 255), cv::Scalar(0, 255, 255), cv::Scalar(255, 255, 0), cv::Scalar(0, 255, 0),
+        cv::Scalar(255, 0, 255), cv::Scalar(0, 0, 255), cv::Scalar(255, 0, 0), cv::Scalar(0, 0, 0)};
+    const int barCount = static_cast<int>(sizeof(bars) / sizeof(bars[0]));
+    m_background.create(m_height, m_width, CV_8UC3);
+    const int barsHeight = m_height * 3 / 4;
+    for (int i = 0; i < barCount; ++i) {
+        const int x0 = m_width * i / barCount;
+        const int x1 = m_width * (i + 1) / barCount;
+        m_background(cv::Rect(x0, 0, x1 - x0, barsHeight)).setTo(bars[i]);
+    }
+    for (int x = 0; x < m_width; ++x) {
+        const int level = x * 255 / std::max(1, m_width - 1);
+        m_background(cv::Rect(x, barsHeight, 1, m_height - barsHeight)).setTo(cv::Scalar(level, level, level));
+    }
+}
+void SyntheticSource::close() {
+    m_background.release();
+}
+bool SyntheticSource::isOpened() const {
+    return !m_background.empty();
+}
+double SyntheticSource::nominalFps() const {
+    return m_fps > 0 ? m_fps : 30.0;
+}
+QString SyntheticSource::description() const {
+    return QStringLiteral("synthetic:%1x%2@%3").arg(m_width).arg(m_height).arg(m_fps);
+}
+bool SyntheticSource::isConfigurable() const {
+    return true;
+}
+// Nouvelle taille et cadence sans revenir à la première frame
+bool SyntheticSource::configure(int width, int height, int fps) {
+    m_fps = fps;
+    if (width != m_width || height != m_height) {
+        m_width = width;
+        m_height = height;
+        drawBackground();
+    }
+    return true;
+}
+bool SyntheticSource::read(cv::Mat &frame) {
+    if (m_frameCount > 0 && m_index >= m_frameCount) {
+        return false; // Fin du flux.
+    }
+    m_background.copyTo(frame); // Réutilise le tampon de destination s'il a déjà la bonne taille.
+    // Bloc blanc qui se déplace : chaque frame diffère de la précédente de façon reproductible
+    const int size = std::max(16, m_height / 6);
+    const int x = (m_index * 7) % std::max(1, m_width - size);
+    const int y = (m_index * 3) % std::max(1, m_height - size);
+    cv::rectangle(frame, cv::Rect(x, y, size, size), cv::Scalar(255, 255, 255), cv::FILLED);
+    cv::putText(frame, std::to_string(m_index), cv::Point(10, m_height - 10), cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 0, 255), 2);
+    ++m_index;
+    return true;
+}
+bool SyntheticSource::rewind() {
+    m_index = 0;
+    return true;
+}
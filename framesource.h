@@ -0,0 +1,126 @@
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat pour les frames.
+#include <opencv2/videoio.hpp> // cv::VideoCapture pour la caméra et les fichiers vidéo.
+#include <QString> // Gestion des chaînes de caractères dans Qt.
+#include <QStringList> // Liste des fichiers d'une séquence d'images.
+#include <chrono> // Cadencement temps réel.
+#include <cstdint> // Durée de lecture.
+#include <memory> // std::unique_ptr pour la fabrique.
+// Source de frames abstraite : caméra, fichier vidéo, dossier d'images ou mire synthétique.
+// Chaque source peut être cadencée en temps réel (à son FPS nominal) ou lue aussi vite que possible,
+// ce qui permet de rejouer le même traitement sans caméra et d'en mesurer le débit maximal.
+class FrameSource {
+public:
+    enum class Pacing { RealTime, Unthrottled }; // Cadencement : temps réel ou sans limite.
+    virtual ~FrameSource();
+    virtual bool open() = 0; // Ouvre la source.
+    virtual void close() = 0; // Ferme la source.
+    virtual bool isOpened() const = 0; // Vrai si la source est ouverte.
+    virtual bool isLive() const; // Vrai si la source impose son propre rythme (caméra).
+    virtual double nominalFps() const = 0; // FPS nominal de la source.
+    virtual QString description() const = 0; // Description lisible pour les logs.
+    virtual void skip(); // Saute une frame (utilisé quand aucun tampon n'est libre).
+    virtual bool isConfigurable() const; // Vrai si configure() s'applique sans rouvrir la source.
+    virtual bool configure(int width, int height, int fps); // Change résolution et FPS de la source ouverte ; faux si non pris en charge.
+    bool grab(cv::Mat &frame); // Lit la frame suivante en respectant le cadencement ; faux en fin de flux.
+    void setPacing(Pacing pacing); // Choisit le cadencement.
+    Pacing pacing() const; // Cadencement courant.
+    void setLoop(bool loop); // Reboucle au début en fin de flux (fichiers, séquences, mire).
+    bool loop() const;
+    int64_t lastReadNs() const; // Durée de la dernière lecture (décodage compris, attente du cadencement exclue).
+    // Fabrique à partir d'une description textuelle :
+    // "camera:0" (ou "0"), "file:/chemin/video.avi", "images:/chemin/dossier", "synthetic".
+    static std::unique_ptr<FrameSource> create(const QString &spec, int width, int height, int fps);
+protected:
+    virtual bool read(cv::Mat &frame) = 0; // Lit la frame suivante sans cadencement.
+    virtual bool rewind(); // Revient au début du flux (pour le rebouclage).
+private:
+    Pacing m_pacing = Pacing::RealTime; // Cadencement courant.
+    bool m_loop = false; // Rebouclage en fin de flux.
+    int64_t m_lastReadNs = 0; // Durée de la dernière lecture.
+    std::chrono::steady_clock::time_point m_nextDeadline; // Échéance de la prochaine frame en temps réel.
+};
+// Caméra physique (rythme imposé par le périphérique)
+class CameraSource : public FrameSource {
+public:
+    CameraSource(int deviceIndex, int width, int height, int fps);
+    bool open() override;
+    void close() override;
+    bool isOpened() const override;
+    bool isLive() const override;
+    double nominalFps() const override;
+    QString description() const override;
+    void skip() override;
+    bool isConfigurable() const override;
+    bool configure(int width, int height, int fps) override;
+protected:
+    bool read(cv::Mat &frame) override;
+private:
+    void applySettings(); // Transmet résolution et FPS demandés au pilote.
+    cv::VideoCapture m_cap; // Caméra OpenCV.
+    int m_deviceIndex; // Index du périphérique.
+    int m_width; // Résolution et FPS demandés.
+    int m_height;
+    int m_fps;
+};
+// Fichier vidéo
+class VideoFileSource : public FrameSource {
+public:
+    explicit VideoFileSource(const QString &path);
+    bool open() override;
+    void close() override;
+    bool isOpened() const override;
+    double nominalFps() const override;
+    QString description() const override;
+protected:
+    bool read(cv::Mat &frame) override;
+    bool rewind() override;
+private:
+    cv::VideoCapture m_cap; // Lecteur de fichier OpenCV.
+    QString m_path; // Chemin du fichier.
+    double m_fps = 0.0; // FPS lu dans le conteneur.
+};
+// Dossier d'images lues dans l'ordre alphabétique
+class ImageSequenceSource : public FrameSource {
+public:
+    ImageSequenceSource(const QString &directory, int fps);
+    bool open() override;
+    void close() override;
+    bool isOpened() const override;
+    double nominalFps() const override;
+    QString description() const override;
+protected:
+    bool read(cv::Mat &frame) override;
+    bool rewind() override;
+private:
+    QString m_directory; // Dossier source.
+    QStringList m_files; // Fichiers image triés.
+    int m_index = 0; // Prochaine image à lire.
+    int m_fps; // Cadence de relecture.
+};
+// Mire synthétique déterministe (barres de couleur, bloc mobile et numéro de frame)
+class SyntheticSource : public FrameSource {
+public:
+    SyntheticSource(int width, int height, int fps, int frameCount = 0); // frameCount = 0 : flux infini.
+    bool open() override;
+    void close() override;
+    bool isOpened() const override;
+    double nominalFps() const override;
+    QString description() const override;
+    bool isConfigurable() const override;
+    bool configure(int width, int height, int fps) override;
+protected:
+    bool read(cv::Mat &frame) override;
+    bool rewind() override;
+private:
+    void drawBackground(); // Barres de couleur à la taille courante.
+    cv::Mat m_background; // Barres de couleur précalculées.
+    int m_width; // Taille et cadence de la mire.
+    int m_height;
+    int m_fps;
+    int m_frameCount; // Nombre de frames avant la fin du flux (0 = infini).
+    int m_index = 0; // Numéro de la prochaine frame.
+};
+#endif // FRAMESOURCE_H
@@ -1,7 +1,13 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include "videocapture.h" // Inclut la classe VideoCapture définie par l'utilisateur.
+#include "cameramanager.h" // Caméras multiples traitées sur le pool partagé.
+#include "frameprovider.h" // Fournisseur d'images "image://camera" pour l'affichage des frames.
+#include "mjpegserver.h" // Flux MJPEG sur HTTP pour les autres outils.
+#include "bufferpool.h" // Compteur d'allocations de cv::Mat.
 #include <QQmlContext> // Fournit un accès au contexte de QML pour exposer des objets C++.
+#include <QCommandLineParser> // Caméras à ouvrir au démarrage.
+#include <QDebug> // Adresse du flux MJPEG.
 int main(int argc, char *argv[])// Fonction principale de l'application.
 {
 // Active la prise en charge des écrans haute résolution si Qt est inférieur à la version 6.
@@ -9,12 +15,49 @@ int main(int argc, char *argv[])// Fonction principale de l'application.
     QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
 #endif
     QGuiApplication app(argc, argv);// Instancie l'application graphique Qt.
+    AllocationCounter::install(); // Compte les allocations de cv::Mat (propriété allocationsPerFrame).
     // Enregistrement du module VideoCapture
     qmlRegisterType<VideoCapture>("VideoCapture", 1, 0, "VideoCapture");
-    VideoCapture videoCapture; // Crée une instance de la classe VideoCapture.
+    // Caméras ouvertes au démarrage : --cameras N (index 0 à N-1) et/ou --source <description> (répétable)
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption camerasOption("cameras", "Ouvre les caméras 0 à N-1.", "N", "0");
+    QCommandLineOption sourceOption("source", "Ajoute une source (camera:1, file:video.avi, images:dossier, synthetic).", "spec");
+    QCommandLineOption maxFpsOption("max-fps", "Budget de FPS de chaque caméra (0 = cadence de la source).", "fps", "0");
+    QCommandLineOption streamPortOption("stream-port", "Sert les frames traitées en MJPEG sur ce port HTTP (0 = désactivé).", "port", "0");
+    QCommandLineOption streamQualityOption("stream-quality", "Qualité JPEG du flux MJPEG.", "1-100", "80");
+    QCommandLineOption shmExportOption("shm-export", "Exporte les frames traitées de chaque caméra en mémoire partagée (\"mauellopencv-cam0\"...).");
+    parser.addOptions({camerasOption, sourceOption, maxFpsOption, streamPortOption, streamQualityOption, shmExportOption});
+    parser.process(app);
+    MjpegServer streamServer; // Déclaré avant les caméras : détruit après elles.
+    const int streamPort = parser.value(streamPortOption).toInt();
+    if (streamPort > 0) {
+        streamServer.setQuality(parser.value(streamQualityOption).toInt());
+        if (streamServer.listen(static_cast<quint16>(streamPort))) {
+            qInfo().noquote() << QStringLiteral("Flux MJPEG : http://localhost:%1/cam0 (index sur /, mesures par client sur /stats)").arg(streamServer.port());
+        }
+    }
+    CameraManager cameraManager; // Toutes les caméras partagent un ordonnanceur et le pool de threads.
+    const double maxFps = parser.value(maxFpsOption).toDouble();
+    cameraManager.openCameras(parser.value(camerasOption).toInt(), 0, maxFps);
+    for (const QString &spec : parser.values(sourceOption)) {
+        cameraManager.addCamera(spec, 0, maxFps);
+    }
+    if (cameraManager.count() == 0) {
+        cameraManager.addCamera(QStringLiteral("camera:0")); // Comportement d'origine : la caméra par défaut.
+    }
+    if (parser.isSet(shmExportOption)) {
+        for (int row = 0; row < cameraManager.count(); ++row) {
+            VideoCapture *camera = cameraManager.camera(row);
+            camera->setSharedMemoryExport(true);
+            qInfo().noquote() << QStringLiteral("Export en mémoire partagée : %1").arg(camera->sharedMemoryName());
+        }
+    }
     QQmlApplicationEngine engine; // Crée le moteur pour charger les fichiers QML.
-    // Exposition de l'objet VideoCapture à QML
-    engine.rootContext()->setContextProperty("videoCapture", &videoCapture);
+    // Exposition du gestionnaire de caméras à QML
+    engine.rootContext()->setContextProperty("cameraManager", &cameraManager);
+    // Enregistre le fournisseur d'images (le moteur QML en prend possession)
+    engine.addImageProvider(QStringLiteral("camera"), new FrameProvider);
     // Définit l'URL du fichier QML principal à charger.
     const QUrl url(QStringLiteral("qrc:/main.qml"));
     QObject::connect(// Connecte un signal pour gérer les erreurs de chargement du fichier QML.
@@ -11,13 +11,17 @@ Window {
     title: qsTr("Camera PC avec OpenCV") // Titre de la fenêtre défini à "Hello World"
     Material.theme: Material.Dark // Utilisation du thème sombre pour l'interface
     Material.primary: Material.Blue // Définition de la couleur principale du thème à bleu
-//Déclaration de la caméra
-    VideoCapture {
-        id: camera // Identifiant unique pour accéder à la caméra
-        onFrameChanged: imageSource.source = frame // Lors du changement de cadre, mettre à jour l'image affichée avec la nouvelle image de la caméra
-        onRecordingChanged: { // Lors de l'activation ou de la désactivation de l'enregistrement
+//Déclaration de la caméra : entrée choisie du gestionnaire de caméras (caméra 0 par défaut)
+    property int selectedCamera: 0 // Ligne de la caméra affichée et pilotée par les contrôles
+    property VideoCapture camera: cameraManager.count > 0 ? cameraManager.camera(Math.min(selectedCamera, cameraManager.count - 1)) : null
+    Connections {
+        target: camera
+        function onRecordingChanged() { // Lors de l'activation ou de la désactivation de l'enregistrement
             recordingIndicator.color = camera.isRecording ? "green" : "red" // Change la couleur de l'indicateur d'enregistrement selon l'état
         }
+        function onSnapshotSaved(id, files, error) { // Lorsque les fichiers d'une capture d'image ou d'une rafale sont écrits
+            snapshotStatus.text = error.length > 0 ? "Erreur : " + error : files.length + " image(s) dans " + camera.snapshotDirectory
+        }
     }
 //Zone de contrôle (Disposition avec RowLayout)
     Rectangle {
@@ -99,7 +103,8 @@ Window {
                         stepSize: 1
                         width: 200 // Largeur du slider
                         onValueChanged: { // Lors du changement de valeur
-                            camera.frameRate = value; // Mettre à jour le frame rate de la caméra
+                            if (camera)
+                                camera.frameRate = value; // Mettre à jour le frame rate de la caméra
                             captureTimer.interval = 1000 / value; // Ajuste l'intervalle du minuteur
                         }
                     }
@@ -112,7 +117,7 @@ Window {
                             color: "#FFFFFF"
                         }
                         Label {
-                            text: "Real FPS: " + camera.realFrameRate.toFixed(2) // Affiche le frame rate réel de la caméra
+                            text: "Real FPS: " + (camera ? camera.realFrameRate : 0).toFixed(2) // Affiche le frame rate réel de la caméra
                             font.pixelSize: 16
                             color: "#FFFFFF"
                         }
@@ -136,11 +141,52 @@ Window {
                     anchors.centerIn: parent // Centrage de l'image dans le rectangle
                     width: parent.width - 40 // Largeur de l'image
                     height: parent.height - 40 // Hauteur de l'image
-                    source: "data:image/jpeg;base64," + camera.frame // Source de l'image en base64
+                    // Source de l'image : fournisseur "image://camera" (sans encodage), ou Base64 en mode compatibilité
+                    source: !camera ? "" // Aucune caméra ouverte (toutes les sources ont échoué)
+                                    : camera.legacyFrameMode ? "data:image/jpeg;base64," + camera.frame
+                                                             : "image://camera/" + camera.sourceId + "/" + camera.frameId
+                    cache: false // Chaque frame est unique : inutile de la garder dans le cache QML
                     fillMode: Image.PreserveAspectFit // Préserve le rapport d'aspect de l'image
                     smooth: true // Rendre l'image plus fluide
                     clip: true // Applique un clipping pour éviter que l'image ne dépasse
                 }
+                // État de la source tant qu'elle ne livre pas d'images (l'ouverture se fait en arrière-plan)
+                Text {
+                    anchors.centerIn: imageSource
+                    visible: !camera || camera.status === "opening" || camera.status === "failed"
+                    text: camera && camera.status === "opening" ? "Ouverture de la caméra…" : "Source indisponible"
+                    color: "#FFFFFF"
+                    font.pixelSize: 18
+                }
+                // Mesures du pipeline par étape (rafraîchies chaque seconde)
+                Text {
+                    anchors.left: imageSource.left
+                    anchors.top: imageSource.top
+                    anchors.margins: 8
+                    color: "#00FF66"
+                    font.pixelSize: 11
+                    font.family: "monospace"
+                    text: {
+                        if (!camera)
+                            return "";
+                        var lines = [];
+                        var stages = camera.metrics.stages || {};
+                        for (var name in stages) {
+                            var s = stages[name];
+                            if (s.count > 0) // Étapes inactives (enregistrement arrêté...) masquées
+                                lines.push(name + "  p50 " + s.p50_ms.toFixed(1) + "  p95 " + s.p95_ms.toFixed(1)
+                                           + "  p99 " + s.p99_ms.toFixed(1) + "  max " + s.max_ms.toFixed(1) + " ms");
+                        }
+                        if (camera.qualityLevel > 0) // Qualité réduite par le régulateur pour tenir la cadence
+                            lines.push("qualité  " + camera.qualityLevelName);
+                        if (camera.timeToFirstFrame >= 0) // Démarrage : ouverture de la source et première frame
+                            lines.push("première frame  " + camera.timeToFirstFrame.toFixed(0) + " ms");
+                        if (camera.changeDetection) // Économies de la détection de changement sur la dernière seconde
+                            lines.push("inchangées  " + (100 * camera.skippedFrameRatio).toFixed(0) + " %  tuiles  "
+                                       + (100 * camera.dirtyTileRatio).toFixed(0) + " %");
+                        return lines.join("\n");
+                    }
+                }
                 Rectangle {
                     anchors.centerIn: parent // Zone de filtre pour l'image
                     width: parent.width + 20
@@ -176,11 +222,41 @@ Window {
                     spacing: 10
                     ComboBox {
                         id: filterBox // Liste déroulante pour choisir le filtre
-                        model: ["Aucun", "Gris", "Inversion", "Gaussian", "Median", "CLAHE", "Sobel", "Sel & Poivre", "Histogram", "Canny Edge Detection", "Bilateral", "Laplacian", "Sharpening", "Cartoon Effect", "Motion Blur", "Emboss Effect", "Sepia Effect" ,"detectFaces"]
-                        currentIndex: 0 // Valeur par défaut sélectionnée
-                        onCurrentIndexChanged: camera.setFilterMode(currentIndex) // Applique le filtre sélectionné à la caméra
+                        model: ["Aucun", "Gris", "Inversion", "Gaussian", "Median", "CLAHE", "Sobel", "Sel & Poivre", "Histogram", "Canny Edge Detection", "Bilateral", "Laplacian", "Sharpening", "Cartoon Effect", "Motion Blur", "Emboss Effect", "Sepia Effect" ,"detectFaces", "Débruitage temporel", "Soustraction du fond", "Traînées", "Pose longue"]
+                        currentIndex: camera ? camera.filterMode : 0 // Filtre de la caméra affichée (suit le changement de caméra)
+                        enabled: camera !== null
+                        onActivated: {
+                            if (!camera)
+                                return;
+                            camera.setFilterMode(index) // Applique le filtre sélectionné à la caméra
+                            currentIndex = Qt.binding(function() { return camera ? camera.filterMode : 0 }) // La sélection remplace la liaison : la rétablit
+                        }
+                    }
+                }
+                CheckBox {
+                    id: eventRecordingBox // Enregistrement sur événement : seules les secondes autour d'un visage ou d'une capture sont écrites
+                    text: "Enregistrer seulement les événements"
+                    enabled: camera !== null
+                    checked: camera ? camera.prerollEnabled : false
+                    onToggled: {
+                        if (!camera)
+                            return;
+                        camera.setPrerollEnabled(checked) // Les dernières secondes restent en mémoire
+                        camera.setRecording(!checked && camera.isCapturing) // Plus d'écriture continue sur le disque
                     }
                 }
+                CheckBox {
+                    text: "Qualité adaptative" // Réduit la qualité par paliers quand le traitement ne tient plus la cadence
+                    enabled: camera !== null
+                    checked: camera ? camera.adaptiveQuality : false
+                    onToggled: if (camera) camera.setAdaptiveQuality(checked)
+                }
+                CheckBox {
+                    text: "Ignorer les images inchangées" // Ne retraite que les zones de l'image qui ont bougé
+                    enabled: camera !== null
+                    checked: camera ? camera.changeDetection : false
+                    onToggled: if (camera) camera.setChangeDetection(checked)
+                }
             }
             // Indicateur de l'enregistrement de la vidéo
             Rectangle {
@@ -190,7 +266,7 @@ Window {
                 radius: 10 // Les coins du rectangle sont arrondis avec un rayon de 10 pixels pour lui donner une forme circulaire.
                 // La couleur du rectangle change en fonction de l'état de l'enregistrement.
                 // Si la caméra enregistre, la couleur devient verte, sinon elle devient rouge.
-                color: camera.isRecording ? "green" : "red" // Si camera.isRecording est vrai, la couleur est verte, sinon elle est rouge.
+                color: camera && camera.isRecording ? "green" : "red" // Si camera.isRecording est vrai, la couleur est verte, sinon elle est rouge.
                 // Positionnement du rectangle selon les coordonnées de l'image source.
                 // Le rectangle se positionne en fonction de la position de son parent et de l'imageSource (par exemple, un affichage de caméra).
                 x: imageSource.parent.x + imageSource.x // Position horizontale du rectangle, basée sur la position de l'imageSource.
@@ -205,18 +281,24 @@ Window {
             // Premier bouton pour démarrer la caméra
                Button {
                    text: " 🎥 Démarrer la caméra" // Texte du bouton, avec un emoji de caméra.
+                   enabled: camera !== null
                    onClicked: {
+                       if (!camera)
+                           return;
                        // Lorsque le bouton est cliqué, les actions suivantes sont exécutées :
                        camera.setResolution(widthBox.value, heightBox.value) // La résolution de la caméra est définie selon les valeurs des zones de saisie (widthBox et heightBox).
                        camera.setOutputFile("output.avi") // Le fichier de sortie pour la capture vidéo est défini sur "output.avi".
                        camera.startCapture() // La capture vidéo commence.
-                       camera.setRecording(true) // L'enregistrement vidéo est activé.
+                       camera.setRecording(!camera.prerollEnabled) // L'enregistrement continu est activé (sauf en mode événement).
                    }
                }
                // Deuxième bouton pour arrêter la caméra
                    Button {
                        text: " ⏹ Arrêter la caméra" // Texte du bouton, avec un emoji d'arrêt.
+                       enabled: camera !== null
                        onClicked: {
+                           if (!camera)
+                               return;
                            camera.setRecording(false) // L'enregistrement vidéo est arrêté.
                            camera.stopCapture() // La capture vidéo est arrêtée.
                        }
@@ -224,10 +306,62 @@ Window {
                    // Troisième bouton pour détecter une image
                      Button {
                          text: " 📸 Détecter une image" // Texte du bouton, avec un emoji de caméra.
-                         onClicked: camera.detectImage() // Lors du clic sur ce bouton, la fonction "detectImage" de la caméra est appelée pour capturer une image.
+                         enabled: camera !== null
+                         onClicked: if (camera) camera.takeSnapshot() // Enregistre la prochaine frame traitée, sans bloquer l'interface (fin signalée par snapshotSaved).
+                     }
+                     // Quatrième bouton : rafale des 10 prochaines frames
+                     Button {
+                         text: " 🎞 Rafale"
+                         enabled: camera !== null
+                         onClicked: if (camera) camera.captureBurst(10)
+                     }
+                     // Résultat de la dernière capture d'image
+                     Text {
+                         id: snapshotStatus
+                         anchors.verticalCenter: parent.verticalCenter
+                         color: "#FFFFFF"
                      }
                  }
            }
 
 
+    // Caméras ouvertes par le gestionnaire (plusieurs caméras) : vignette, cadence, priorité ; clic = caméra affichée
+    ListView {
+        visible: cameraManager.count > 1
+        anchors.right: parent.right
+        anchors.top: parent.top
+        anchors.margins: 20
+        width: 180
+        height: Math.min(contentHeight, parent.height - 120)
+        spacing: 8
+        clip: true
+        model: cameraManager
+        delegate: Rectangle {
+            width: 180
+            height: 120
+            radius: 6
+            color: index === selectedCamera ? "#00A8E8" : "#444444"
+            Image {
+                anchors.fill: parent
+                anchors.margins: 4
+                source: "image://camera/" + model.sourceId + "/" + model.camera.frameId
+                cache: false
+                fillMode: Image.PreserveAspectFit
+            }
+            Text {
+                anchors.left: parent.left
+                anchors.bottom: parent.bottom
+                anchors.margins: 6
+                text: model.frameSource + "  " + (model.status === "ready" ? model.camera.realFrameRate.toFixed(1) + " FPS" : model.status)
+                      + "  P" + model.priority
+                color: "#FFFFFF"
+                style: Text.Outline
+                font.pixelSize: 11
+            }
+            MouseArea {
+                anchors.fill: parent
+                onClicked: selectedCamera = index
+            }
+        }
+    }
 }
@@ -0,0 +1,158 @@
+#include "metrics.h" // Déclaration des classes de mesure.
+#include <QJsonDocument> // Sérialisation JSON.
+#include <QSaveFile> // Écriture atomique (le lecteur ne voit jamais un fichier à moitié écrit).
+#include <algorithm> // std::max.
+Q_LOGGING_CATEGORY(lcPipeline, "mauellopencv.pipeline", QtInfoMsg) // Debug désactivé par défaut.
+static int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+// ---------------------------------------------------------------------------
+// LogRateLimiter
+LogRateLimiter::LogRateLimiter(int intervalMs)
+    : m_intervalNs(static_cast<int64_t>(intervalMs) * 1000000) {
+}
+bool LogRateLimiter::allow(uint64_t *suppressed) {
+    const int64_t now = nowNs();
+    int64_t next = m_nextNs.load(std::memory_order_relaxed);
+    if (now < next || !m_nextNs.compare_exchange_strong(next, now + m_intervalNs, std::memory_order_relaxed)) {
+        m_suppressed.fetch_add(1, std::memory_order_relaxed); // Trop tôt, ou un autre thread vient d'émettre.
+        return false;
+    }
+    const uint64_t skipped = m_suppressed.exchange(0, std::memory_order_relaxed);
+    if (suppressed) {
+        *suppressed = skipped;
+    }
+    return true;
+}
+// ---------------------------------------------------------------------------
+// LatencyHistogram
+// Les 16 premières valeurs ont chacune leur intervalle ; au-delà, 16 intervalles par puissance de deux
+int LatencyHistogram::bucketIndex(uint64_t value) {
+    const uint64_t subBuckets = 1u << subBucketBits;
+    if (value < subBuckets) {
+        return static_cast<int>(value);
+    }
+    int msb = 63;
+    while (!(value >> msb)) {
+        --msb; // Position du bit de poids fort (msb >= subBucketBits).
+    }
+    const int group = msb - subBucketBits + 1;
+    const int sub = static_cast<int>((value >> (msb - subBucketBits)) & (subBuckets - 1));
+    return (group << subBucketBits) + sub;
+}
+int64_t LatencyHistogram::bucketUpperBound(int index) {
+    const int group = index >> subBucketBits;
+    const int64_t sub = index & ((1 << subBucketBits) - 1);
+    if (group == 0) {
+        return sub;
+    }
+    const int shift = group - 1; // msb - subBucketBits.
+    return (((int64_t(1) << subBucketBits) + sub + 1) << shift) - 1;
+}
+void LatencyHistogram::record(int64_t ns) {
+    const uint64_t value = static_cast<uint64_t>(std::max<int64_t>(0, ns));
+    m_counts[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+    int64_t previous = m_max.load(std::memory_order_relaxed);
+    while (ns > previous && !m_max.compare_exchange_weak(previous, ns, std::memory_order_relaxed)) {
+    }
+}
+// Résume et vide la fenêtre (une mesure enregistrée pendant l'appel peut glisser dans la fenêtre suivante)
+LatencyHistogram::Snapshot LatencyHistogram::takeSnapshot() {
+    Snapshot snapshot;
+    std::array<uint64_t, bucketCount> counts;
+    uint64_t total = 0;
+    for (int i = 0; i < bucketCount; ++i) {
+        counts[i] = m_counts[i].exchange(0, std::memory_order_relaxed);
+        total += counts[i];
+    }
+    m_count.exchange(0, std::memory_order_relaxed);
+    const uint64_t sum = m_sum.exchange(0, std::memory_order_relaxed);
+    snapshot.maxNs = m_max.exchange(0, std::memory_order_relaxed);
+    snapshot.count = total;
+    if (total == 0) {
+        return snapshot;
+    }
+    snapshot.meanNs = static_cast<double>(sum) / total;
+    const double quantiles[3] = {0.50, 0.95, 0.99};
+    int64_t *results[3] = {&snapshot.p50Ns, &snapshot.p95Ns, &snapshot.p99Ns};
+    int next = 0;
+    uint64_t cumulative = 0;
+    for (int i = 0; i < bucketCount && next < 3; ++i) {
+        cumulative += counts[i];
+        while (next < 3 && cumulative >= static_cast<uint64_t>(quantiles[next] * total + 0.5)) {
+            *results[next++] = std::min(bucketUpperBound(i), snapshot.maxNs); // Borne haute, sans dépasser le maximum observé.
+        }
+    }
+    return snapshot;
+}
+// ---------------------------------------------------------------------------
+// PipelineMetrics
+static const char *const stageNames[PipelineMetrics::StageCount] = {"grab", "filter", "convert", "encode", "publish", "record"};
+PipelineMetrics::ScopedTimer::ScopedTimer(PipelineMetrics *metrics, Stage stage)
+    : m_metrics(metrics), m_stage(stage), m_start(std::chrono::steady_clock::now()) {
+}
+PipelineMetrics::ScopedTimer::~ScopedTimer() {
+    if (m_metrics) {
+        m_metrics->record(m_stage, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+    }
+}
+void PipelineMetrics::record(Stage stage, int64_t ns) {
+    m_histograms[stage].record(ns);
+}
+// FPS lissé : moyenne exponentielle de l'intervalle entre deux frames traitées
+void PipelineMetrics::frameCompleted(int64_t timestampNs) {
+    if (m_lastFrameNs > 0 && timestampNs > m_lastFrameNs) {
+        const double interval = static_cast<double>(timestampNs - m_lastFrameNs);
+        const double smoothed = m_intervalNs.load(std::memory_order_relaxed);
+        m_intervalNs.store(smoothed > 0 ? smoothed + 0.1 * (interval - smoothed) : interval, std::memory_order_relaxed);
+    }
+    m_lastFrameNs = timestampNs;
+}
+double PipelineMetrics::fps() const {
+    const double interval = m_intervalNs.load(std::memory_order_relaxed);
+    return interval > 0 ? 1e9 / interval : 0.0;
+}
+void PipelineMetrics::resetFps() {
+    m_intervalNs.store(0.0, std::memory_order_relaxed);
+    m_lastFrameNs = 0;
+}
+PipelineMetrics::Report PipelineMetrics::collect() {
+    Report report;
+    report.fps = fps();
+    for (int stage = 0; stage < StageCount; ++stage) {
+        report.stages[stage] = m_histograms[stage].takeSnapshot();
+    }
+    return report;
+}
+const char *PipelineMetrics::stageName(Stage stage) {
+    return stageNames[stage];
+}
+// {"fps": 29.9, "stages": {"grab": {"count": 30, "p50_ms": 1.2, ...}, ...}}
+QJsonObject PipelineMetrics::toJson(const Report &report) {
+    QJsonObject stages;
+    for (int stage = 0; stage < StageCount; ++stage) {
+        const LatencyHistogram::Snapshot &snapshot = report.stages[stage];
+        QJsonObject values;
+        values["count"] = static_cast<double>(snapshot.count);
+        values["p50_ms"] = snapshot.p50Ns / 1e6;
+        values["p95_ms"] = snapshot.p95Ns / 1e6;
+        values["p99_ms"] = snapshot.p99Ns / 1e6;
+        values["max_ms"] = snapshot.maxNs / 1e6;
+        values["mean_ms"] = snapshot.meanNs / 1e6;
+        stages[stageNames[stage]] = values;
+    }
+    QJsonObject json;
+    json["fps"] = report.fps;
+    json["stages"] = stages;
+    return json;
+}
+bool PipelineMetrics::writeJson(const QJsonObject &json, const QString &path) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QJsonDocument(json).toJson(QJsonDocument::Indented));
+    return file.commit();
+}
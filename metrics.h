@@ -0,0 +1,79 @@
+#ifndef METRICS_H
+#define METRICS_H
+// Inclusion des bibliothèques nécessaires
+#include <QJsonObject> // Export des mesures.
+#include <QLoggingCategory> // Catégorie de logs du pipeline (niveau réglable par QT_LOGGING_RULES).
+#include <QString> // Chemin du fichier de mesures.
+#include <array> // Compteurs des histogrammes.
+#include <atomic> // Enregistrement sans verrou.
+#include <chrono> // Chronomètres des étapes.
+#include <cstdint> // Durées en nanosecondes.
+// Logs du pipeline : "mauellopencv.pipeline.debug=true" dans QT_LOGGING_RULES pour les messages de debug
+Q_DECLARE_LOGGING_CATEGORY(lcPipeline)
+// Limiteur de débit des logs sur le chemin chaud : au plus un message par intervalle, les autres sont comptés.
+// Utilisation : static LogRateLimiter limiter; uint64_t skipped; if (limiter.allow(&skipped)) qCWarning(...) << ...;
+class LogRateLimiter {
+public:
+    explicit LogRateLimiter(int intervalMs = 5000);
+    bool allow(uint64_t *suppressed = nullptr); // Vrai si un message peut être émis ; suppressed = messages ignorés depuis le précédent.
+private:
+    int64_t m_intervalNs; // Intervalle minimal entre deux messages.
+    std::atomic<int64_t> m_nextNs{0}; // Heure à partir de laquelle le prochain message est permis.
+    std::atomic<uint64_t> m_suppressed{0}; // Messages ignorés depuis le dernier émis.
+};
+// Histogramme de latences log-linéaire (à la manière de HdrHistogram) : 16 sous-intervalles par puissance de deux,
+// soit une précision relative d'environ 6 % de la nanoseconde à plusieurs minutes. record() est sans verrou et
+// peut être appelé depuis n'importe quel thread ; takeSnapshot() vide la fenêtre courante.
+class LatencyHistogram {
+public:
+    // Résumé d'une fenêtre de mesures
+    struct Snapshot {
+        uint64_t count = 0;
+        int64_t p50Ns = 0, p95Ns = 0, p99Ns = 0, maxNs = 0;
+        double meanNs = 0.0;
+    };
+    void record(int64_t ns); // Ajoute une mesure.
+    Snapshot takeSnapshot(); // Résume les mesures depuis le dernier appel et remet la fenêtre à zéro.
+private:
+    static const int subBucketBits = 4; // 16 sous-intervalles par puissance de deux.
+    static const int bucketCount = (64 - subBucketBits + 1) << subBucketBits;
+    static int bucketIndex(uint64_t value); // Intervalle d'une valeur.
+    static int64_t bucketUpperBound(int index); // Plus grande valeur d'un intervalle.
+    std::array<std::atomic<uint64_t>, bucketCount> m_counts{}; // Compteurs par intervalle.
+    std::atomic<uint64_t> m_count{0}; // Nombre de mesures.
+    std::atomic<uint64_t> m_sum{0}; // Somme des mesures (moyenne).
+    std::atomic<int64_t> m_max{0}; // Plus grande mesure.
+};
+// Mesures du pipeline : un histogramme par étape et un FPS lissé.
+class PipelineMetrics {
+public:
+    enum Stage { Grab, Filter, Convert, Encode, Publish, Record, StageCount }; // Étapes chronométrées.
+    // Chronomètre d'une étape (ne mesure rien si metrics est nul)
+    class ScopedTimer {
+    public:
+        ScopedTimer(PipelineMetrics *metrics, Stage stage);
+        ~ScopedTimer();
+    private:
+        PipelineMetrics *m_metrics;
+        Stage m_stage;
+        std::chrono::steady_clock::time_point m_start;
+    };
+    // Mesures d'une fenêtre (en millisecondes)
+    struct Report {
+        double fps = 0.0;
+        LatencyHistogram::Snapshot stages[StageCount];
+    };
+    void record(Stage stage, int64_t ns); // Ajoute une durée à une étape (tout thread).
+    void frameCompleted(int64_t timestampNs); // Fin du traitement d'une frame (met à jour le FPS lissé).
+    double fps() const; // FPS lissé (moyenne exponentielle de l'intervalle entre frames).
+    void resetFps(); // Nouvelle source : l'intervalle précédent n'a plus de sens.
+    Report collect(); // Résume la fenêtre écoulée et en commence une nouvelle.
+    static const char *stageName(Stage stage); // Nom d'une étape ("grab", "filter"...).
+    static QJsonObject toJson(const Report &report); // Mesures au format JSON (millisecondes).
+    static bool writeJson(const QJsonObject &json, const QString &path); // Écrit le fichier de façon atomique.
+private:
+    LatencyHistogram m_histograms[StageCount]; // Un histogramme par étape.
+    std::atomic<double> m_intervalNs{0.0}; // Intervalle lissé entre deux frames.
+    int64_t m_lastFrameNs = 0; // Horodatage de la frame précédente (thread de traitement).
+};
+#endif // METRICS_H
@@ -0,0 +1,420 @@
+#include "mjpegserver.h" // Déclaration de la classe MjpegServer.
+#include "metrics.h" // Logs du pipeline.
+#include <opencv2/imgcodecs.hpp> // cv::imencode.
+#include <QJsonArray> // Liste des clients dans les mesures.
+#include <QJsonDocument> // Réponse "/stats".
+#include <QStringList> // Sources de l'index.
+#include <QTcpServer> // Socket d'écoute.
+#include <QTcpSocket> // Connexions des clients.
+#include <algorithm> // std::max, std::min.
+#include <chrono> // Durée de compression.
+static const int maxRequestBytes = 8192; // Au-delà, la requête est refusée (client mal formé).
+static const QByteArray boundary = QByteArrayLiteral("frame"); // Séparateur des parties du flux.
+std::mutex MjpegServer::s_instanceMutex;
+std::condition_variable MjpegServer::s_unpinned;
+MjpegServer *MjpegServer::s_instance = nullptr;
+// Constructeur : le thread réseau et son contexte sont créés tout de suite, l'écoute commence avec listen()
+MjpegServer::MjpegServer() {
+    m_network = new QObject;
+    m_network->moveToThread(&m_networkThread);
+    QObject::connect(&m_networkThread, &QThread::finished, m_network, &QObject::deleteLater); // Détruit sur son thread, à l'arrêt.
+    m_networkThread.setObjectName(QStringLiteral("mjpeg-network"));
+    m_networkThread.start();
+}
+// Destructeur : plus aucune nouvelle publication, attente de celles en cours, puis arrêt de l'encodeur et fermeture des connexions
+MjpegServer::~MjpegServer() {
+    {
+        std::unique_lock<std::mutex> locker(s_instanceMutex);
+        if (s_instance == this) {
+            s_instance = nullptr;
+        }
+        s_unpinned.wait(locker, [this]() { return m_pins == 0; });
+    }
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeUp.notify_all();
+    if (m_encoder.joinable()) {
+        m_encoder.join();
+    }
+    QMetaObject::invokeMethod(m_network, [this]() {
+        for (QTcpSocket *socket : m_clients.keys()) {
+            socket->abort();
+        }
+        m_clients.clear();
+        delete m_server; // Ferme l'écoute et détruit les sockets (enfants du serveur).
+        m_server = nullptr;
+    }, Qt::BlockingQueuedConnection);
+    m_networkThread.quit();
+    m_networkThread.wait();
+}
+// Démarre l'écoute sur le thread réseau et devient le serveur des publications
+bool MjpegServer::listen(quint16 port, const QHostAddress &address) {
+    bool listening = false;
+    QMetaObject::invokeMethod(m_network, [this, port, address, &listening]() {
+        if (!m_server) {
+            m_server = new QTcpServer(m_network);
+            QObject::connect(m_server, &QTcpServer::newConnection, m_network, [this]() { acceptClients(); });
+        }
+        listening = m_server->listen(address, port);
+        if (listening) {
+            m_port = m_server->serverPort();
+        } else {
+            qCWarning(lcPipeline) << "Erreur : Impossible d'écouter sur le port" << port << ":" << m_server->errorString();
+        }
+    }, Qt::BlockingQueuedConnection);
+    if (!listening) {
+        return false;
+    }
+    if (!m_encoder.joinable()) {
+        m_encoder = std::thread(&MjpegServer::encodeLoop, this);
+    }
+    std::lock_guard<std::mutex> locker(s_instanceMutex);
+    s_instance = this;
+    return true;
+}
+quint16 MjpegServer::port() const {
+    return m_port;
+}
+void MjpegServer::setQuality(int quality) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_quality = std::max(1, std::min(100, quality));
+}
+MjpegServer *MjpegServer::pin() {
+    std::lock_guard<std::mutex> locker(s_instanceMutex);
+    if (s_instance) {
+        ++s_instance->m_pins;
+    }
+    return s_instance;
+}
+void MjpegServer::unpin() {
+    std::lock_guard<std::mutex> locker(s_instanceMutex);
+    if (--m_pins == 0) {
+        s_unpinned.notify_all();
+    }
+}
+// Dépose la dernière frame d'une source ; une frame pas encore compressée est remplacée (l'encodeur ne prend pas de retard)
+void MjpegServer::publish(const QString &sourceId, const cv::Mat &frame) {
+    if (frame.empty()) {
+        return;
+    }
+    MjpegServer *server = pin(); // Le serveur ne peut pas disparaître pendant la copie ; les autres caméras publient en parallèle.
+    if (!server) {
+        return;
+    }
+    server->enqueue(sourceId, frame);
+    server->unpin();
+}
+void MjpegServer::enqueue(const QString &sourceId, const cv::Mat &frame) {
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        std::unique_ptr<Stream> &stream = m_streams[sourceId]; // La source apparaît dans l'index dès sa première frame.
+        if (!stream) {
+            stream.reset(new Stream);
+        }
+        if (stream->clients == 0) {
+            return; // Personne ne regarde : ni copie ni compression.
+        }
+    }
+    cv::Mat copy = m_pool.acquire(frame.rows, frame.cols, frame.type());
+    frame.copyTo(copy); // Hors verrou : l'encodeur continue pendant la copie.
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        auto it = m_streams.find(sourceId);
+        if (it == m_streams.end()) {
+            return; // Source retirée entre-temps.
+        }
+        Stream &stream = *it->second;
+        if (stream.pending.empty()) {
+            ++m_pendingCount;
+        } else {
+            ++stream.droppedFrames; // La précédente n'a pas encore été compressée : seule la plus récente compte.
+        }
+        stream.pending = copy; // L'ancienne copie retourne au pool.
+    }
+    m_wakeUp.notify_one();
+}
+// Retire une source : plus de publication, clients déconnectés
+void MjpegServer::remove(const QString &sourceId) {
+    std::lock_guard<std::mutex> instanceLocker(s_instanceMutex);
+    MjpegServer *server = s_instance;
+    if (!server) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> locker(server->m_mutex);
+        auto it = server->m_streams.find(sourceId);
+        if (it == server->m_streams.end()) {
+            return;
+        }
+        if (!it->second->pending.empty()) {
+            --server->m_pendingCount;
+        }
+        server->m_streams.erase(it);
+    }
+    QMetaObject::invokeMethod(server->m_network, [server, sourceId]() { server->closeStream(sourceId); }, Qt::QueuedConnection);
+}
+int MjpegServer::clientCount(const QString &sourceId) {
+    std::lock_guard<std::mutex> instanceLocker(s_instanceMutex);
+    MjpegServer *server = s_instance;
+    if (!server) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> locker(server->m_mutex);
+    auto it = server->m_streams.find(sourceId);
+    return it == server->m_streams.end() ? 0 : it->second->clients;
+}
+// Boucle du thread d'encodage : chaque frame en attente est compressée une fois puis confiée au thread réseau
+void MjpegServer::encodeLoop() {
+    std::vector<uchar> jpeg; // Tampon d'encodage (capacité conservée).
+    std::vector<std::pair<QString, cv::Mat>> work; // Frames prises sous le verrou.
+    std::unique_lock<std::mutex> locker(m_mutex);
+    for (;;) {
+        m_wakeUp.wait(locker, [this]() { return m_stopping || m_pendingCount > 0; });
+        if (m_stopping) {
+            return;
+        }
+        for (auto &entry : m_streams) {
+            if (!entry.second->pending.empty()) {
+                work.emplace_back(entry.first, entry.second->pending);
+                entry.second->pending = cv::Mat();
+            }
+        }
+        m_pendingCount = 0;
+        const std::vector<int> params = {cv::IMWRITE_JPEG_QUALITY, m_quality};
+        locker.unlock();
+        for (auto &item : work) {
+            const auto start = std::chrono::steady_clock::now();
+            const bool encoded = cv::imencode(".jpg", item.second, jpeg, params);
+            const double encodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            item.second = cv::Mat(); // La copie retourne au pool.
+            if (!encoded) {
+                static LogRateLimiter limiter;
+                if (limiter.allow()) {
+                    qCWarning(lcPipeline, "Erreur : Encodage JPEG du flux impossible !");
+                }
+                continue;
+            }
+            // Partie multipart complète : écrite telle quelle à chaque client (données partagées, pas de copie par client ici)
+            QByteArray part;
+            part.reserve(static_cast<int>(jpeg.size()) + 96);
+            part += "--" + boundary + "\r\nContent-Type: image/jpeg\r\nContent-Length: ";
+            part += QByteArray::number(static_cast<qulonglong>(jpeg.size()));
+            part += "\r\n\r\n";
+            part.append(reinterpret_cast<const char *>(jpeg.data()), static_cast<int>(jpeg.size()));
+            part += "\r\n";
+            const QString sourceId = item.first;
+            QMetaObject::invokeMethod(m_network, [this, sourceId, part]() { deliver(sourceId, part); }, Qt::QueuedConnection);
+            std::lock_guard<std::mutex> statsLocker(m_mutex);
+            auto it = m_streams.find(sourceId);
+            if (it != m_streams.end()) {
+                ++it->second->encodedFrames;
+                it->second->encodeMs = it->second->encodedFrames == 1 ? encodeMs : 0.9 * it->second->encodeMs + 0.1 * encodeMs;
+            }
+        }
+        work.clear();
+        locker.lock();
+    }
+}
+// Nouvelles connexions (thread réseau)
+void MjpegServer::acceptClients() {
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        Client &client = m_clients[socket];
+        client.connected.start();
+        client.peer = QStringLiteral("%1:%2").arg(socket->peerAddress().toString()).arg(socket->peerPort());
+        QObject::connect(socket, &QTcpSocket::readyRead, m_network, [this, socket]() { readRequest(socket); });
+        QObject::connect(socket, &QTcpSocket::bytesWritten, m_network, [this, socket](qint64 bytes) {
+            auto it = m_clients.find(socket);
+            if (it != m_clients.end()) {
+                it->bytesSent += bytes;
+                flush(socket, *it); // La socket se vide : place à la frame la plus récente.
+            }
+        });
+        QObject::connect(socket, &QTcpSocket::disconnected, m_network, [this, socket]() { disconnectClient(socket); });
+        qCDebug(lcPipeline) << "Flux MJPEG : connexion de" << client.peer;
+    }
+}
+// Lit la requête HTTP et sert l'index, les mesures ou un flux
+void MjpegServer::readRequest(QTcpSocket *socket) {
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end()) {
+        return;
+    }
+    Client &client = *it;
+    if (client.streaming || socket->state() != QAbstractSocket::ConnectedState) {
+        socket->readAll(); // Flux en cours ou réponse déjà envoyée : plus rien à lire.
+        return;
+    }
+    client.request += socket->readAll();
+    const int end = client.request.indexOf("\r\n\r\n");
+    if (end < 0) {
+        if (client.request.size() > maxRequestBytes) {
+            sendResponse(socket, "431 Request Header Fields Too Large", "text/plain", "Requête trop longue\n");
+        }
+        return; // Requête incomplète : la suite arrivera.
+    }
+    const QList<QByteArray> words = client.request.left(client.request.indexOf("\r\n")).split(' ');
+    if (words.size() < 2 || words[0] != "GET") {
+        sendResponse(socket, "405 Method Not Allowed", "text/plain", "Seule la méthode GET est acceptée\n");
+        return;
+    }
+    const QString path = QString::fromUtf8(words[1]).section('?', 0, 0);
+    if (path == QLatin1String("/stats")) {
+        sendResponse(socket, "200 OK", "application/json", QJsonDocument(collectStats()).toJson());
+        return;
+    }
+    QStringList sources;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        for (const auto &entry : m_streams) {
+            sources << entry.first;
+        }
+    }
+    if (path == QLatin1String("/")) {
+        QByteArray html = "<html><body>\n";
+        for (const QString &source : sources) {
+            html += "<p><a href=\"/" + source.toUtf8() + "\">" + source.toUtf8() + "</a><br><img src=\"/" + source.toUtf8() + "\"></p>\n";
+        }
+        html += "<p><a href=\"/stats\">stats</a></p>\n</body></html>\n";
+        sendResponse(socket, "200 OK", "text/html; charset=utf-8", html);
+        return;
+    }
+    QString sourceId = path.mid(1);
+    if (sourceId.endsWith(QLatin1String(".mjpg"))) {
+        sourceId.chop(5);
+    }
+    if (!sources.contains(sourceId)) {
+        sendResponse(socket, "404 Not Found", "text/plain", "Source inconnue\n");
+        return;
+    }
+    startStream(socket, client, sourceId);
+}
+// Envoie l'en-tête du flux et la dernière frame connue (une scène fixe ne produit plus de nouvelle frame)
+void MjpegServer::startStream(QTcpSocket *socket, Client &client, const QString &sourceId) {
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        auto it = m_streams.find(sourceId);
+        if (it == m_streams.end()) {
+            sendResponse(socket, "404 Not Found", "text/plain", "Source inconnue\n");
+            return;
+        }
+        ++it->second->clients; // Les publications suivantes seront compressées.
+    }
+    client.sourceId = sourceId;
+    client.streaming = true;
+    client.request.clear();
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1); // Pas d'attente de Nagle entre deux frames.
+    socket->write("HTTP/1.0 200 OK\r\nContent-Type: multipart/x-mixed-replace; boundary=" + boundary
+                  + "\r\nCache-Control: no-cache, no-store\r\nPragma: no-cache\r\nConnection: close\r\n\r\n");
+    client.pending = m_lastParts.value(sourceId);
+    flush(socket, client);
+    qCDebug(lcPipeline) << "Flux MJPEG :" << client.peer << "regarde" << sourceId;
+}
+// Distribue une frame compressée : écrite tout de suite aux clients à jour, gardée (la plus récente seulement) pour les autres
+void MjpegServer::deliver(const QString &sourceId, const QByteArray &part) {
+    if (!m_server) {
+        return; // Arrêt en cours.
+    }
+    m_lastParts.insert(sourceId, part);
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        Client &client = *it;
+        if (!client.streaming || client.sourceId != sourceId) {
+            continue;
+        }
+        if (!client.pending.isEmpty()) {
+            ++client.framesSkipped; // Jamais envoyée : remplacée par la plus récente.
+        }
+        client.pending = part; // Partage implicite : aucune copie.
+        flush(it.key(), client);
+    }
+}
+// Écrit la frame en attente si la socket a fini d'envoyer la précédente
+void MjpegServer::flush(QTcpSocket *socket, Client &client) {
+    if (!client.streaming || client.pending.isEmpty() || socket->bytesToWrite() > 0) {
+        return; // Client lent : il recevra la plus récente quand sa socket se sera vidée.
+    }
+    socket->write(client.pending);
+    client.pending.clear();
+    ++client.framesSent;
+}
+// Oublie un client déconnecté
+void MjpegServer::disconnectClient(QTcpSocket *socket) {
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end()) {
+        return;
+    }
+    if (it->streaming) {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        auto stream = m_streams.find(it->sourceId);
+        if (stream != m_streams.end()) {
+            --stream->second->clients;
+        }
+    }
+    qCDebug(lcPipeline) << "Flux MJPEG : déconnexion de" << it->peer << "(" << it->framesSent << "frames envoyées," << it->framesSkipped << "sautées)";
+    m_clients.erase(it);
+    socket->deleteLater();
+}
+// Ferme les clients d'une source retirée
+void MjpegServer::closeStream(const QString &sourceId) {
+    m_lastParts.remove(sourceId);
+    QList<QTcpSocket *> sockets;
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        if (it->sourceId == sourceId) {
+            it->streaming = false; // Le flux n'existe plus : rien à décompter.
+            sockets << it.key();
+        }
+    }
+    for (QTcpSocket *socket : sockets) {
+        socket->disconnectFromHost(); // disconnected() retire le client.
+    }
+}
+// Mesures des flux et des clients (la contre-pression se lit dans queuedBytes et framesSkipped)
+QJsonObject MjpegServer::stats() const {
+    if (QThread::currentThread() == &m_networkThread) {
+        return collectStats();
+    }
+    QJsonObject json;
+    QMetaObject::invokeMethod(m_network, [this, &json]() { json = collectStats(); }, Qt::BlockingQueuedConnection);
+    return json;
+}
+QJsonObject MjpegServer::collectStats() const {
+    QJsonObject json;
+    json["port"] = m_port;
+    QJsonArray streams;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        json["quality"] = m_quality;
+        for (const auto &entry : m_streams) {
+            QJsonObject stream;
+            stream["source"] = entry.first;
+            stream["clients"] = entry.second->clients;
+            stream["encodedFrames"] = static_cast<double>(entry.second->encodedFrames);
+            stream["droppedFrames"] = static_cast<double>(entry.second->droppedFrames);
+            stream["encodeMs"] = entry.second->encodeMs;
+            streams.append(stream);
+        }
+    }
+    json["streams"] = streams;
+    QJsonArray clients;
+    for (auto it = m_clients.cbegin(); it != m_clients.cend(); ++it) {
+        const Client &client = *it;
+        QJsonObject object;
+        object["peer"] = client.peer;
+        object["source"] = client.sourceId;
+        object["connectedSeconds"] = client.connected.elapsed() / 1000.0;
+        object["framesSent"] = static_cast<double>(client.framesSent);
+        object["framesSkipped"] = static_cast<double>(client.framesSkipped);
+        object["bytesSent"] = static_cast<double>(client.bytesSent);
+        object["queuedBytes"] = static_cast<double>(it.key()->bytesToWrite()); // Octets pas encore acceptés par la socket.
+        clients.append(object);
+    }
+    json["clients"] = clients;
+    return json;
+}
+// Réponse HTTP complète, puis fermeture une fois envoyée
+void MjpegServer::sendResponse(QTcpSocket *socket, const QByteArray &status, const QByteArray &type, const QByteArray &body) {
+    socket->write("HTTP/1.0 " + status + "\r\nContent-Type: " + type + "\r\nContent-Length: " + QByteArray::number(body.size())
+                  + "\r\nConnection: close\r\n\r\n" + body);
+    socket->disconnectFromHost();
+}
@@ -0,0 +1,97 @@
+#ifndef MJPEGSERVER_H
+#define MJPEGSERVER_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat pour les frames.
+#include "bufferpool.h" // Copies des frames en attente d'encodage.
+#include <QByteArray> // Parties MJPEG partagées entre les clients.
+#include <QElapsedTimer> // Durée de connexion des clients.
+#include <QHash> // Clients et dernières parties par source.
+#include <QHostAddress> // Adresse d'écoute.
+#include <QJsonObject> // Mesures du serveur.
+#include <QString> // Identifiants des sources.
+#include <QThread> // Thread réseau.
+#include <condition_variable> // Réveil du thread d'encodage.
+#include <cstdint> // Compteurs.
+#include <map> // Flux par source.
+#include <memory> // Flux alloués une fois.
+#include <mutex> // Échanges avec le thread d'encodage.
+#include <thread> // Thread d'encodage.
+#include <vector> // Tampon JPEG.
+class QTcpServer;
+class QTcpSocket;
+// Serveur de flux MJPEG (multipart/x-mixed-replace sur HTTP) pour les autres outils de la machine ou du réseau local.
+// Chaque frame publiée est compressée une seule fois, par un thread d'encodage, quel que soit le nombre de clients ;
+// la même partie (QByteArray partagé) est ensuite écrite à tous les clients par un thread réseau dédié.
+// Un client lent ne reçoit pas d'arriéré : tant que sa frame précédente n'est pas partie, seule la plus récente
+// est gardée pour lui (les autres sont comptées comme sautées). Sans client, publish() ne copie ni n'encode rien.
+// URL : "/" (index), "/<sourceId>" (flux, ex. "/cam0"), "/stats" (mesures JSON par client).
+class MjpegServer {
+public:
+    MjpegServer();
+    ~MjpegServer(); // Ferme les connexions et arrête les threads.
+    bool listen(quint16 port, const QHostAddress &address = QHostAddress::Any); // Démarre l'écoute ; false si le port est pris.
+    quint16 port() const; // Port d'écoute (0 si inactif).
+    void setQuality(int quality); // Qualité JPEG du flux (80 par défaut).
+    QJsonObject stats() const; // Mesures des flux et de chaque client (tout thread).
+    // Accès depuis le pipeline (sans effet si aucun serveur n'écoute)
+    static void publish(const QString &sourceId, const cv::Mat &frame); // Confie une frame BGR (ou grise) à l'encodeur ; ne bloque pas.
+    static void remove(const QString &sourceId); // Retire une source et ferme ses clients.
+    static int clientCount(const QString &sourceId); // Clients connectés au flux d'une source.
+private:
+    // Flux d'une source (protégé par m_mutex)
+    struct Stream {
+        cv::Mat pending; // Dernière frame en attente d'encodage (vide si aucune).
+        int clients = 0; // Clients connectés (tenu à jour par le thread réseau).
+        uint64_t encodedFrames = 0; // Frames compressées.
+        uint64_t droppedFrames = 0; // Frames remplacées avant d'avoir été compressées (encodeur en retard).
+        double encodeMs = 0.0; // Durée de compression (moyenne glissante).
+    };
+    // Client HTTP (thread réseau uniquement)
+    struct Client {
+        QByteArray request; // Requête reçue jusqu'ici.
+        QString sourceId; // Flux servi (vide tant que la requête n'est pas traitée).
+        bool streaming = false; // En-tête du flux envoyé.
+        QByteArray pending; // Frame la plus récente pas encore écrite (socket occupée).
+        uint64_t framesSent = 0; // Frames écrites dans la socket.
+        uint64_t framesSkipped = 0; // Frames remplacées par une plus récente avant d'être écrites.
+        qint64 bytesSent = 0; // Octets effectivement envoyés.
+        QElapsedTimer connected; // Durée de connexion.
+        QString peer; // Adresse du client.
+    };
+    void encodeLoop(); // Boucle du thread d'encodage.
+    void enqueue(const QString &sourceId, const cv::Mat &frame); // Copie une frame pour l'encodeur (serveur épinglé).
+    // Thread réseau
+    void acceptClients(); // Nouvelles connexions.
+    void readRequest(QTcpSocket *socket); // Requête HTTP d'un client.
+    void startStream(QTcpSocket *socket, Client &client, const QString &sourceId); // En-tête multipart et dernière frame.
+    void deliver(const QString &sourceId, const QByteArray &part); // Distribue une frame compressée aux clients du flux.
+    void flush(QTcpSocket *socket, Client &client); // Écrit la frame en attente si la précédente est partie.
+    void disconnectClient(QTcpSocket *socket); // Oublie un client déconnecté.
+    void closeStream(const QString &sourceId); // Ferme les clients d'une source retirée.
+    QJsonObject collectStats() const; // Mesures (thread réseau).
+    static void sendResponse(QTcpSocket *socket, const QByteArray &status, const QByteArray &type, const QByteArray &body); // Réponse simple puis fermeture.
+    // Serveur courant (celui qui écoute)
+    static std::mutex s_instanceMutex;
+    static std::condition_variable s_unpinned; // Une publication se termine (le destructeur attend la dernière).
+    static MjpegServer *s_instance;
+    static MjpegServer *pin(); // Serveur courant, protégé de la destruction jusqu'à unpin() ; nul si aucun.
+    void unpin();
+    int m_pins = 0; // Publications en cours sur ce serveur (protégé par s_instanceMutex).
+    // Encodage (protégé par m_mutex)
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeUp; // Frame en attente ou arrêt.
+    std::map<QString, std::unique_ptr<Stream>> m_streams; // Flux par source.
+    int m_pendingCount = 0; // Flux ayant une frame en attente.
+    int m_quality = 80;
+    bool m_stopping = false;
+    BufferPool m_pool; // Copies des frames en attente.
+    // Réseau (objets du thread réseau)
+    QThread m_networkThread; // Boucle d'événements des sockets.
+    QObject *m_network = nullptr; // Contexte des traitements réseau (vit dans m_networkThread).
+    QTcpServer *m_server = nullptr; // Socket d'écoute.
+    QHash<QTcpSocket *, Client> m_clients; // Clients connectés.
+    QHash<QString, QByteArray> m_lastParts; // Dernière frame compressée de chaque source (envoyée aux nouveaux clients).
+    quint16 m_port = 0; // Port d'écoute.
+    std::thread m_encoder; // Thread d'encodage (démarré par listen()).
+};
+#endif // MJPEGSERVER_H
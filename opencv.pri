@@ -0,0 +1,17 @@
+# Ajoute les bibliothèques OpenCV nécessaires pour Windows (MinGW).
+win32: LIBS += -L$$PWD/../install/x64/mingw/lib/ -llibopencv_calib3d490.dll# Lie la bibliothèque OpenCV pour la calibration 3D.
+win32: LIBS += -L$$PWD/../install/x64/mingw/lib/ -llibopencv_features2d490.dll# Lie la bibliothèque pour les fonctionnalités 2D.
+win32: LIBS += -L$$PWD/../install/x64/mingw/lib/ -llibopencv_flann490.dll# Lie la bibliothèque pour la recherche approximative des voisins.
+win32: LIBS += -L$$PWD/../install/x64/mingw/lib/ -llibopencv_dnn490.dll# Lie la bibliothèque pour les réseaux de neurones profonds.
+win32: LIBS += -L$$PWD/../install/x64/mingw/lib/ -llibopencv_objdetect490.dll # Lie la bibliothèque pour la détection d'objets.
+win32: LIBS += -L$$PWD/../install/x64/mingw/lib/ -llibopencv_core490.dll# Lie la bibliothèque pour les fonctionnalités principales d'OpenCV.
+win32: LIBS += -L$$PWD/../install/x64/mingw/lib/ -llibopencv_imgcodecs490.dll# Lie la bibliothèque pour les codecs d'images.
+win32: LIBS += -L$$PWD/../install/x64/mingw/lib/ -llibopencv_imgproc490.dll # Lie la bibliothèque pour le traitement d'images.
+win32: LIBS += -L$$PWD/../install/x64/mingw/lib/ -llibopencv_videoio490.dll# Lie la bibliothèque pour l'entrée/sortie vidéo.
+win32: LIBS += -L$$PWD/../install/x64/mingw/lib/ -llibopencv_highgui490.dll# Lie la bibliothèque pour l'interface graphique de visualisation.
+# Définit les chemins d'inclusion pour les fichiers d'en-tête.
+INCLUDEPATH += $$PWD/../install/include# Ajoute le répertoire contenant les fichiers d'en-tête à la liste des chemins d'inclusion.
+DEPENDPATH += $$PWD/../install/include# Définit le répertoire contenant les dépendances pour le suivi des changements.
+# Ailleurs (Linux, serveurs de build) : OpenCV installé sur le système, trouvé par pkg-config.
+unix: CONFIG += link_pkgconfig
+unix: PKGCONFIG += opencv4
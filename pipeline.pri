@@ -0,0 +1,43 @@
+# Chaîne de traitement sans interface : capture, ordonnancement multi-caméras, anneau de frames, détection de changement, filtres et noyaux vectorisés, filtres temporels, détection de visages, export en mémoire partagée, enregistrement, pré-capture et captures d'images, régulation de la qualité, pool de threads, mesures.
+# Incluse par l'application et par les outils (bench) pour compiler exactement les mêmes sources.
+INCLUDEPATH += $$PWD# Les outils incluent les en-têtes depuis leur propre dossier.
+SOURCES += \
+        $$PWD/bufferpool.cpp \
+        $$PWD/camerascheduler.cpp \
+        $$PWD/captureengine.cpp \
+        $$PWD/changedetector.cpp \
+        $$PWD/facedetector.cpp \
+        $$PWD/filtergraph.cpp \
+        $$PWD/frameexporter.cpp \
+        $$PWD/framering.cpp \
+        $$PWD/framesource.cpp \
+        $$PWD/metrics.cpp \
+        $$PWD/pixelkernels.cpp \
+        $$PWD/prerollbuffer.cpp \
+        $$PWD/qualitygovernor.cpp \
+        $$PWD/recorder.cpp \
+        $$PWD/sharedframes.cpp \
+        $$PWD/snapshotwriter.cpp \
+        $$PWD/temporalfilters.cpp \
+        $$PWD/tileexecutor.cpp \
+        $$PWD/workerpool.cpp
+HEADERS += \
+    $$PWD/bufferpool.h \
+    $$PWD/camerascheduler.h \
+    $$PWD/captureengine.h \
+    $$PWD/changedetector.h \
+    $$PWD/facedetector.h \
+    $$PWD/filtergraph.h \
+    $$PWD/frameexporter.h \
+    $$PWD/framering.h \
+    $$PWD/framesource.h \
+    $$PWD/metrics.h \
+    $$PWD/pixelkernels.h \
+    $$PWD/prerollbuffer.h \
+    $$PWD/qualitygovernor.h \
+    $$PWD/recorder.h \
+    $$PWD/sharedframes.h \
+    $$PWD/snapshotwriter.h \
+    $$PWD/temporalfilters.h \
+    $$PWD/tileexecutor.h \
+    $$PWD/workerpool.h
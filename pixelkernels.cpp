@@ -0,0 +1,513 @@
+#include "pixelkernels.h" // Déclaration de la classe PixelKernels.
+#include <algorithm> // std::min.
+#include <atomic> // Jeu d'instructions courant.
+#include <cmath> // std::lrint (arrondi au pair le plus proche, comme les conversions vectorielles).
+#include <cstdint> // Types entiers de taille fixe.
+// Jeux d'instructions compilés selon l'architecture (AVX2 et SSSE3 sont activés fonction par fonction)
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PIXELKERNELS_X86 1
+#include <immintrin.h> // Intrinsèques SSE / AVX.
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSSE3 // MSVC accepte les intrinsèques sans option de compilation.
+#define TARGET_AVX2
+#endif
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define PIXELKERNELS_NEON 1
+#include <arm_neon.h> // Intrinsèques NEON (toujours présents en AArch64).
+#endif
+namespace {
+// Paramètres d'un noyau (seul scale s'en sert)
+struct Params {
+    float alpha = 1.0f;
+    float beta = 0.0f;
+    uchar lut[256]; // Table de scale pour la version scalaire et les fins de ligne.
+};
+// Noyau sur une ligne : pixels BGR -> RGB (et BGR si bgr n'est pas nul)
+using RowKernel = void (*)(const uchar *src, uchar *rgb, uchar *bgr, int pixels, const Params &params);
+// Luminance : coefficients entiers de cv::cvtColor(BGR2GRAY) sur 14 bits
+const int grayShift = 14;
+const int grayB = 1868, grayG = 9617, grayR = 4899;
+// Sépia : même matrice que l'étape Sepia de FilterGraph (lignes = sorties B, G, R ; colonnes = entrées B, G, R), sur 14 bits
+constexpr int fixed14(double value) {
+    return static_cast<int>(value * (1 << 14) + 0.5);
+}
+const int sepiaShift = 14;
+const int sepia[3][3] = {
+    {fixed14(0.272), fixed14(0.534), fixed14(0.131)},
+    {fixed14(0.349), fixed14(0.686), fixed14(0.168)},
+    {fixed14(0.393), fixed14(0.769), fixed14(0.189)}};
+// --- Opérations sur un pixel : version scalaire et fins de ligne des versions vectorielles ---
+struct SwapPixel {
+    static void apply(const uchar *s, uchar *out, const Params &) {
+        out[0] = s[0];
+        out[1] = s[1];
+        out[2] = s[2];
+    }
+};
+struct InvertPixel {
+    static void apply(const uchar *s, uchar *out, const Params &) {
+        out[0] = static_cast<uchar>(255 - s[0]);
+        out[1] = static_cast<uchar>(255 - s[1]);
+        out[2] = static_cast<uchar>(255 - s[2]);
+    }
+};
+struct GrayPixel {
+    static void apply(const uchar *s, uchar *out, const Params &) {
+        const uchar y = static_cast<uchar>((s[0] * grayB + s[1] * grayG + s[2] * grayR + (1 << (grayShift - 1))) >> grayShift);
+        out[0] = out[1] = out[2] = y;
+    }
+};
+struct SepiaPixel {
+    static void apply(const uchar *s, uchar *out, const Params &) {
+        for (int c = 0; c < 3; ++c) {
+            const int value = (s[0] * sepia[c][0] + s[1] * sepia[c][1] + s[2] * sepia[c][2] + (1 << (sepiaShift - 1))) >> sepiaShift;
+            out[c] = static_cast<uchar>(std::min(value, 255));
+        }
+    }
+};
+struct ScalePixel {
+    static void apply(const uchar *s, uchar *out, const Params &params) {
+        out[0] = params.lut[s[0]];
+        out[1] = params.lut[s[1]];
+        out[2] = params.lut[s[2]];
+    }
+};
+// Applique Op pixel par pixel (lecture du pixel complète avant écriture : sur place possible)
+template <typename Op>
+void scalarRow(const uchar *src, uchar *rgb, uchar *bgr, int pixels, const Params &params) {
+    for (int i = 0; i < pixels; ++i, src += 3, rgb += 3) {
+        uchar out[3];
+        Op::apply(src, out, params);
+        rgb[0] = out[2];
+        rgb[1] = out[1];
+        rgb[2] = out[0];
+        if (bgr) {
+            bgr[0] = out[0];
+            bgr[1] = out[1];
+            bgr[2] = out[2];
+            bgr += 3;
+        }
+    }
+}
+#ifdef PIXELKERNELS_X86
+// --- SSSE3 : un registre porte 4 pixels (octets 0 à 11, les octets 12 à 15 sont ignorés) ---
+// Blocs de 16 pixels : 3 chargements de 16 octets découpés en 4 fenêtres de 4 pixels, puis recomposés
+// avant 3 écritures ; tout le bloc est lu avant d'être écrit (sur place possible), sans lire ni écrire hors de l'image.
+struct SwapSsse3 {
+    using Pixel = SwapPixel;
+    TARGET_SSSE3 explicit SwapSsse3(const Params &) {}
+    TARGET_SSSE3 __m128i operator()(__m128i w) const { return w; }
+};
+struct InvertSsse3 {
+    using Pixel = InvertPixel;
+    __m128i ones;
+    TARGET_SSSE3 explicit InvertSsse3(const Params &) : ones(_mm_set1_epi8(-1)) {}
+    TARGET_SSSE3 __m128i operator()(__m128i w) const { return _mm_xor_si128(w, ones); }
+};
+// Extension en 16 bits : pixels 0-1 (ou 2-3) sous la forme [B, G, R, 0, B, G, R, 0], pour _mm_madd_epi16
+TARGET_SSSE3 inline __m128i expandLowSsse3() {
+    return _mm_setr_epi8(0, -1, 1, -1, 2, -1, -1, -1, 3, -1, 4, -1, 5, -1, -1, -1);
+}
+TARGET_SSSE3 inline __m128i expandHighSsse3() {
+    return _mm_setr_epi8(6, -1, 7, -1, 8, -1, -1, -1, 9, -1, 10, -1, 11, -1, -1, -1);
+}
+struct GraySsse3 {
+    using Pixel = GrayPixel;
+    __m128i low, high, coefficients, round, replicate;
+    TARGET_SSSE3 explicit GraySsse3(const Params &)
+        : low(expandLowSsse3()), high(expandHighSsse3()),
+          coefficients(_mm_setr_epi16(grayB, grayG, grayR, 0, grayB, grayG, grayR, 0)),
+          round(_mm_set1_epi32(1 << (grayShift - 1))),
+          replicate(_mm_setr_epi8(0, 0, 0, 4, 4, 4, 8, 8, 8, 12, 12, 12, -1, -1, -1, -1)) {}
+    TARGET_SSSE3 __m128i operator()(__m128i w) const {
+        const __m128i a = _mm_madd_epi16(_mm_shuffle_epi8(w, low), coefficients); // [B0b + G0g, R0r, B1b + G1g, R1r]
+        const __m128i b = _mm_madd_epi16(_mm_shuffle_epi8(w, high), coefficients);
+        const __m128i y = _mm_srli_epi32(_mm_add_epi32(_mm_hadd_epi32(a, b), round), grayShift); // [Y0, Y1, Y2, Y3]
+        return _mm_shuffle_epi8(y, replicate);
+    }
+};
+struct SepiaSsse3 {
+    using Pixel = SepiaPixel;
+    __m128i low, high, row0, row1, row2, round, order;
+    TARGET_SSSE3 explicit SepiaSsse3(const Params &)
+        : low(expandLowSsse3()), high(expandHighSsse3()),
+          row0(_mm_setr_epi16(sepia[0][0], sepia[0][1], sepia[0][2], 0, sepia[0][0], sepia[0][1], sepia[0][2], 0)),
+          row1(_mm_setr_epi16(sepia[1][0], sepia[1][1], sepia[1][2], 0, sepia[1][0], sepia[1][1], sepia[1][2], 0)),
+          row2(_mm_setr_epi16(sepia[2][0], sepia[2][1], sepia[2][2], 0, sepia[2][0], sepia[2][1], sepia[2][2], 0)),
+          round(_mm_set1_epi32(1 << (sepiaShift - 1))),
+          order(_mm_setr_epi8(0, 2, 4, 1, 3, 5, 6, 8, 10, 7, 9, 11, -1, -1, -1, -1)) {}
+    TARGET_SSSE3 __m128i operator()(__m128i w) const {
+        const __m128i a = _mm_shuffle_epi8(w, low); // Pixels 0 et 1.
+        const __m128i b = _mm_shuffle_epi8(w, high); // Pixels 2 et 3.
+        // Sommes complètes par paires : [sortie du pixel 0, du pixel 1] pour chaque canal de sortie
+        __m128i v0 = _mm_hadd_epi32(_mm_madd_epi16(a, row0), _mm_madd_epi16(a, row1)); // [a0c0, a1c0, a0c1, a1c1]
+        __m128i v1 = _mm_hadd_epi32(_mm_madd_epi16(a, row2), _mm_madd_epi16(b, row0)); // [a0c2, a1c2, b0c0, b1c0]
+        __m128i v2 = _mm_hadd_epi32(_mm_madd_epi16(b, row1), _mm_madd_epi16(b, row2)); // [b0c1, b1c1, b0c2, b1c2]
+        v0 = _mm_srli_epi32(_mm_add_epi32(v0, round), sepiaShift);
+        v1 = _mm_srli_epi32(_mm_add_epi32(v1, round), sepiaShift);
+        v2 = _mm_srli_epi32(_mm_add_epi32(v2, round), sepiaShift);
+        const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(v0, v1), _mm_packs_epi32(v2, v2)); // Saturation à 255.
+        return _mm_shuffle_epi8(bytes, order); // Remise dans l'ordre B, G, R de chaque pixel.
+    }
+};
+struct ScaleSsse3 {
+    using Pixel = ScalePixel;
+    __m128 alpha, beta;
+    TARGET_SSSE3 explicit ScaleSsse3(const Params &params) : alpha(_mm_set1_ps(params.alpha)), beta(_mm_set1_ps(params.beta)) {}
+    TARGET_SSSE3 __m128i apply(__m128i v) const {
+        const __m128 f = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(v), alpha), beta);
+        return _mm_cvtps_epi32(f); // Arrondi au pair le plus proche, comme std::lrint.
+    }
+    TARGET_SSSE3 __m128i operator()(__m128i w) const {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i low = _mm_unpacklo_epi8(w, zero);
+        const __m128i high = _mm_unpackhi_epi8(w, zero);
+        const __m128i r0 = apply(_mm_unpacklo_epi16(low, zero));
+        const __m128i r1 = apply(_mm_unpackhi_epi16(low, zero));
+        const __m128i r2 = apply(_mm_unpacklo_epi16(high, zero));
+        const __m128i r3 = apply(_mm_unpackhi_epi16(high, zero));
+        return _mm_packus_epi16(_mm_packs_epi32(r0, r1), _mm_packs_epi32(r2, r3));
+    }
+};
+// Recompose 4 fenêtres de 12 octets (octets 12 à 15 nuls) en 48 octets contigus
+TARGET_SSSE3 inline void storeWindowsSsse3(uchar *dst, __m128i r0, __m128i r1, __m128i r2, __m128i r3) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_or_si128(r0, _mm_slli_si128(r1, 12)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_or_si128(_mm_srli_si128(r1, 4), _mm_slli_si128(r2, 8)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 32), _mm_or_si128(_mm_srli_si128(r2, 8), _mm_slli_si128(r3, 4)));
+}
+template <typename Op>
+TARGET_SSSE3 void ssse3Row(const uchar *src, uchar *rgb, uchar *bgr, int pixels, const Params &params) {
+    const Op op(params);
+    const __m128i toRgb = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, -1, -1, -1, -1); // Échange B/R, octets 12-15 à zéro.
+    const __m128i toBgr = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, -1, -1, -1, -1);
+    int i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        const uchar *s = src + i * 3;
+        const __m128i in0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+        const __m128i in1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 16));
+        const __m128i in2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 32));
+        const __m128i w0 = op(in0); // Pixels 0 à 3.
+        const __m128i w1 = op(_mm_alignr_epi8(in1, in0, 12)); // Pixels 4 à 7.
+        const __m128i w2 = op(_mm_alignr_epi8(in2, in1, 8)); // Pixels 8 à 11.
+        const __m128i w3 = op(_mm_srli_si128(in2, 4)); // Pixels 12 à 15.
+        storeWindowsSsse3(rgb + i * 3, _mm_shuffle_epi8(w0, toRgb), _mm_shuffle_epi8(w1, toRgb), _mm_shuffle_epi8(w2, toRgb),
+                          _mm_shuffle_epi8(w3, toRgb));
+        if (bgr) {
+            storeWindowsSsse3(bgr + i * 3, _mm_shuffle_epi8(w0, toBgr), _mm_shuffle_epi8(w1, toBgr), _mm_shuffle_epi8(w2, toBgr),
+                              _mm_shuffle_epi8(w3, toBgr));
+        }
+    }
+    scalarRow<typename Op::Pixel>(src + i * 3, rgb + i * 3, bgr ? bgr + i * 3 : nullptr, pixels - i, params);
+}
+// --- AVX2 : les mêmes opérations sur deux blocs de 16 pixels à la fois, un par moitié de registre ---
+// Les instructions utilisées (shuffle, madd, hadd, pack, unpack, alignr) travaillent par moitié de 128 bits :
+// chaque moitié calcule exactement ce que calcule la version SSSE3.
+TARGET_AVX2 inline __m256i broadcastAvx2(__m128i value) {
+    return _mm256_broadcastsi128_si256(value);
+}
+struct SwapAvx2 {
+    using Narrow = SwapSsse3;
+    TARGET_AVX2 explicit SwapAvx2(const Params &) {}
+    TARGET_AVX2 __m256i operator()(__m256i w) const { return w; }
+};
+struct InvertAvx2 {
+    using Narrow = InvertSsse3;
+    __m256i ones;
+    TARGET_AVX2 explicit InvertAvx2(const Params &) : ones(_mm256_set1_epi8(-1)) {}
+    TARGET_AVX2 __m256i operator()(__m256i w) const { return _mm256_xor_si256(w, ones); }
+};
+struct GrayAvx2 {
+    using Narrow = GraySsse3;
+    __m256i low, high, coefficients, round, replicate;
+    TARGET_AVX2 explicit GrayAvx2(const Params &params) {
+        const GraySsse3 narrow(params);
+        low = broadcastAvx2(narrow.low);
+        high = broadcastAvx2(narrow.high);
+        coefficients = broadcastAvx2(narrow.coefficients);
+        round = broadcastAvx2(narrow.round);
+        replicate = broadcastAvx2(narrow.replicate);
+    }
+    TARGET_AVX2 __m256i operator()(__m256i w) const {
+        const __m256i a = _mm256_madd_epi16(_mm256_shuffle_epi8(w, low), coefficients);
+        const __m256i b = _mm256_madd_epi16(_mm256_shuffle_epi8(w, high), coefficients);
+        const __m256i y = _mm256_srli_epi32(_mm256_add_epi32(_mm256_hadd_epi32(a, b), round), grayShift);
+        return _mm256_shuffle_epi8(y, replicate);
+    }
+};
+struct SepiaAvx2 {
+    using Narrow = SepiaSsse3;
+    __m256i low, high, row0, row1, row2, round, order;
+    TARGET_AVX2 explicit SepiaAvx2(const Params &params) {
+        const SepiaSsse3 narrow(params);
+        low = broadcastAvx2(narrow.low);
+        high = broadcastAvx2(narrow.high);
+        row0 = broadcastAvx2(narrow.row0);
+        row1 = broadcastAvx2(narrow.row1);
+        row2 = broadcastAvx2(narrow.row2);
+        round = broadcastAvx2(narrow.round);
+        order = broadcastAvx2(narrow.order);
+    }
+    TARGET_AVX2 __m256i operator()(__m256i w) const {
+        const __m256i a = _mm256_shuffle_epi8(w, low);
+        const __m256i b = _mm256_shuffle_epi8(w, high);
+        __m256i v0 = _mm256_hadd_epi32(_mm256_madd_epi16(a, row0), _mm256_madd_epi16(a, row1));
+        __m256i v1 = _mm256_hadd_epi32(_mm256_madd_epi16(a, row2), _mm256_madd_epi16(b, row0));
+        __m256i v2 = _mm256_hadd_epi32(_mm256_madd_epi16(b, row1), _mm256_madd_epi16(b, row2));
+        v0 = _mm256_srli_epi32(_mm256_add_epi32(v0, round), sepiaShift);
+        v1 = _mm256_srli_epi32(_mm256_add_epi32(v1, round), sepiaShift);
+        v2 = _mm256_srli_epi32(_mm256_add_epi32(v2, round), sepiaShift);
+        const __m256i bytes = _mm256_packus_epi16(_mm256_packs_epi32(v0, v1), _mm256_packs_epi32(v2, v2));
+        return _mm256_shuffle_epi8(bytes, order);
+    }
+};
+struct ScaleAvx2 {
+    using Narrow = ScaleSsse3;
+    __m256 alpha, beta;
+    TARGET_AVX2 explicit ScaleAvx2(const Params &params) : alpha(_mm256_set1_ps(params.alpha)), beta(_mm256_set1_ps(params.beta)) {}
+    TARGET_AVX2 __m256i apply(__m256i v) const {
+        const __m256 f = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(v), alpha), beta); // Pas de FMA : même arrondi qu'en SSE.
+        return _mm256_cvtps_epi32(f);
+    }
+    TARGET_AVX2 __m256i operator()(__m256i w) const {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i low = _mm256_unpacklo_epi8(w, zero);
+        const __m256i high = _mm256_unpackhi_epi8(w, zero);
+        const __m256i r0 = apply(_mm256_unpacklo_epi16(low, zero));
+        const __m256i r1 = apply(_mm256_unpackhi_epi16(low, zero));
+        const __m256i r2 = apply(_mm256_unpacklo_epi16(high, zero));
+        const __m256i r3 = apply(_mm256_unpackhi_epi16(high, zero));
+        return _mm256_packus_epi16(_mm256_packs_epi32(r0, r1), _mm256_packs_epi32(r2, r3));
+    }
+};
+// Charge deux morceaux de 16 octets distants de 48 octets (un par bloc de 16 pixels)
+TARGET_AVX2 inline __m256i loadPairAvx2(const uchar *p) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))),
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 48)), 1);
+}
+TARGET_AVX2 inline void storePairAvx2(uchar *p, __m256i value) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm256_castsi256_si128(value));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p + 48), _mm256_extracti128_si256(value, 1));
+}
+TARGET_AVX2 inline void storeWindowsAvx2(uchar *dst, __m256i r0, __m256i r1, __m256i r2, __m256i r3) {
+    storePairAvx2(dst, _mm256_or_si256(r0, _mm256_slli_si256(r1, 12)));
+    storePairAvx2(dst + 16, _mm256_or_si256(_mm256_srli_si256(r1, 4), _mm256_slli_si256(r2, 8)));
+    storePairAvx2(dst + 32, _mm256_or_si256(_mm256_srli_si256(r2, 8), _mm256_slli_si256(r3, 4)));
+}
+template <typename Op>
+TARGET_AVX2 void avx2Row(const uchar *src, uchar *rgb, uchar *bgr, int pixels, const Params &params) {
+    const Op op(params);
+    const __m256i toRgb = broadcastAvx2(_mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, -1, -1, -1, -1));
+    const __m256i toBgr = broadcastAvx2(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, -1, -1, -1, -1));
+    int i = 0;
+    for (; i + 32 <= pixels; i += 32) {
+        const uchar *s = src + i * 3;
+        const __m256i in0 = loadPairAvx2(s); // Octets 0-15 de chaque bloc.
+        const __m256i in1 = loadPairAvx2(s + 16);
+        const __m256i in2 = loadPairAvx2(s + 32);
+        const __m256i w0 = op(in0);
+        const __m256i w1 = op(_mm256_alignr_epi8(in1, in0, 12));
+        const __m256i w2 = op(_mm256_alignr_epi8(in2, in1, 8));
+        const __m256i w3 = op(_mm256_srli_si256(in2, 4));
+        storeWindowsAvx2(rgb + i * 3, _mm256_shuffle_epi8(w0, toRgb), _mm256_shuffle_epi8(w1, toRgb), _mm256_shuffle_epi8(w2, toRgb),
+                         _mm256_shuffle_epi8(w3, toRgb));
+        if (bgr) {
+            storeWindowsAvx2(bgr + i * 3, _mm256_shuffle_epi8(w0, toBgr), _mm256_shuffle_epi8(w1, toBgr), _mm256_shuffle_epi8(w2, toBgr),
+                             _mm256_shuffle_epi8(w3, toBgr));
+        }
+    }
+    ssse3Row<typename Op::Narrow>(src + i * 3, rgb + i * 3, bgr ? bgr + i * 3 : nullptr, pixels - i, params); // Reste : blocs de 16 puis pixel par pixel.
+}
+#endif // PIXELKERNELS_X86
+#ifdef PIXELKERNELS_NEON
+// --- NEON : vld3q_u8 sépare les canaux de 16 pixels, vst3q_u8 les réentrelace dans l'ordre voulu ---
+struct SwapNeon {
+    using Pixel = SwapPixel;
+    explicit SwapNeon(const Params &) {}
+    uint8x16x3_t operator()(uint8x16x3_t bgr) const { return bgr; }
+};
+struct InvertNeon {
+    using Pixel = InvertPixel;
+    explicit InvertNeon(const Params &) {}
+    uint8x16x3_t operator()(uint8x16x3_t bgr) const {
+        bgr.val[0] = vmvnq_u8(bgr.val[0]);
+        bgr.val[1] = vmvnq_u8(bgr.val[1]);
+        bgr.val[2] = vmvnq_u8(bgr.val[2]);
+        return bgr;
+    }
+};
+// Combinaison linéaire (cb * B + cg * G + cr * R) >> 14 arrondie et saturée, sur 8 pixels
+inline uint8x8_t mixNeon(uint8x8_t b, uint8x8_t g, uint8x8_t r, uint16_t cb, uint16_t cg, uint16_t cr) {
+    const uint16x8_t b16 = vmovl_u8(b), g16 = vmovl_u8(g), r16 = vmovl_u8(r);
+    uint32x4_t low = vmull_n_u16(vget_low_u16(b16), cb);
+    low = vmlal_n_u16(low, vget_low_u16(g16), cg);
+    low = vmlal_n_u16(low, vget_low_u16(r16), cr);
+    uint32x4_t high = vmull_n_u16(vget_high_u16(b16), cb);
+    high = vmlal_n_u16(high, vget_high_u16(g16), cg);
+    high = vmlal_n_u16(high, vget_high_u16(r16), cr);
+    return vqmovn_u16(vcombine_u16(vrshrn_n_u32(low, 14), vrshrn_n_u32(high, 14))); // (x + 2^13) >> 14, puis saturation.
+}
+inline uint8x16_t mixNeon(const uint8x16x3_t &bgr, int cb, int cg, int cr) {
+    return vcombine_u8(mixNeon(vget_low_u8(bgr.val[0]), vget_low_u8(bgr.val[1]), vget_low_u8(bgr.val[2]), cb, cg, cr),
+                       mixNeon(vget_high_u8(bgr.val[0]), vget_high_u8(bgr.val[1]), vget_high_u8(bgr.val[2]), cb, cg, cr));
+}
+struct GrayNeon {
+    using Pixel = GrayPixel;
+    explicit GrayNeon(const Params &) {}
+    uint8x16x3_t operator()(const uint8x16x3_t &bgr) const {
+        const uint8x16_t y = mixNeon(bgr, grayB, grayG, grayR);
+        return uint8x16x3_t{{y, y, y}};
+    }
+};
+struct SepiaNeon {
+    using Pixel = SepiaPixel;
+    explicit SepiaNeon(const Params &) {}
+    uint8x16x3_t operator()(const uint8x16x3_t &bgr) const {
+        return uint8x16x3_t{{mixNeon(bgr, sepia[0][0], sepia[0][1], sepia[0][2]), mixNeon(bgr, sepia[1][0], sepia[1][1], sepia[1][2]),
+                             mixNeon(bgr, sepia[2][0], sepia[2][1], sepia[2][2])}};
+    }
+};
+struct ScaleNeon {
+    using Pixel = ScalePixel;
+    float32x4_t alpha, beta;
+    explicit ScaleNeon(const Params &params) : alpha(vdupq_n_f32(params.alpha)), beta(vdupq_n_f32(params.beta)) {}
+    int32x4_t apply(uint16x4_t v) const {
+        const float32x4_t f = vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(v)), alpha), beta);
+        return vcvtnq_s32_f32(f); // Arrondi au pair le plus proche.
+    }
+    uint8x16_t apply(uint8x16_t v) const {
+        const uint16x8_t low = vmovl_u8(vget_low_u8(v)), high = vmovl_u8(vget_high_u8(v));
+        const int16x8_t s0 = vcombine_s16(vqmovn_s32(apply(vget_low_u16(low))), vqmovn_s32(apply(vget_high_u16(low))));
+        const int16x8_t s1 = vcombine_s16(vqmovn_s32(apply(vget_low_u16(high))), vqmovn_s32(apply(vget_high_u16(high))));
+        return vcombine_u8(vqmovun_s16(s0), vqmovun_s16(s1));
+    }
+    uint8x16x3_t operator()(const uint8x16x3_t &bgr) const {
+        return uint8x16x3_t{{apply(bgr.val[0]), apply(bgr.val[1]), apply(bgr.val[2])}};
+    }
+};
+template <typename Op>
+void neonRow(const uchar *src, uchar *rgb, uchar *bgr, int pixels, const Params &params) {
+    const Op op(params);
+    int i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        const uint8x16x3_t out = op(vld3q_u8(src + i * 3)); // Canaux B, G, R de 16 pixels.
+        vst3q_u8(rgb + i * 3, uint8x16x3_t{{out.val[2], out.val[1], out.val[0]}});
+        if (bgr) {
+            vst3q_u8(bgr + i * 3, out);
+        }
+    }
+    scalarRow<typename Op::Pixel>(src + i * 3, rgb + i * 3, bgr ? bgr + i * 3 : nullptr, pixels - i, params);
+}
+#endif // PIXELKERNELS_NEON
+// Opérations, dans l'ordre des colonnes de la table des noyaux
+enum Operation { SwapOp, InvertOp, GrayOp, SepiaOp, ScaleOp, OperationCount };
+// Noyau d'une opération pour un jeu d'instructions (nullptr si non compilé)
+RowKernel kernelFor(PixelKernels::Isa isa, Operation operation) {
+    static const RowKernel kernels[PixelKernels::IsaCount][OperationCount] = {
+        {scalarRow<SwapPixel>, scalarRow<InvertPixel>, scalarRow<GrayPixel>, scalarRow<SepiaPixel>, scalarRow<ScalePixel>},
+#ifdef PIXELKERNELS_X86
+        {ssse3Row<SwapSsse3>, ssse3Row<InvertSsse3>, ssse3Row<GraySsse3>, ssse3Row<SepiaSsse3>, ssse3Row<ScaleSsse3>},
+        {avx2Row<SwapAvx2>, avx2Row<InvertAvx2>, avx2Row<GrayAvx2>, avx2Row<SepiaAvx2>, avx2Row<ScaleAvx2>},
+#else
+        {nullptr, nullptr, nullptr, nullptr, nullptr},
+        {nullptr, nullptr, nullptr, nullptr, nullptr},
+#endif
+#ifdef PIXELKERNELS_NEON
+        {neonRow<SwapNeon>, neonRow<InvertNeon>, neonRow<GrayNeon>, neonRow<SepiaNeon>, neonRow<ScaleNeon>},
+#else
+        {nullptr, nullptr, nullptr, nullptr, nullptr},
+#endif
+    };
+    return kernels[isa][operation];
+}
+// Meilleur jeu d'instructions pris en charge par le processeur
+PixelKernels::Isa detectIsa() {
+    for (int isa = PixelKernels::IsaCount - 1; isa > PixelKernels::Scalar; --isa) {
+        if (PixelKernels::isSupported(static_cast<PixelKernels::Isa>(isa))) {
+            return static_cast<PixelKernels::Isa>(isa);
+        }
+    }
+    return PixelKernels::Scalar;
+}
+std::atomic<int> &currentIsa() {
+    static std::atomic<int> isa(detectIsa()); // Détection au premier usage.
+    return isa;
+}
+// Exécute une opération ligne par ligne (une seule fois sur toute l'image si elle est continue)
+bool run(Operation operation, const cv::Mat &src, cv::Mat &rgb, cv::Mat *bgr, const Params &params) {
+    if (src.type() != CV_8UC3) {
+        return false;
+    }
+    rgb.create(src.rows, src.cols, CV_8UC3); // Sans effet si le tampon fourni convient déjà.
+    if (bgr) {
+        bgr->create(src.rows, src.cols, CV_8UC3); // Sans effet si bgr est la source (sur place).
+    }
+    const RowKernel kernel = kernelFor(PixelKernels::isa(), operation);
+    const bool continuous = src.isContinuous() && rgb.isContinuous() && (!bgr || bgr->isContinuous());
+    const int rows = continuous ? 1 : src.rows;
+    const int pixels = continuous ? src.rows * src.cols : src.cols;
+    for (int y = 0; y < rows; ++y) {
+        kernel(src.ptr<uchar>(y), rgb.ptr<uchar>(y), bgr ? bgr->ptr<uchar>(y) : nullptr, pixels, params);
+    }
+    return true;
+}
+} // namespace
+PixelKernels::Isa PixelKernels::isa() {
+    return static_cast<Isa>(currentIsa().load(std::memory_order_relaxed));
+}
+bool PixelKernels::setIsa(Isa isa) {
+    if (!isSupported(isa)) {
+        return false;
+    }
+    currentIsa().store(isa, std::memory_order_relaxed);
+    return true;
+}
+// Le jeu doit être compilé (architecture) et pris en charge par le processeur (détection d'OpenCV, qui respecte OPENCV_CPU_DISABLE)
+bool PixelKernels::isSupported(Isa isa) {
+    switch (isa) {
+    case Scalar:
+        return true;
+#ifdef PIXELKERNELS_X86
+    case Ssse3:
+        return cv::checkHardwareSupport(CV_CPU_SSSE3);
+    case Avx2:
+        return cv::checkHardwareSupport(CV_CPU_AVX2);
+#endif
+#ifdef PIXELKERNELS_NEON
+    case Neon:
+        return true; // NEON fait partie d'AArch64.
+#endif
+    default:
+        return false;
+    }
+}
+const char *PixelKernels::name(Isa isa) {
+    static const char *const names[IsaCount] = {"scalar", "ssse3", "avx2", "neon"};
+    return (isa >= 0 && isa < IsaCount) ? names[isa] : "";
+}
+bool PixelKernels::bgrToRgb(const cv::Mat &src, cv::Mat &rgb) {
+    return run(SwapOp, src, rgb, nullptr, Params());
+}
+bool PixelKernels::invert(const cv::Mat &src, cv::Mat &rgb, cv::Mat *bgr) {
+    return run(InvertOp, src, rgb, bgr, Params());
+}
+bool PixelKernels::gray(const cv::Mat &src, cv::Mat &rgb, cv::Mat *bgr) {
+    return run(GrayOp, src, rgb, bgr, Params());
+}
+bool PixelKernels::sepia(const cv::Mat &src, cv::Mat &rgb, cv::Mat *bgr) {
+    return run(SepiaOp, src, rgb, bgr, Params());
+}
+bool PixelKernels::scale(const cv::Mat &src, float alpha, float beta, cv::Mat &rgb, cv::Mat *bgr) {
+    Params params;
+    params.alpha = alpha;
+    params.beta = beta;
+    for (int value = 0; value < 256; ++value) {
+        const float product = static_cast<float>(value) * alpha; // Même suite d'opérations que les versions vectorielles.
+        const long rounded = std::lrint(product + beta);
+        params.lut[value] = static_cast<uchar>(std::min(255L, std::max(0L, rounded)));
+    }
+    return run(ScaleOp, src, rgb, bgr, params);
+}
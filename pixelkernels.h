@@ -0,0 +1,25 @@
+#ifndef PIXELKERNELS_H
+#define PIXELKERNELS_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat pour les images.
+// Filtres pixel à pixel fusionnés avec la conversion d'affichage BGR -> RGB : chaque fonction lit l'image BGR
+// une seule fois et écrit directement l'image RGB affichable, plus (si bgr est fourni) le résultat BGR destiné à
+// l'enregistrement, éventuellement sur place dans la source. Versions SSSE3, AVX2 et NEON écrites à la main et
+// version scalaire de secours ; le jeu d'instructions est choisi à l'exécution d'après le processeur.
+// Les versions vectorielles et scalaire calculent exactement les mêmes valeurs (mêmes formules entières).
+class PixelKernels {
+public:
+    enum Isa { Scalar = 0, Ssse3, Avx2, Neon, IsaCount }; // Jeux d'instructions.
+    static Isa isa(); // Jeu utilisé : le meilleur pris en charge, sauf choix forcé par setIsa().
+    static bool setIsa(Isa isa); // Force un jeu d'instructions (mesures) ; false s'il n'est pas pris en charge.
+    static bool isSupported(Isa isa); // Vrai si le jeu est compilé et pris en charge par le processeur.
+    static const char *name(Isa isa); // "scalar", "ssse3", "avx2", "neon".
+    // src est en BGR 8 bits (CV_8UC3), rgb est (ré)allouée à sa taille ; bgr peut désigner src (sur place).
+    // Renvoient false (sans rien écrire) si src n'est pas en CV_8UC3.
+    static bool bgrToRgb(const cv::Mat &src, cv::Mat &rgb); // Échange des canaux B et R.
+    static bool invert(const cv::Mat &src, cv::Mat &rgb, cv::Mat *bgr = nullptr); // 255 - valeur.
+    static bool gray(const cv::Mat &src, cv::Mat &rgb, cv::Mat *bgr = nullptr); // Luminance de cv::cvtColor (au bit près), recopiée sur les trois canaux.
+    static bool sepia(const cv::Mat &src, cv::Mat &rgb, cv::Mat *bgr = nullptr); // Matrice sépia en virgule fixe (coefficients sur 14 bits).
+    static bool scale(const cv::Mat &src, float alpha, float beta, cv::Mat &rgb, cv::Mat *bgr = nullptr); // alpha * valeur + beta, arrondi et saturé.
+};
+#endif // PIXELKERNELS_H
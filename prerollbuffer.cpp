@@ -0,0 +1,227 @@
+#include "prerollbuffer.h" // Déclaration de la classe PrerollBuffer.
+#include <opencv2/imgcodecs.hpp> // imencode / imdecode.
+#include <algorithm> // std::max.
+#include <chrono> // Horloge des horodatages de capture.
+#include <climits> // INT_MAX.
+#include <cstring> // std::memcpy.
+static const size_t pendingCapacity = 4; // Frames en attente d'encodage au-delà desquelles la plus ancienne est perdue.
+static const int flushBatch = 4; // Frames mémorisées écrites par frame reçue : rattrape la pré-capture à 4x le temps réel.
+// Heure courante sur l'horloge des horodatages de capture (CaptureEngine)
+static int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+// Constructeur : lance le thread d'encodage (l'anneau est alloué au premier passage)
+PrerollBuffer::PrerollBuffer() {
+    m_thread = std::thread(&PrerollBuffer::encodeLoop, this);
+}
+// Destructeur : termine le fichier d'événement en cours
+PrerollBuffer::~PrerollBuffer() {
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeUp.notify_all();
+    m_thread.join();
+}
+void PrerollBuffer::setPrerollSeconds(int seconds) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_prerollSeconds = std::max(0, seconds);
+}
+void PrerollBuffer::setPostrollSeconds(int seconds) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_postrollSeconds = std::max(0, seconds);
+}
+void PrerollBuffer::setMemoryBudget(size_t bytes) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_budget = std::max<size_t>(bytes, 1024 * 1024);
+}
+void PrerollBuffer::setQuality(int quality) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_quality = std::min(100, std::max(10, quality));
+}
+void PrerollBuffer::setMetrics(PipelineMetrics *metrics) {
+    m_metrics = metrics;
+    m_recorder.setMetrics(metrics); // Pris en compte au prochain événement.
+}
+// Confie une copie de la frame au thread d'encodage
+void PrerollBuffer::push(const cv::Mat &frame, int64_t timestampNs) {
+    if (frame.empty()) {
+        return;
+    }
+    Pending pending;
+    pending.frame = m_pool.acquire(frame.rows, frame.cols, frame.type());
+    frame.copyTo(pending.frame);
+    pending.timestampNs = timestampNs;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        if (m_pending.size() >= pendingCapacity) {
+            m_pending.pop_front(); // Encodeur en retard : la capture n'attend pas.
+            ++m_stats.droppedFrames;
+        }
+        m_pending.push_back(std::move(pending));
+    }
+    m_wakeUp.notify_one();
+}
+// Déclenche l'écriture d'un événement (ou prolonge celui en cours)
+bool PrerollBuffer::trigger(const QString &path, double fpsHint) {
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        const int64_t until = nowNs() + static_cast<int64_t>(m_postrollSeconds) * 1000000000;
+        if (m_flushing) {
+            m_flushUntilNs = std::max(m_flushUntilNs, until); // Nouvel événement pendant l'écriture : post-capture prolongée.
+            return true;
+        }
+        m_flushing = true; // m_flushStarted est déjà faux : remis à zéro à la fin de l'événement précédent.
+        m_flushPath = path;
+        m_flushFpsHint = fpsHint;
+        m_flushUntilNs = until;
+        m_stats.flushing = true;
+    }
+    m_wakeUp.notify_one();
+    return true;
+}
+PrerollBuffer::Stats PrerollBuffer::stats() const {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_stats;
+}
+// Vrai si des frames mémorisées attendent d'être écrites (thread d'encodage uniquement)
+bool PrerollBuffer::flushBacklog() const {
+    return m_flushStarted && !m_entries.empty() && m_flushCursor <= m_entries.back().sequence;
+}
+// Ajoute un JPEG à l'anneau en évinçant les frames dont il écrase la place
+void PrerollBuffer::append(const std::vector<uchar> &jpeg, int64_t timestampNs) {
+    const size_t size = jpeg.size();
+    if (size > m_arena.size()) {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        ++m_stats.droppedFrames; // Frame plus grande que l'anneau entier.
+        return;
+    }
+    size_t position = m_head;
+    if (position + size > m_arena.size()) {
+        // Retour au début : les frames du tour précédent situées après m_head sont les plus anciennes
+        while (!m_entries.empty() && m_entries.front().offset >= m_head) {
+            m_entries.pop_front();
+        }
+        position = 0;
+    }
+    while (!m_entries.empty() && m_entries.front().offset < position + size
+           && m_entries.front().offset + m_entries.front().size > position) {
+        m_entries.pop_front(); // Place écrasée par la nouvelle frame.
+    }
+    std::memcpy(m_arena.data() + position, jpeg.data(), size);
+    m_entries.push_back(Entry{position, size, timestampNs, m_nextSequence++});
+    m_head = position + size;
+}
+// Écrit jusqu'à count frames mémorisées dans le fichier d'événement ; termine l'événement après la post-capture
+void PrerollBuffer::flushSome(int count) {
+    int64_t until;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        until = m_flushUntilNs;
+    }
+    for (int i = 0; i < count && !m_entries.empty(); ++i) {
+        if (m_flushCursor < m_entries.front().sequence) {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_stats.droppedFrames += m_entries.front().sequence - m_flushCursor; // Anneau plus rapide que l'écriture.
+            m_flushCursor = m_entries.front().sequence;
+        }
+        const size_t index = static_cast<size_t>(m_flushCursor - m_entries.front().sequence);
+        if (index >= m_entries.size()) {
+            return; // Tout est écrit : attend les frames suivantes.
+        }
+        const Entry &entry = m_entries[index];
+        if (entry.timestampNs > until) {
+            m_recorder.stop(); // Post-capture terminée : encode la fin et ferme le fichier.
+            std::lock_guard<std::mutex> locker(m_mutex);
+            qCDebug(lcPipeline) << "Événement enregistré :" << m_flushPath;
+            m_stats.lastFile = m_flushPath;
+            m_stats.flushing = false;
+            m_flushing = false;
+            m_flushStarted = false;
+            return;
+        }
+        const cv::Mat encoded(1, static_cast<int>(entry.size), CV_8UC1, m_arena.data() + entry.offset); // Sans copie.
+        cv::imdecode(encoded, cv::IMREAD_COLOR, &m_decoded);
+        m_recorder.push(m_decoded, entry.timestampNs); // Politique Block : aucune frame de l'événement n'est perdue.
+        ++m_flushCursor;
+    }
+}
+// Boucle du thread d'encodage : encode les frames reçues, écrit les événements
+void PrerollBuffer::encodeLoop() {
+    for (;;) {
+        Pending pending;
+        bool startFlush = false;
+        bool stopping;
+        QString path;
+        double fpsHint = 0.0;
+        size_t budget;
+        int quality;
+        int64_t prerollNs;
+        {
+            std::unique_lock<std::mutex> locker(m_mutex);
+            m_wakeUp.wait(locker, [this]() {
+                return m_stopping || !m_pending.empty() || (m_flushing && !m_flushStarted) || flushBacklog();
+            });
+            stopping = m_stopping;
+            if (!m_pending.empty()) {
+                pending = std::move(m_pending.front());
+                m_pending.pop_front();
+            }
+            if (m_flushing && !m_flushStarted) {
+                startFlush = true;
+                m_flushStarted = true;
+                path = m_flushPath;
+                fpsHint = m_flushFpsHint;
+            }
+            budget = m_budget;
+            quality = m_quality;
+            prerollNs = static_cast<int64_t>(m_prerollSeconds) * 1000000000;
+        }
+        if (m_arena.size() != budget) {
+            m_arena.assign(budget, 0); // Allocation unique (ou changement de taille demandé) : l'anneau repart vide.
+            m_entries.clear();
+            m_head = 0;
+        }
+        if (startFlush) {
+            m_recorder.setPolicy(Recorder::Policy::Block);
+            if (m_recorder.start(path, fpsHint)) {
+                m_flushCursor = m_entries.empty() ? m_nextSequence : m_entries.front().sequence; // Toute la pré-capture.
+            } else {
+                std::lock_guard<std::mutex> locker(m_mutex);
+                m_flushing = false;
+                m_flushStarted = false;
+                m_stats.flushing = false;
+            }
+        }
+        if (!pending.frame.empty()) {
+            {
+                PipelineMetrics::ScopedTimer timer(m_metrics.load(std::memory_order_relaxed), PipelineMetrics::Encode);
+                cv::imencode(".jpg", pending.frame, m_jpeg, {cv::IMWRITE_JPEG_QUALITY, quality});
+            }
+            pending.frame.release(); // Rend la copie au pool.
+            append(m_jpeg, pending.timestampNs);
+            // Oublie ce qui dépasse la durée de pré-capture (sauf les frames pas encore écrites d'un événement)
+            while (m_entries.size() > 1 && m_entries.back().timestampNs - m_entries.front().timestampNs > prerollNs
+                   && !(m_flushStarted && m_entries.front().sequence >= m_flushCursor)) {
+                m_entries.pop_front();
+            }
+        }
+        if (m_flushStarted) {
+            flushSome(stopping ? INT_MAX : flushBatch);
+        }
+        size_t bytes = 0;
+        for (const Entry &entry : m_entries) {
+            bytes += entry.size;
+        }
+        {
+            std::lock_guard<std::mutex> locker(m_mutex);
+            m_stats.bytesUsed = bytes;
+            m_stats.framesBuffered = static_cast<int>(m_entries.size());
+            m_stats.bufferedSeconds = m_entries.size() > 1 ? (m_entries.back().timestampNs - m_entries.front().timestampNs) / 1e9 : 0.0;
+            if (stopping && m_pending.empty()) {
+                break;
+            }
+        }
+    }
+    m_recorder.stop(); // Événement interrompu par l'arrêt : le fichier contient ce qui a été écrit.
+}
@@ -0,0 +1,86 @@
+#ifndef PREROLLBUFFER_H
+#define PREROLLBUFFER_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat pour les frames.
+#include "bufferpool.h" // Copies des frames en attente d'encodage.
+#include "recorder.h" // Écriture du fichier d'événement.
+#include <QString> // Chemin du fichier d'événement.
+#include <atomic> // Mesures réglées depuis un autre thread.
+#include <condition_variable> // Réveil du thread d'encodage.
+#include <cstdint> // Horodatages et compteurs.
+#include <deque> // Frames en attente et index de l'anneau.
+#include <mutex> // Échanges avec le thread d'encodage.
+#include <thread> // Thread d'encodage.
+#include <vector> // Zone mémoire de l'anneau.
+// Pré-enregistrement en mémoire : les dernières secondes de frames sont conservées en JPEG dans un anneau
+// d'octets de taille fixe (mémoire bornée quelle que soit la durée). Un déclenchement (visage, capture d'image...)
+// écrit dans un fichier les secondes mémorisées puis les secondes suivantes, via un Recorder, sans interrompre
+// la capture. Sans événement, rien n'est écrit sur le disque.
+class PrerollBuffer {
+public:
+    // Mesures exposées à l'interface
+    struct Stats {
+        size_t bytesUsed = 0; // Octets occupés dans l'anneau.
+        int framesBuffered = 0; // Frames mémorisées.
+        double bufferedSeconds = 0.0; // Durée couverte par les frames mémorisées.
+        uint64_t droppedFrames = 0; // Frames perdues (encodeur en retard ou anneau rattrapé pendant une écriture).
+        bool flushing = false; // Un fichier d'événement est en cours d'écriture.
+        QString lastFile; // Dernier fichier d'événement.
+    };
+    PrerollBuffer();
+    ~PrerollBuffer(); // Termine l'écriture en cours et arrête le thread.
+    void setPrerollSeconds(int seconds); // Secondes conservées avant un événement.
+    void setPostrollSeconds(int seconds); // Secondes écrites après un événement.
+    void setMemoryBudget(size_t bytes); // Taille de l'anneau (vide l'anneau).
+    void setQuality(int quality); // Qualité JPEG (compromis mémoire / fidélité).
+    void setMetrics(PipelineMetrics *metrics); // Mesures de l'étape "encode" (compression JPEG et fichier d'événement).
+    void push(const cv::Mat &frame, int64_t timestampNs); // Confie une frame au thread d'encodage (ne bloque pas).
+    bool trigger(const QString &path, double fpsHint); // Écrit la pré-capture et la post-capture dans path ; prolonge l'écriture en cours.
+    Stats stats() const;
+private:
+    // Frame encodée dans l'anneau
+    struct Entry {
+        size_t offset; // Position dans m_arena.
+        size_t size; // Taille du JPEG.
+        int64_t timestampNs; // Horodatage de capture.
+        uint64_t sequence; // Numéro d'ordre (curseur d'écriture du fichier).
+    };
+    // Frame en attente d'encodage
+    struct Pending {
+        cv::Mat frame;
+        int64_t timestampNs;
+    };
+    void encodeLoop(); // Boucle du thread d'encodage.
+    void append(const std::vector<uchar> &jpeg, int64_t timestampNs); // Ajoute une frame encodée (évince les plus anciennes).
+    void flushSome(int count); // Décode et transmet au Recorder jusqu'à count frames mémorisées.
+    bool flushBacklog() const; // Vrai si des frames mémorisées attendent d'être écrites.
+    // Réglages
+    int m_prerollSeconds = 10;
+    int m_postrollSeconds = 10;
+    int m_quality = 80;
+    size_t m_budget = 64 * 1024 * 1024; // Taille demandée pour l'anneau (appliquée par le thread d'encodage).
+    std::atomic<PipelineMetrics *> m_metrics{nullptr}; // Mesures (facultatives).
+    // État partagé (protégé par m_mutex)
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeUp; // Frame en attente, déclenchement ou arrêt.
+    std::deque<Pending> m_pending; // Frames à encoder (quelques-unes au plus).
+    bool m_stopping = false;
+    bool m_flushing = false; // Écriture d'un fichier d'événement en cours.
+    bool m_flushStarted = false; // Vrai une fois le Recorder démarré pour l'événement en cours.
+    QString m_flushPath; // Fichier de l'événement en cours.
+    double m_flushFpsHint = 30.0;
+    int64_t m_flushUntilNs = 0; // Fin de la post-capture.
+    Stats m_stats;
+    // Anneau (utilisé seulement par le thread d'encodage)
+    std::vector<uchar> m_arena; // Zone mémoire de taille fixe.
+    std::deque<Entry> m_entries; // Frames mémorisées, de la plus ancienne à la plus récente.
+    size_t m_head = 0; // Prochaine position d'écriture.
+    uint64_t m_nextSequence = 0; // Numéro de la prochaine frame mémorisée.
+    uint64_t m_flushCursor = 0; // Numéro de la prochaine frame à écrire dans le fichier.
+    std::vector<uchar> m_jpeg; // Tampon d'encodage (réutilisé).
+    cv::Mat m_decoded; // Tampon de décodage (réutilisé).
+    BufferPool m_pool; // Copies des frames en attente.
+    Recorder m_recorder; // Écriture du fichier d'événement.
+    std::thread m_thread; // Thread d'encodage (dernier membre : démarré quand tout le reste est construit).
+};
+#endif // PREROLLBUFFER_H
@@ -0,0 +1,97 @@
+#include "qualitygovernor.h" // Déclaration de la classe QualityGovernor.
+#include <algorithm> // std::min, std::max.
+static const double smoothing = 0.1; // Poids d'une nouvelle mesure dans la moyenne lissée.
+static const double degradeLoad = 0.9; // Dégradation au-dessus de cette part de l'échéance...
+static const int degradeFrames = 5; // ... pendant autant de frames consécutives.
+static const double recoverLoad = 0.6; // Rétablissement sous cette part de l'échéance...
+static const int baseRecoveryFrames = 30; // ... pendant autant de frames (doublé après un échec, jusqu'à maxRecoveryFrames).
+static const int maxRecoveryFrames = 480;
+static const int settleFrames = 10; // Frames laissées à la moyenne pour refléter un nouveau palier.
+static const int probeFrames = 60; // Un rétablissement est confirmé s'il tient autant de frames.
+void QualityGovernor::setEnabled(bool enabled) {
+    if (enabled != m_enabled) {
+        m_enabled = enabled;
+        reset();
+    }
+}
+bool QualityGovernor::isEnabled() const {
+    return m_enabled;
+}
+void QualityGovernor::setFrameInterval(int64_t intervalNs) {
+    m_intervalNs = std::max<int64_t>(1, intervalNs);
+}
+int64_t QualityGovernor::frameInterval() const {
+    return m_intervalNs;
+}
+QualityGovernor::Level QualityGovernor::level() const {
+    return static_cast<Level>(m_level);
+}
+QualityGovernor::Settings QualityGovernor::settings() const {
+    return settingsFor(level());
+}
+double QualityGovernor::load() const {
+    return m_averageNs / m_intervalNs;
+}
+void QualityGovernor::reset() {
+    m_averageNs = 0.0;
+    m_level = Full;
+    m_framesSinceChange = 0;
+    m_overBudget = 0;
+    m_underBudget = 0;
+    m_recoveryFrames = 0;
+    m_probing = false;
+}
+// Réglages cumulés : chaque palier garde les économies des précédents
+QualityGovernor::Settings QualityGovernor::settingsFor(Level level) {
+    Settings settings;
+    if (level >= FewerDetections) {
+        settings.detectionIntervalFactor = 3;
+    }
+    if (level >= LightFilters) {
+        settings.lightFilters = true;
+    }
+    if (level >= ReducedResolution) {
+        settings.processingScale = level >= HalfResolution ? 0.5 : 0.75;
+    }
+    return settings;
+}
+const char *QualityGovernor::name(Level level) {
+    static const char *const names[LevelCount] = {"full", "fewer-detections", "light-filters", "reduced-resolution", "half-resolution"};
+    return (level >= 0 && level < LevelCount) ? names[level] : "";
+}
+// Ajoute une mesure et décide d'un éventuel changement de palier
+bool QualityGovernor::frameProcessed(int64_t processingNs) {
+    if (!m_enabled) {
+        return false;
+    }
+    m_averageNs = m_averageNs > 0.0 ? m_averageNs + smoothing * (processingNs - m_averageNs) : static_cast<double>(processingNs);
+    ++m_framesSinceChange;
+    const double ratio = load();
+    m_overBudget = ratio > degradeLoad ? m_overBudget + 1 : 0;
+    m_underBudget = ratio < recoverLoad ? m_underBudget + 1 : 0;
+    if (m_probing && m_framesSinceChange >= probeFrames) {
+        m_probing = false; // Le palier rétabli tient la cadence.
+        m_recoveryFrames = 0;
+    }
+    if (m_overBudget >= degradeFrames && m_framesSinceChange >= settleFrames && m_level < LevelCount - 1) {
+        if (m_probing) {
+            // Le rétablissement n'a pas tenu : attendre plus longtemps avant le prochain essai
+            m_recoveryFrames = std::min(maxRecoveryFrames, std::max(baseRecoveryFrames, m_recoveryFrames) * 2);
+            m_probing = false;
+        }
+        changeLevel(m_level + 1);
+        return true;
+    }
+    if (m_underBudget >= std::max(baseRecoveryFrames, m_recoveryFrames) && m_level > Full) {
+        changeLevel(m_level - 1);
+        m_probing = true;
+        return true;
+    }
+    return false;
+}
+void QualityGovernor::changeLevel(int level) {
+    m_level = level;
+    m_framesSinceChange = 0;
+    m_overBudget = 0;
+    m_underBudget = 0;
+}
@@ -0,0 +1,44 @@
+#ifndef QUALITYGOVERNOR_H
+#define QUALITYGOVERNOR_H
+// Inclusion des bibliothèques nécessaires
+#include <cstdint> // Durées en nanosecondes.
+// Régulateur de qualité : compare la durée de traitement de chaque frame (moyenne lissée) à l'échéance d'une frame
+// et dégrade la qualité par paliers quand le traitement ne tient plus la cadence, puis la rétablit quand la marge revient.
+// Les paliers vont du moins visible au plus visible : détections de visages plus espacées, paramètres de filtres
+// plus légers, traitement à 75 % puis 50 % de la résolution (l'image est agrandie ensuite).
+// Hystérésis : dégradation au-dessus de 90 % de l'échéance, rétablissement sous 60 % maintenu pendant un délai
+// qui double à chaque rétablissement aussitôt annulé (pas d'oscillation entre deux paliers).
+// Utilisé par le seul thread de traitement (sauf setEnabled/setFrameInterval, appelés sous le même verrou).
+class QualityGovernor {
+public:
+    enum Level { Full = 0, FewerDetections, LightFilters, ReducedResolution, HalfResolution, LevelCount }; // Paliers.
+    // Réglages d'un palier
+    struct Settings {
+        int detectionIntervalFactor = 1; // Multiplie l'intervalle entre deux détections de visages.
+        bool lightFilters = false; // Noyaux plus petits pour les filtres coûteux.
+        double processingScale = 1.0; // Échelle de l'image traitée.
+    };
+    void setEnabled(bool enabled); // Désactivé : palier Full en permanence.
+    bool isEnabled() const;
+    void setFrameInterval(int64_t intervalNs); // Échéance d'une frame (1 / FPS visé).
+    int64_t frameInterval() const;
+    bool frameProcessed(int64_t processingNs); // Durée de traitement d'une frame ; vrai si le palier a changé.
+    Level level() const; // Palier courant.
+    Settings settings() const; // Réglages du palier courant.
+    double load() const; // Durée de traitement lissée / échéance.
+    void reset(); // Retour au palier Full (nouvelle source).
+    static Settings settingsFor(Level level); // Réglages d'un palier.
+    static const char *name(Level level); // Nom d'un palier ("full", "fewer-detections"...).
+private:
+    void changeLevel(int level); // Passe à un autre palier.
+    bool m_enabled = true; // Régulation active.
+    int64_t m_intervalNs = 33333333; // Échéance d'une frame (30 FPS par défaut).
+    double m_averageNs = 0.0; // Durée de traitement lissée.
+    int m_level = Full; // Palier courant.
+    int m_framesSinceChange = 0; // Frames traitées depuis le dernier changement de palier.
+    int m_overBudget = 0; // Frames consécutives au-dessus du seuil de dégradation.
+    int m_underBudget = 0; // Frames consécutives sous le seuil de rétablissement.
+    int m_recoveryFrames = 0; // Frames de marge exigées avant de remonter d'un palier (0 = valeur de base).
+    bool m_probing = false; // Vrai juste après un rétablissement (une dégradation rapide l'annule).
+};
+#endif // QUALITYGOVERNOR_H
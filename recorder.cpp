@@ -0,0 +1,207 @@
+#include "recorder.h" // Déclaration de la classe Recorder.
+#include <opencv2/imgproc.hpp> // cvtColor (frames en niveaux de gris).
+#include <QDebug> // Messages d'erreur.
+#include <QDir> // Dossier des segments.
+#include <QFileInfo> // Nom et taille des segments.
+#include <algorithm> // std::max, std::min.
+static const int calibrationFrames = 10; // Frames observées avant d'ouvrir le premier segment (mesure de la cadence).
+static const int sizeCheckInterval = 15; // Contrôle de la taille du segment toutes les N frames (appel système).
+// Cadence mesurée sur les horodatages de capture de frames consécutives ; 0 si non mesurable
+static double measuredFps(int frames, int64_t firstNs, int64_t lastNs) {
+    return (frames > 1 && lastNs > firstNs) ? (frames - 1) * 1e9 / (lastNs - firstNs) : 0.0;
+}
+// Constructeur : aucun enregistrement en cours
+Recorder::Recorder() {
+    m_settings.fourcc = cv::VideoWriter::fourcc('M', 'J', 'P', 'G');
+}
+// Destructeur : vide la file et ferme le fichier
+Recorder::~Recorder() {
+    stop();
+}
+void Recorder::setPolicy(Policy policy) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_settings.policy = policy;
+}
+void Recorder::setQueueCapacity(int frames) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_settings.capacity = std::max(1, frames);
+}
+void Recorder::setSegmentDuration(int seconds) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_settings.segmentSeconds = std::max(0, seconds);
+}
+void Recorder::setSegmentSize(qint64 bytes) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_settings.segmentBytes = std::max<qint64>(0, bytes);
+}
+void Recorder::setFourcc(int fourcc) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_settings.fourcc = fourcc;
+}
+void Recorder::setMetrics(PipelineMetrics *metrics) {
+    m_metrics = metrics;
+}
+// Démarre un enregistrement : le premier segment est ouvert par le thread d'encodage dès que la cadence est connue
+bool Recorder::start(const QString &path, double fpsHint) {
+    stop();
+    const QFileInfo info(path);
+    if (!info.absoluteDir().exists()) {
+        qWarning() << "Erreur : Dossier de sortie introuvable :" << info.absolutePath();
+        return false;
+    }
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_path = info.absoluteFilePath();
+    m_fpsHint = fpsHint > 0 ? fpsHint : 30.0;
+    m_session = m_settings; // Figés pour tout l'enregistrement (le thread d'encodage n'existe pas encore).
+    m_stats = Stats();
+    m_queue.clear();
+    m_running = true;
+    m_stopping = false;
+    m_thread = std::thread(&Recorder::encodeLoop, this);
+    return true;
+}
+// Termine l'enregistrement : les frames déjà en file sont encodées
+void Recorder::stop() {
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        if (!m_running) {
+            return;
+        }
+        m_stopping = true;
+    }
+    m_queueChanged.notify_all();
+    m_thread.join();
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_running = false;
+    m_stopping = false;
+}
+bool Recorder::isRecording() const {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_running && !m_stopping;
+}
+// Dépose une copie de la frame dans la file (appelé par le pipeline, ne bloque qu'avec la politique Block)
+bool Recorder::push(const cv::Mat &frame, int64_t timestampNs) {
+    if (frame.empty() || !isRecording()) {
+        return false;
+    }
+    Item item;
+    item.frame = m_pool.acquire(frame.rows, frame.cols, frame.type()); // Copie : le pipeline réutilise son tampon.
+    frame.copyTo(item.frame);
+    item.timestampNs = timestampNs;
+    std::unique_lock<std::mutex> locker(m_mutex);
+    if (static_cast<int>(m_queue.size()) >= m_session.capacity) {
+        if (m_session.policy == Policy::Block) {
+            m_queueChanged.wait(locker, [this]() { return m_stopping || static_cast<int>(m_queue.size()) < m_session.capacity; });
+            if (m_stopping) {
+                return false;
+            }
+        } else {
+            m_queue.pop_front(); // DropOldest : la frame la plus ancienne cède sa place.
+            ++m_stats.droppedFrames;
+        }
+    }
+    item.queuedAt = std::chrono::steady_clock::now();
+    m_queue.push_back(std::move(item));
+    m_stats.queueDepth = static_cast<int>(m_queue.size());
+    locker.unlock();
+    m_queueChanged.notify_all();
+    return true;
+}
+Recorder::Stats Recorder::stats() const {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_stats;
+}
+// Nom d'un segment : le chemin demandé tel quel sans découpage, sinon "base_000.ext", "base_001.ext"...
+QString Recorder::segmentPath(int index) const {
+    if (index == 0 && m_session.segmentSeconds == 0 && m_session.segmentBytes == 0) {
+        return m_path;
+    }
+    const QFileInfo info(m_path);
+    return info.absoluteDir().filePath(QStringLiteral("%1_%2.%3").arg(info.completeBaseName()).arg(index, 3, 10, QChar('0')).arg(info.suffix()));
+}
+// Ouvre le segment suivant à la cadence donnée
+bool Recorder::openSegment(const cv::Size &size, double fps) {
+    int index;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        index = m_stats.writtenFrames > 0 ? m_stats.segmentIndex + 1 : 0;
+    }
+    const QString file = segmentPath(index);
+    if (!m_writer.open(file.toStdString(), m_session.fourcc, fps, size, true)) {
+        static LogRateLimiter limiter; // Nouvel essai à chaque frame : un dossier ou un codec indisponible inonderait le journal.
+        uint64_t skipped = 0;
+        if (limiter.allow(&skipped)) {
+            qCWarning(lcPipeline) << "Erreur : Impossible d'ouvrir le fichier vidéo pour l'écriture !" << file << "(" << skipped << "autres échecs depuis le dernier message )";
+        }
+        return false;
+    }
+    qCDebug(lcPipeline) << "Segment vidéo ouvert :" << file << "à" << fps << "FPS";
+    m_segmentSize = size;
+    m_segmentFrames = 0;
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_stats.segmentIndex = index;
+    m_stats.currentFile = file;
+    m_stats.recordedFps = fps;
+    return true;
+}
+// Vrai si le segment en cours a atteint sa durée ou sa taille maximale
+bool Recorder::segmentFull(int64_t timestampNs) {
+    if (m_session.segmentSeconds > 0 && timestampNs - m_segmentStartNs >= static_cast<int64_t>(m_session.segmentSeconds) * 1000000000) {
+        return true;
+    }
+    if (m_session.segmentBytes > 0 && m_segmentFrames % sizeCheckInterval == 0) {
+        return QFileInfo(segmentPath(m_stats.segmentIndex)).size() >= m_session.segmentBytes; // Seul ce thread change segmentIndex.
+    }
+    return false;
+}
+// Boucle du thread d'encodage
+void Recorder::encodeLoop() {
+    for (;;) {
+        Item item;
+        double fps = 0.0;
+        {
+            std::unique_lock<std::mutex> locker(m_mutex);
+            // Avant le premier segment, attend quelques frames pour mesurer la cadence réelle
+            const size_t needed = m_writer.isOpened() ? 1 : static_cast<size_t>(std::min(calibrationFrames, m_session.capacity));
+            m_queueChanged.wait(locker, [&]() { return m_stopping || m_queue.size() >= needed; });
+            if (m_queue.empty()) {
+                break; // Arrêt demandé et file vide.
+            }
+            if (!m_writer.isOpened()) {
+                fps = measuredFps(static_cast<int>(m_queue.size()), m_queue.front().timestampNs, m_queue.back().timestampNs);
+            }
+            item = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_stats.queueDepth = static_cast<int>(m_queue.size());
+        }
+        m_queueChanged.notify_all(); // Libère un producteur bloqué (politique Block).
+        cv::Mat frame = item.frame;
+        if (frame.channels() == 1) {
+            cv::cvtColor(frame, m_color, cv::COLOR_GRAY2BGR); // Sorties en gris (Canny...) : le fichier reste en couleur.
+            frame = m_color;
+        }
+        if (m_writer.isOpened() && (frame.size() != m_segmentSize || segmentFull(item.timestampNs))) {
+            // Segment suivant (limite atteinte ou changement de résolution), à la cadence mesurée sur le segment écoulé
+            fps = measuredFps(m_segmentFrames, m_segmentStartNs, m_lastTimestampNs);
+            m_writer.release();
+        }
+        if (!m_writer.isOpened()) {
+            if (!openSegment(frame.size(), fps > 0 ? fps : m_fpsHint)) {
+                continue; // Frame perdue ; nouvel essai à la suivante.
+            }
+            m_segmentStartNs = item.timestampNs;
+        }
+        {
+            PipelineMetrics::ScopedTimer timer(m_metrics.load(std::memory_order_relaxed), PipelineMetrics::Encode);
+            m_writer.write(frame);
+        }
+        ++m_segmentFrames;
+        m_lastTimestampNs = item.timestampNs;
+        const double latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - item.queuedAt).count();
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_stats.encodeLatencyMs = m_stats.writtenFrames ? 0.9 * m_stats.encodeLatencyMs + 0.1 * latencyMs : latencyMs; // Moyenne glissante.
+        ++m_stats.writtenFrames;
+    }
+    m_writer.release();
+    qCDebug(lcPipeline) << "Enregistrement terminé.";
+}
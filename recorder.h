@@ -0,0 +1,88 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat pour les frames.
+#include <opencv2/videoio.hpp> // cv::VideoWriter pour l'encodage.
+#include "bufferpool.h" // Copies des frames en file (tampons recyclés).
+#include "metrics.h" // Durée d'encodage.
+#include <QString> // Chemins des fichiers.
+#include <atomic> // Mesures réglées depuis un autre thread.
+#include <chrono> // Latence d'encodage.
+#include <condition_variable> // File bornée.
+#include <cstdint> // Horodatages et compteurs.
+#include <deque> // File des frames à encoder.
+#include <mutex> // Accès concurrents à la file.
+#include <thread> // Thread d'encodage.
+#include <vector> // Horodatages de calibration.
+// Enregistreur vidéo non bloquant : le pipeline dépose une copie de chaque frame dans une file bornée,
+// un thread dédié l'encode. La cadence du fichier est celle mesurée sur les horodatages de capture
+// (et non une valeur fixe) ; la sortie peut être découpée en segments limités en durée ou en taille.
+class Recorder {
+public:
+    enum class Policy { DropOldest, Block }; // File pleine : jeter la plus ancienne frame ou attendre l'encodeur.
+    // Mesures exposées à l'interface
+    struct Stats {
+        int queueDepth = 0; // Frames en attente d'encodage.
+        double encodeLatencyMs = 0.0; // Temps entre le dépôt d'une frame et la fin de son écriture (moyenne glissante).
+        uint64_t droppedFrames = 0; // Frames jetées par la politique DropOldest.
+        uint64_t writtenFrames = 0; // Frames écrites depuis le début de l'enregistrement.
+        double recordedFps = 0.0; // Cadence du segment en cours.
+        int segmentIndex = 0; // Numéro du segment en cours.
+        QString currentFile; // Fichier en cours d'écriture.
+    };
+    Recorder();
+    ~Recorder(); // Termine l'enregistrement en cours.
+    // Réglages (tout thread ; pris en compte au prochain start(), l'enregistrement en cours garde les siens)
+    void setPolicy(Policy policy);
+    void setQueueCapacity(int frames); // Taille maximale de la file.
+    void setSegmentDuration(int seconds); // Durée maximale d'un segment (0 = illimitée).
+    void setSegmentSize(qint64 bytes); // Taille maximale d'un segment (0 = illimitée).
+    void setFourcc(int fourcc); // Codec (MJPG par défaut).
+    void setMetrics(PipelineMetrics *metrics); // Mesures de l'étape "encode".
+    bool start(const QString &path, double fpsHint); // Démarre un enregistrement ; fpsHint sert si la cadence ne peut pas être mesurée.
+    void stop(); // Encode les frames en file puis ferme le fichier.
+    bool isRecording() const;
+    bool push(const cv::Mat &frame, int64_t timestampNs); // Dépose une frame (copiée) ; faux si elle n'a pas été retenue.
+    Stats stats() const;
+private:
+    // Frame en file
+    struct Item {
+        cv::Mat frame; // Copie de la frame (tampon du pool).
+        int64_t timestampNs = 0; // Horodatage de capture.
+        std::chrono::steady_clock::time_point queuedAt; // Heure de dépôt (latence d'encodage).
+    };
+    void encodeLoop(); // Boucle du thread d'encodage.
+    bool openSegment(const cv::Size &size, double fps); // Ouvre le segment suivant.
+    QString segmentPath(int index) const; // Nom du fichier d'un segment.
+    bool segmentFull(int64_t timestampNs); // Vrai si le segment en cours a atteint sa limite.
+    // Réglages d'un enregistrement
+    struct Settings {
+        Policy policy = Policy::DropOldest;
+        int capacity = 60; // Deux secondes à 30 fps.
+        int segmentSeconds = 0;
+        qint64 segmentBytes = 0;
+        int fourcc = 0;
+    };
+    Settings m_settings; // Prochain enregistrement (protégé par m_mutex).
+    Settings m_session; // Enregistrement en cours : copié par start(), ensuite seulement lu (file sous m_mutex, thread d'encodage).
+    std::atomic<PipelineMetrics *> m_metrics{nullptr}; // Mesures (facultatives, réglables pendant l'enregistrement).
+    // État partagé avec le thread d'encodage
+    mutable std::mutex m_mutex; // Protège la file, l'état et les mesures.
+    std::condition_variable m_queueChanged; // Frame déposée, frame retirée ou arrêt.
+    std::deque<Item> m_queue; // Frames à encoder.
+    bool m_running = false; // Enregistrement en cours.
+    bool m_stopping = false; // Arrêt demandé : vider la file puis fermer.
+    Stats m_stats;
+    BufferPool m_pool; // Tampons des copies en file.
+    std::thread m_thread; // Thread d'encodage.
+    // État propre au thread d'encodage
+    cv::VideoWriter m_writer; // Segment en cours.
+    QString m_path; // Chemin demandé (base des noms de segments).
+    double m_fpsHint = 30.0; // Cadence de secours.
+    cv::Size m_segmentSize; // Taille des frames du segment en cours.
+    int64_t m_segmentStartNs = 0; // Horodatage de la première frame du segment.
+    int64_t m_lastTimestampNs = 0; // Horodatage de la dernière frame écrite.
+    int m_segmentFrames = 0; // Frames écrites dans le segment en cours.
+    cv::Mat m_color; // Conversion gris -> BGR (VideoWriter ouvert en couleur).
+};
+#endif // RECORDER_H
@@ -0,0 +1,265 @@
+#include "sharedframes.h" // Disposition de l'anneau, segment et lecteur.
+#include <chrono> // Échéances d'attente.
+#include <thread> // Attente active courte (hors Linux).
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h> // CreateFileMapping, MapViewOfFile.
+#else
+#include <fcntl.h> // O_CREAT, O_RDWR.
+#include <sys/mman.h> // shm_open, mmap.
+#include <sys/stat.h> // fstat.
+#include <unistd.h> // ftruncate, close.
+#endif
+#if defined(__linux__)
+#include <linux/futex.h> // FUTEX_WAIT, FUTEX_WAKE.
+#include <sys/syscall.h> // SYS_futex.
+#include <climits> // INT_MAX (réveil de tous les lecteurs).
+#include <ctime> // timespec.
+#endif
+namespace SharedFrames {
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "le mot du futex doit être un entier de 32 bits");
+// ---------------------------------------------------------------------------
+// Segment
+Segment::~Segment() {
+    release();
+}
+std::string Segment::systemName(const std::string &name) {
+#if defined(_WIN32)
+    return "Local\\" + name; // Session courante.
+#else
+    return "/" + name; // Objet POSIX (visible dans /dev/shm sous Linux).
+#endif
+}
+// Crée le segment ; un segment du même nom laissé par un écrivain précédent est remplacé
+bool Segment::create(const std::string &name, size_t bytes) {
+    release();
+    const std::string systemName = Segment::systemName(name);
+#if defined(_WIN32)
+    const unsigned long long size = bytes;
+    HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32),
+                                       static_cast<DWORD>(size & 0xFFFFFFFFu), systemName.c_str());
+    if (!handle) {
+        return false;
+    }
+    void *data = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION info;
+    if (!data || VirtualQuery(data, &info, sizeof(info)) == 0 || info.RegionSize < bytes) {
+        // Mappage encore ouvert par un lecteur avec une taille plus petite : le nom ne peut pas être réutilisé
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+        CloseHandle(handle);
+        return false;
+    }
+    m_handle = handle;
+#else
+    shm_unlink(systemName.c_str()); // Les lecteurs encore attachés à l'ancien segment gardent leur mappage.
+    const int fd = shm_open(systemName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        ::close(fd);
+        shm_unlink(systemName.c_str());
+        return false;
+    }
+    void *data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd); // Le mappage reste valable sans le descripteur.
+    if (data == MAP_FAILED) {
+        shm_unlink(systemName.c_str());
+        return false;
+    }
+#endif
+    m_data = data;
+    m_size = bytes;
+    m_owner = true;
+    m_name = systemName;
+    return true;
+}
+// S'attache en lecture seule à un segment existant
+bool Segment::attach(const std::string &name) {
+    release();
+    const std::string systemName = Segment::systemName(name);
+#if defined(_WIN32)
+    HANDLE handle = OpenFileMappingA(FILE_MAP_READ, FALSE, systemName.c_str());
+    if (!handle) {
+        return false;
+    }
+    void *data = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION info;
+    if (!data || VirtualQuery(data, &info, sizeof(info)) == 0) {
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+        CloseHandle(handle);
+        return false;
+    }
+    m_handle = handle;
+    m_size = info.RegionSize;
+#else
+    const int fd = shm_open(systemName.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    void *data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+    m_data = data;
+    m_owner = false;
+    m_name = systemName;
+    return true;
+}
+void Segment::release() {
+    if (!m_data) {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(m_data);
+    CloseHandle(static_cast<HANDLE>(m_handle)); // Le mappage disparaît avec son dernier handle.
+    m_handle = nullptr;
+#else
+    munmap(m_data, m_size);
+    if (m_owner) {
+        shm_unlink(m_name.c_str()); // Plus de nouveaux lecteurs ; ceux qui sont attachés gardent leur mappage.
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_owner = false;
+}
+void *Segment::data() const {
+    return m_data;
+}
+size_t Segment::size() const {
+    return m_size;
+}
+// ---------------------------------------------------------------------------
+// Réveil : futex partagé entre processus sous Linux, attente active courte ailleurs
+void wakeAll(std::atomic<uint32_t> *word) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    (void)word; // Les lecteurs scrutent le compteur.
+#endif
+}
+bool waitChange(const std::atomic<uint32_t> *word, uint32_t seen, int timeoutMs) {
+    if (word->load(std::memory_order_acquire) != seen) {
+        return true;
+    }
+    if (timeoutMs <= 0) {
+        return false;
+    }
+#if defined(__linux__)
+    timespec timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000L;
+    // Dort seulement si le mot vaut encore seen (sinon retour immédiat) : aucun réveil perdu
+    syscall(SYS_futex, reinterpret_cast<const uint32_t *>(word), FUTEX_WAIT, seen, &timeout, nullptr, 0);
+#else
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (word->load(std::memory_order_acquire) == seen && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+#endif
+    return word->load(std::memory_order_acquire) != seen;
+}
+// ---------------------------------------------------------------------------
+// Reader
+// Case d'une séquence (les séquences commencent à 1)
+static const SlotHeader *slotOf(const Header *header, uint64_t sequence) {
+    const uint8_t *base = reinterpret_cast<const uint8_t *>(header) + header->slotOffset;
+    return reinterpret_cast<const SlotHeader *>(base + ((sequence - 1) % header->slotCount) * static_cast<size_t>(header->slotBytes));
+}
+bool Reader::open(const std::string &name) {
+    close();
+    if (!m_segment.attach(name) || m_segment.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+    const Header *header = static_cast<const Header *>(m_segment.data());
+    // L'écrivain passe l'état à Live en dernier : les autres champs sont alors complets
+    if (header->state.load(std::memory_order_acquire) != Live || header->magic != magic || header->version != version ||
+        header->slotCount == 0 || header->slotBytes <= slotHeaderBytes ||
+        header->slotOffset + static_cast<uint64_t>(header->slotCount) * header->slotBytes > m_segment.size()) {
+        close();
+        return false;
+    }
+    m_header = header;
+    m_lastSequence = 0; // La première frame rendue est la plus récente.
+    m_skipped = 0;
+    return true;
+}
+void Reader::close() {
+    m_segment.release();
+    m_header = nullptr;
+}
+bool Reader::isOpen() const {
+    return m_header != nullptr;
+}
+bool Reader::isClosedByWriter() const {
+    return m_header && m_header->state.load(std::memory_order_acquire) != Live;
+}
+// Rend la frame la plus récente si elle est plus récente que la précédente, sinon attend l'écrivain
+bool Reader::next(Frame &frame, int timeoutMs) {
+    if (!m_header) {
+        return false;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (;;) {
+        if (m_header->state.load(std::memory_order_acquire) != Live) {
+            return false; // Segment abandonné : rouvrir pour suivre l'écrivain.
+        }
+        const uint32_t wake = m_header->wakeCounter.load(std::memory_order_acquire); // Lu avant la séquence : pas de réveil perdu.
+        const uint64_t sequence = m_header->sequence.load(std::memory_order_acquire);
+        if (sequence != 0 && sequence != m_lastSequence) {
+            const SlotHeader *slot = slotOf(m_header, sequence);
+            if (slot->sequence.load(std::memory_order_acquire) == sequence) {
+                Frame candidate;
+                candidate.data = reinterpret_cast<const uint8_t *>(slot) + slotHeaderBytes;
+                candidate.width = slot->width;
+                candidate.height = slot->height;
+                candidate.type = slot->type;
+                candidate.step = slot->step;
+                candidate.timestampNs = slot->timestampNs;
+                candidate.sequence = sequence;
+                if (isValid(candidate)) { // En-tête de case lu en entier avant une éventuelle réécriture.
+                    if (m_lastSequence != 0 && sequence > m_lastSequence + 1) {
+                        m_skipped += sequence - m_lastSequence - 1;
+                    }
+                    m_lastSequence = sequence;
+                    frame = candidate;
+                    return true;
+                }
+            }
+            continue; // Case réécrite pendant la lecture : reprend la frame la plus récente.
+        }
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            return false;
+        }
+        waitChange(&m_header->wakeCounter, wake, static_cast<int>(remaining));
+    }
+}
+// Verrou de séquence : les lectures faites avant cet appel ne portaient pas sur une case en cours de réécriture
+bool Reader::isValid(const Frame &frame) const {
+    if (!m_header || frame.sequence == 0) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slotOf(m_header, frame.sequence)->sequence.load(std::memory_order_relaxed) == frame.sequence;
+}
+uint64_t Reader::skippedFrames() const {
+    return m_skipped;
+}
+}
@@ -0,0 +1,95 @@
+#ifndef SHAREDFRAMES_H
+#define SHAREDFRAMES_H
+// Inclusion des bibliothèques nécessaires
+#include <atomic> // Numéros de séquence partagés entre processus.
+#include <cstddef> // size_t.
+#include <cstdint> // Champs de taille fixe de la mémoire partagée.
+#include <string> // Nom du segment.
+// Anneau de frames brutes en mémoire partagée, pour les processus locaux (analyse, enregistrement externe...).
+// Le segment commence par un en-tête, suivi de N cases de taille fixe ; chaque case porte son propre en-tête
+// (séquence, horodatage, taille, format) puis les pixels. L'écrivain remplit les cases à tour de rôle et publie
+// la séquence de la dernière frame ; un lecteur lit les pixels sur place (aucune copie, aucun encodage) puis vérifie
+// que la case n'a pas été réécrite entre-temps (verrou de séquence). Réveil : futex sur l'en-tête sous Linux,
+// attente active courte ailleurs. Ce fichier et sharedframes.cpp ne dépendent ni de Qt ni d'OpenCV : ils servent
+// de bibliothèque de lecture de référence pour les outils externes.
+namespace SharedFrames {
+static const uint32_t magic = 0x4D435346; // "FSCM" : segment de frames de l'application.
+static const uint32_t version = 1; // Version de la disposition ci-dessous.
+enum State : uint32_t { Live = 1, Closed = 2 }; // Segment alimenté, ou abandonné par l'écrivain (le lecteur doit se rattacher).
+// En-tête du segment (offset 0)
+struct Header {
+    uint32_t magic; // SharedFrames::magic.
+    uint32_t version; // SharedFrames::version.
+    uint32_t slotCount; // Nombre de cases.
+    uint32_t slotBytes; // Taille d'une case, en-tête de case compris (multiple de 64).
+    uint64_t slotOffset; // Position de la première case.
+    std::atomic<uint32_t> state; // Live ou Closed.
+    std::atomic<uint32_t> wakeCounter; // Incrémenté à chaque frame (mot du futex).
+    std::atomic<uint64_t> sequence; // Séquence de la dernière frame publiée (0 = aucune).
+    uint64_t writerPid; // Processus écrivain.
+};
+// En-tête d'une case (suivi des pixels, alignés sur 64 octets)
+struct SlotHeader {
+    std::atomic<uint64_t> sequence; // Séquence de la frame de la case (0 pendant l'écriture).
+    int64_t timestampNs; // Horodatage de capture (horloge monotone de la machine).
+    int32_t width; // Taille en pixels.
+    int32_t height;
+    int32_t type; // Type OpenCV (CV_8UC3 = 16 pour le BGR, CV_8UC1 = 0 pour le gris).
+    int32_t step; // Octets par ligne.
+    uint32_t bytes; // Octets de pixels.
+};
+static const size_t slotHeaderBytes = 64; // Place réservée à SlotHeader avant les pixels.
+static_assert(sizeof(SlotHeader) <= slotHeaderBytes, "SlotHeader doit tenir dans sa place réservée");
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "les atomiques partagés entre processus doivent être sans verrou");
+// Segment de mémoire partagée nommé (POSIX shm_open/mmap, ou mappage de fichier Windows)
+class Segment {
+public:
+    Segment() = default;
+    ~Segment(); // Détache le segment (le supprime si on l'a créé).
+    Segment(const Segment &) = delete;
+    Segment &operator=(const Segment &) = delete;
+    bool create(const std::string &name, size_t bytes); // Crée (ou remplace) le segment ; faux si le système le refuse.
+    bool attach(const std::string &name); // S'attache à un segment existant.
+    void release(); // Détache (et supprime le nom si on l'a créé).
+    void *data() const; // Adresse du segment (nulle s'il n'est pas attaché).
+    size_t size() const;
+    static std::string systemName(const std::string &name); // Nom donné au système ("/nom" ou "Local\nom").
+private:
+    void *m_data = nullptr; // Adresse du mappage.
+    size_t m_size = 0; // Taille mappée.
+    bool m_owner = false; // Créé par ce processus (nom supprimé à la libération).
+    std::string m_name; // Nom système.
+    void *m_handle = nullptr; // Handle du mappage (Windows).
+};
+// Réveil des lecteurs (futex partagé sous Linux, sans effet ailleurs)
+void wakeAll(std::atomic<uint32_t> *word);
+bool waitChange(const std::atomic<uint32_t> *word, uint32_t seen, int timeoutMs); // Attend que word diffère de seen ; faux à l'échéance.
+// Lecteur de référence : s'attache à l'anneau d'un écrivain et rend des vues sur les frames, sans copie
+class Reader {
+public:
+    // Vue sur une frame de l'anneau (valable jusqu'à ce que la case soit réécrite : vérifier avec isValid())
+    struct Frame {
+        const uint8_t *data = nullptr; // Pixels (dans le segment partagé).
+        int width = 0;
+        int height = 0;
+        int type = 0; // Type OpenCV : cv::Mat(height, width, type, (void *)data, step) l'enveloppe sans copie.
+        int step = 0;
+        uint64_t sequence = 0; // Numéro de la frame chez l'écrivain.
+        int64_t timestampNs = 0; // Horodatage de capture (horloge monotone).
+    };
+    bool open(const std::string &name); // S'attache au segment "name" ; faux s'il n'existe pas ou n'est pas compatible.
+    void close();
+    bool isOpen() const;
+    bool isClosedByWriter() const; // L'écrivain a abandonné le segment (fermeture ou changement de taille) : rouvrir.
+    bool next(Frame &frame, int timeoutMs); // Attend une frame plus récente que la précédente rendue ; faux à l'échéance ou si le segment est abandonné.
+    bool isValid(const Frame &frame) const; // Vrai si la case n'a pas été réécrite depuis next() (à appeler après lecture des pixels).
+    uint64_t skippedFrames() const; // Frames publiées jamais rendues (lecteur plus lent que l'écrivain).
+private:
+    Segment m_segment; // Segment attaché.
+    const Header *m_header = nullptr; // En-tête du segment (mappé en lecture seule).
+    uint64_t m_lastSequence = 0; // Dernière frame rendue.
+    uint64_t m_skipped = 0; // Frames sautées.
+};
+}
+#endif // SHAREDFRAMES_H
@@ -0,0 +1,149 @@
+#include "snapshotwriter.h" // Déclaration de la classe SnapshotWriter.
+#include "metrics.h" // Logs limités du pipeline.
+#include <opencv2/imgcodecs.hpp> // cv::imwrite.
+#include <QDir> // Création du dossier de sortie.
+#include <algorithm> // std::min, std::max.
+// Le pool compte le thread appelant : threads + 1 pour autant de threads d'écriture
+SnapshotWriter::SnapshotWriter(int threads)
+    : m_pool(std::max(1, threads) + 1) {
+}
+SnapshotWriter::~SnapshotWriter() {
+    // m_pool est le dernier membre déclaré : détruit en premier, il termine les écritures en file pendant que les demandes existent encore
+}
+void SnapshotWriter::setDirectory(const QString &directory) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_directory = directory;
+}
+QString SnapshotWriter::directory() const {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_directory;
+}
+void SnapshotWriter::setFormat(const QString &format) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_format = format.toLower() == QLatin1String("png") ? QStringLiteral("png") : QStringLiteral("jpg");
+}
+QString SnapshotWriter::format() const {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_format;
+}
+void SnapshotWriter::setJpegQuality(int quality) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_jpegQuality = std::min(100, std::max(1, quality));
+}
+void SnapshotWriter::setPngCompression(int level) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_pngCompression = std::min(9, std::max(0, level));
+}
+void SnapshotWriter::setCallback(const Callback &callback) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    m_callback = callback;
+}
+int SnapshotWriter::pendingFrames() const {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    return m_pending;
+}
+// Ouvre une demande : les réglages courants valent pour toutes ses frames
+int SnapshotWriter::begin(const QString &prefix, int frames) {
+    std::lock_guard<std::mutex> locker(m_mutex);
+    const int id = m_nextId++;
+    Request &request = m_requests[id];
+    request.directory = m_directory;
+    request.prefix = prefix;
+    request.extension = m_format;
+    if (m_format == QLatin1String("png")) {
+        request.params = {cv::IMWRITE_PNG_COMPRESSION, m_pngCompression};
+    } else {
+        request.params = {cv::IMWRITE_JPEG_QUALITY, m_jpegQuality};
+    }
+    request.expected = std::max(1, frames);
+    request.files.resize(request.expected);
+    return id;
+}
+// Copie sur le thread appelant (la frame source est réutilisée par le pipeline), encodage et écriture sur le pool
+bool SnapshotWriter::add(int id, const cv::Mat &frame) {
+    int index;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        auto it = m_requests.find(id);
+        if (it == m_requests.end() || it->second.added >= it->second.expected) {
+            return false;
+        }
+        index = it->second.added++;
+        ++m_pending;
+    }
+    cv::Mat copy = frame.clone(); // Rafale en mémoire : une copie par frame, libérée une fois écrite.
+    m_pool.submit([this, id, index, copy]() { write(id, index, copy); });
+    return true;
+}
+void SnapshotWriter::finish(int id) {
+    std::unique_lock<std::mutex> locker(m_mutex);
+    auto it = m_requests.find(id);
+    if (it == m_requests.end()) {
+        return;
+    }
+    it->second.expected = it->second.added;
+    it->second.files.resize(it->second.added);
+    if (it->second.written == it->second.expected) {
+        complete(it, locker); // Toutes les frames confiées sont déjà écrites.
+    }
+}
+// Écrit une frame (thread d'écriture) et termine la demande si c'était la dernière
+void SnapshotWriter::write(int id, int index, const cv::Mat &frame) {
+    QString directory, path;
+    std::vector<int> params;
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        const Request &request = m_requests.at(id);
+        directory = request.directory;
+        params = request.params;
+        path = QDir(directory).filePath(QStringLiteral("%1-%2.%3").arg(request.prefix).arg(index + 1, 3, 10, QLatin1Char('0')).arg(request.extension));
+    }
+    QString error;
+    if (!QDir().mkpath(directory)) {
+        error = QStringLiteral("Impossible de créer le dossier %1").arg(directory);
+    } else {
+        try {
+            if (!cv::imwrite(path.toStdString(), frame, params)) {
+                error = QStringLiteral("Impossible d'écrire %1").arg(path);
+            }
+        } catch (const cv::Exception &exception) {
+            error = QStringLiteral("Impossible d'écrire %1 : %2").arg(path, QString::fromStdString(exception.msg));
+        }
+    }
+    if (!error.isEmpty()) {
+        static LogRateLimiter limiter; // Un dossier inaccessible ferait échouer chaque frame d'une rafale.
+        if (limiter.allow()) {
+            qCWarning(lcPipeline) << "Erreur :" << error;
+        }
+    }
+    std::unique_lock<std::mutex> locker(m_mutex);
+    --m_pending;
+    auto it = m_requests.find(id);
+    Request &request = it->second;
+    ++request.written;
+    if (error.isEmpty()) {
+        request.files[index] = path;
+    } else if (request.error.isEmpty()) {
+        request.error = error;
+    }
+    if (request.written == request.expected) {
+        complete(it, locker);
+    }
+}
+// Retire une demande terminée et appelle le rappel hors verrou (il peut ouvrir une nouvelle demande)
+void SnapshotWriter::complete(std::map<int, Request>::iterator it, std::unique_lock<std::mutex> &locker) {
+    Result result;
+    result.id = it->first;
+    result.error = it->second.added == 0 ? QStringLiteral("Aucune frame capturée") : it->second.error;
+    for (const QString &file : it->second.files) {
+        if (!file.isEmpty()) {
+            result.files << file;
+        }
+    }
+    m_requests.erase(it);
+    const Callback callback = m_callback;
+    locker.unlock();
+    if (callback) {
+        callback(result);
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef SNAPSHOTWRITER_H
+#define SNAPSHOTWRITER_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat pour les frames.
+#include "workerpool.h" // Threads d'écriture.
+#include <QString> // Dossier et noms des fichiers.
+#include <QStringList> // Fichiers écrits.
+#include <functional> // Rappel de fin d'une demande.
+#include <map> // Demandes en cours.
+#include <mutex> // Demandes partagées avec les threads d'écriture.
+#include <vector> // Paramètres d'encodage.
+// Captures d'images non bloquantes : le pipeline confie des copies de ses frames traitées, un petit pool de threads
+// dédié les encode (JPEG ou PNG) et les écrit dans un dossier, sans jamais retenir le traitement ni l'interface.
+// Une demande regroupe une image ou une rafale de N frames : le rappel de fin est appelé une seule fois, sur un
+// thread d'écriture, quand la dernière frame de la demande est écrite (ou a échoué).
+class SnapshotWriter {
+public:
+    // Issue d'une demande
+    struct Result {
+        int id = 0; // Numéro rendu par begin().
+        QStringList files; // Fichiers écrits, dans l'ordre des frames.
+        QString error; // Premier échec (vide si tout est écrit).
+    };
+    using Callback = std::function<void(const Result &result)>;
+    explicit SnapshotWriter(int threads = 2); // Threads d'écriture (l'encodage PNG d'une grande image prend des dizaines de ms).
+    ~SnapshotWriter(); // Écrit les frames déjà confiées.
+    SnapshotWriter(const SnapshotWriter &) = delete;
+    SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+    // Réglages (pris en compte à la prochaine demande)
+    void setDirectory(const QString &directory); // Dossier de sortie (créé au besoin).
+    QString directory() const;
+    void setFormat(const QString &format); // "jpg" ou "png".
+    QString format() const;
+    void setJpegQuality(int quality); // 1 à 100.
+    void setPngCompression(int level); // 0 (rapide) à 9 (compact).
+    void setCallback(const Callback &callback); // Fin d'une demande (thread d'écriture).
+    int begin(const QString &prefix, int frames); // Ouvre une demande de frames images nommées <prefix>-<n> ; renvoie son numéro.
+    bool add(int id, const cv::Mat &frame); // Copie une frame de la demande et la confie aux threads d'écriture ; faux si la demande est complète.
+    void finish(int id); // Clôt une demande avant son terme (capture arrêtée) : seules les frames déjà confiées sont écrites.
+    int pendingFrames() const; // Frames copiées, pas encore écrites.
+private:
+    // Demande en cours
+    struct Request {
+        QString directory; // Réglages figés au début de la demande.
+        QString prefix;
+        QString extension;
+        std::vector<int> params; // Paramètres de cv::imwrite.
+        int expected = 0; // Frames attendues (réduit par finish()).
+        int added = 0; // Frames confiées.
+        int written = 0; // Frames traitées par les threads d'écriture (écrites ou en échec).
+        std::vector<QString> files; // Fichier de chaque frame (vide en cas d'échec).
+        QString error;
+    };
+    void write(int id, int index, const cv::Mat &frame); // Écrit une frame (thread d'écriture).
+    void complete(std::map<int, Request>::iterator it, std::unique_lock<std::mutex> &locker); // Termine une demande (m_mutex tenu par locker, relâché avant le rappel).
+    mutable std::mutex m_mutex; // Protège les réglages et les demandes.
+    QString m_directory;
+    QString m_format = QStringLiteral("jpg");
+    int m_jpegQuality = 95;
+    int m_pngCompression = 3;
+    Callback m_callback;
+    std::map<int, Request> m_requests; // Demandes en cours, par numéro.
+    int m_nextId = 1;
+    int m_pending = 0; // Frames confiées, pas encore écrites.
+    WorkerPool m_pool; // Threads d'écriture (détruit en premier : les écritures en file se terminent avant le reste).
+};
+#endif // SNAPSHOTWRITER_H
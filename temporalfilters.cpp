@@ -0,0 +1,111 @@
+#include "temporalfilters.h" // Déclaration de la classe TemporalFilters.
+#include <algorithm> // std::min, std::max.
+#include <cmath> // std::log2.
+#include <cstdint> // Accumulateurs 16 bits.
+#include <cstdlib> // std::abs.
+namespace {
+// acc - acc / 2^shift, d'au moins 1 tant que acc > 0 : sans ce minimum, la décroissance s'arrête sous 2^shift
+// (255 pour shift = 8, soit un niveau de sortie résiduel) ; min/max sans branche, la boucle reste vectorisable
+inline int decay(int acc, int shift) {
+    return acc - std::max(acc >> shift, std::min(acc, 1));
+}
+// Écart maximal entre deux pixels (tous canaux)
+template <int Channels>
+inline int pixelDifference(const uchar *a, const uchar *b) {
+    int difference = 0;
+    for (int c = 0; c < Channels; ++c) {
+        difference = std::max(difference, std::abs(a[c] - b[c]));
+    }
+    return difference;
+}
+template <int Channels>
+void foregroundRow(uchar *src, uint16_t *background, int pixels, int shift, int threshold) {
+    const int round = shift > 0 ? 1 << (shift - 1) : 0;
+    for (int x = 0; x < pixels; ++x) {
+        uchar *pixel = src + x * Channels;
+        uint16_t *model = background + x * Channels;
+        int difference = 0;
+        for (int c = 0; c < Channels; ++c) {
+            difference = std::max(difference, std::abs(pixel[c] - ((model[c] + 127) >> 8))); // Écart au fond avant sa mise à jour (arrondi comme average()).
+            model[c] = static_cast<uint16_t>(model[c] + (((pixel[c] << 8) - model[c] + round) >> shift));
+        }
+        const uchar keep = difference > threshold ? 0xFF : 0x00; // Masque sans branche.
+        for (int c = 0; c < Channels; ++c) {
+            pixel[c] &= keep;
+        }
+    }
+}
+template <int Channels>
+void trailsRow(uchar *src, uchar *previous, uint16_t *trail, int pixels, int shift) {
+    for (int x = 0; x < pixels; ++x) {
+        uchar *pixel = src + x * Channels;
+        uchar *before = previous + x * Channels;
+        const int difference = pixelDifference<Channels>(pixel, before);
+        const int decayed = decay(trail[x], shift);
+        trail[x] = static_cast<uint16_t>(std::max(decayed, difference << 8));
+        const int glow = (trail[x] + 128) >> 8;
+        for (int c = 0; c < Channels; ++c) {
+            before[c] = pixel[c];
+            pixel[c] = static_cast<uchar>(std::min(255, pixel[c] + glow)); // Addition saturée.
+        }
+    }
+}
+}
+int TemporalFilters::shiftForFrames(int frames) {
+    return std::min(8, std::max(0, static_cast<int>(std::lround(std::log2(std::max(1, frames)))))); // 8 : un niveau par pas de 256.
+}
+void TemporalFilters::seed(const cv::Mat &frame, cv::Mat &accumulator) {
+    frame.convertTo(accumulator, CV_16U, 256.0); // Virgule fixe 8.8 (réutilise l'accumulateur s'il a déjà cette taille).
+}
+void TemporalFilters::seedTrails(const cv::Mat &frame, cv::Mat &previous, cv::Mat &trail) {
+    frame.copyTo(previous);
+    trail.create(frame.rows, frame.cols, CV_16UC1);
+    trail.setTo(cv::Scalar::all(0));
+}
+// acc += (valeur - acc) / 2^shift, arrondi ; la sortie est l'accumulateur arrondi à 8 bits.
+// Le pas arrondi s'annule à moins d'un demi-pas de la cible (jusqu'à +128 en 8.8 quand l'image s'assombrit) :
+// l'arrondi de sortie (acc + 127) >> 8 rend alors exactement la valeur d'entrée, dans les deux sens.
+void TemporalFilters::average(cv::Mat &frame, cv::Mat &accumulator, int shift) {
+    const int count = frame.cols * frame.channels();
+    const int round = shift > 0 ? 1 << (shift - 1) : 0;
+    for (int y = 0; y < frame.rows; ++y) {
+        uchar *src = frame.ptr<uchar>(y);
+        uint16_t *acc = accumulator.ptr<uint16_t>(y);
+        for (int i = 0; i < count; ++i) {
+            const int value = acc[i] + (((src[i] << 8) - acc[i] + round) >> shift); // Reste entre l'ancienne valeur et la nouvelle.
+            acc[i] = static_cast<uint16_t>(value);
+            src[i] = static_cast<uchar>((value + 127) >> 8);
+        }
+    }
+}
+// acc = max(acc - acc / 2^shift, valeur) : les zones claires persistent et s'éteignent en environ 2^shift frames (jusqu'au noir)
+void TemporalFilters::lighten(cv::Mat &frame, cv::Mat &accumulator, int shift) {
+    const int count = frame.cols * frame.channels();
+    for (int y = 0; y < frame.rows; ++y) {
+        uchar *src = frame.ptr<uchar>(y);
+        uint16_t *acc = accumulator.ptr<uint16_t>(y);
+        for (int i = 0; i < count; ++i) {
+            const int value = std::max(decay(acc[i], shift), src[i] << 8);
+            acc[i] = static_cast<uint16_t>(value);
+            src[i] = static_cast<uchar>((value + 128) >> 8);
+        }
+    }
+}
+void TemporalFilters::foreground(cv::Mat &frame, cv::Mat &background, int shift, int threshold) {
+    for (int y = 0; y < frame.rows; ++y) {
+        if (frame.channels() == 1) {
+            foregroundRow<1>(frame.ptr<uchar>(y), background.ptr<uint16_t>(y), frame.cols, shift, threshold);
+        } else {
+            foregroundRow<3>(frame.ptr<uchar>(y), background.ptr<uint16_t>(y), frame.cols, shift, threshold);
+        }
+    }
+}
+void TemporalFilters::trails(cv::Mat &frame, cv::Mat &previous, cv::Mat &trail, int shift) {
+    for (int y = 0; y < frame.rows; ++y) {
+        if (frame.channels() == 1) {
+            trailsRow<1>(frame.ptr<uchar>(y), previous.ptr<uchar>(y), trail.ptr<uint16_t>(y), frame.cols, shift);
+        } else {
+            trailsRow<3>(frame.ptr<uchar>(y), previous.ptr<uchar>(y), trail.ptr<uint16_t>(y), frame.cols, shift);
+        }
+    }
+}
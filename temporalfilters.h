@@ -0,0 +1,21 @@
+#ifndef TEMPORALFILTERS_H
+#define TEMPORALFILTERS_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat pour les images et les accumulateurs.
+// Filtres temporels incrémentaux : l'état de chaque pixel tient dans un accumulateur en virgule fixe 8.8 (CV_16U,
+// alloué une fois à la taille de la frame) mis à jour en O(1) par pixel et par frame. La fenêtre (en frames) devient
+// un décalage de bits : le coût ne dépend pas de sa longueur. Boucles entières simples sur les lignes, sans branche
+// dans la boucle interne, vectorisées par le compilateur. Les fonctions travaillent sur des lignes indépendantes :
+// l'appelant peut les exécuter par bandes (frame et accumulateurs découpés sur les mêmes lignes).
+// frame est en CV_8UC1 ou CV_8UC3 et modifiée sur place ; les accumulateurs sont préparés par seed().
+class TemporalFilters {
+public:
+    static int shiftForFrames(int frames); // Fenêtre en frames -> décalage (puissance de deux la plus proche, de 0 à 8).
+    static void seed(const cv::Mat &frame, cv::Mat &accumulator); // Accumulateur 8.8 de mêmes canaux, initialisé à l'image.
+    static void seedTrails(const cv::Mat &frame, cv::Mat &previous, cv::Mat &trail); // Frame précédente et traînée (nulle, un canal).
+    static void average(cv::Mat &frame, cv::Mat &accumulator, int shift); // Moyenne exponentielle (débruitage) : frame reçoit la moyenne.
+    static void lighten(cv::Mat &frame, cv::Mat &accumulator, int shift); // Pose longue : maximum qui s'éteint lentement (traînées lumineuses).
+    static void foreground(cv::Mat &frame, cv::Mat &background, int shift, int threshold); // Fond appris par moyenne lente ; les pixels du fond passent au noir.
+    static void trails(cv::Mat &frame, cv::Mat &previous, cv::Mat &trail, int shift); // Différence avec la frame précédente, ajoutée et estompée frame après frame.
+};
+#endif // TEMPORALFILTERS_H
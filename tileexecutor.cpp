@@ -0,0 +1,54 @@
+#include "tileexecutor.h" // Déclaration de la classe TileExecutor.
+#include <algorithm> // std::max, std::min.
+static const int minimumBandRows = 16; // En dessous, le coût du halo et de la synchronisation l'emporte.
+// Constructeur : exécution en série tant qu'aucun nombre de threads n'est demandé
+TileExecutor::TileExecutor(WorkerPool *pool)
+    : m_pool(pool) {
+}
+void TileExecutor::setThreadCount(int count) {
+    m_threadCount = (count <= 0) ? m_pool->threadCount() : std::min(count, m_pool->threadCount());
+}
+int TileExecutor::threadCount() const {
+    return m_threadCount;
+}
+int TileExecutor::border() {
+    return cv::BORDER_DEFAULT | cv::BORDER_ISOLATED; // Une bande ne lit jamais hors de ses lignes (halo compris).
+}
+// Une bande par thread : les filtres coûteux ont un coût uniforme par pixel
+int TileExecutor::bandCount(int rows) const {
+    return std::max(1, std::min(m_threadCount, rows / minimumBandRows));
+}
+// Applique function par bandes avec halo
+void TileExecutor::run(const cv::Mat &src, cv::Mat &dst, int halo, const BandFunction &function) {
+    const int bands = bandCount(src.rows);
+    if (bands <= 1) {
+        function(src, dst); // Un seul thread : appel direct sur l'image entière.
+        return;
+    }
+    m_pool->parallelFor(bands, [&](int band) {
+        const int begin = src.rows * band / bands; // Lignes propres de la bande : [begin, end).
+        const int end = src.rows * (band + 1) / bands;
+        if (halo <= 0) {
+            cv::Mat output = dst.rowRange(begin, end); // Écrit directement dans dst.
+            function(src.rowRange(begin, end), output);
+            return;
+        }
+        const int top = std::max(0, begin - halo); // Bande étendue : [top, bottom).
+        const int bottom = std::min(src.rows, end + halo);
+        cv::Mat extended = m_buffers.acquire(bottom - top, src.cols, dst.type());
+        function(src.rowRange(top, bottom), extended);
+        cv::Mat output = dst.rowRange(begin, end);
+        extended.rowRange(begin - top, end - top).copyTo(output); // Ne garde que les lignes propres.
+    }, bands);
+}
+// Découpe [0, rows) en bandes et les traite en parallèle
+void TileExecutor::forEachBand(int rows, const std::function<void(int, int)> &function) {
+    const int bands = bandCount(rows);
+    if (bands <= 1) {
+        function(0, rows);
+        return;
+    }
+    m_pool->parallelFor(bands, [&](int band) {
+        function(rows * band / bands, rows * (band + 1) / bands);
+    }, bands);
+}
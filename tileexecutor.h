@@ -0,0 +1,30 @@
+#ifndef TILEEXECUTOR_H
+#define TILEEXECUTOR_H
+// Inclusion des bibliothèques nécessaires
+#include <opencv2/core.hpp> // cv::Mat pour les images.
+#include "bufferpool.h" // Tampons des bandes avec bordure.
+#include "workerpool.h" // Pool de threads partagé.
+#include <functional> // std::function pour le traitement d'une bande.
+// Exécution d'un filtre par bandes horizontales sur le pool de threads.
+// Chaque bande est étendue de "halo" lignes de contexte au-dessus et en dessous (demi-taille du noyau),
+// filtrée comme une image isolée, puis seules ses lignes propres sont recopiées : les lignes touchées par
+// l'extrapolation de bord sont exactement celles du halo, le résultat est donc identique au bit près
+// à un appel unique sur l'image entière (à condition que le filtre reçoive BORDER_ISOLATED, cf. border()).
+class TileExecutor {
+public:
+    using BandFunction = std::function<void(const cv::Mat &src, cv::Mat &dst)>; // Traitement d'une bande.
+    explicit TileExecutor(WorkerPool *pool = &WorkerPool::shared());
+    void setThreadCount(int count); // Nombre de threads utilisés (1 = exécution en série, 0 = tous les cœurs du pool).
+    int threadCount() const;
+    // Applique function par bandes de src vers dst (déjà allouée à la taille et au type de sortie).
+    // Avec halo > 0, src et dst doivent être des tampons distincts ; avec halo == 0 le traitement peut être sur place.
+    void run(const cv::Mat &src, cv::Mat &dst, int halo, const BandFunction &function);
+    void forEachBand(int rows, const std::function<void(int begin, int end)> &function); // Découpe [0, rows) en bandes sans bordure.
+    static int border(); // Bordure à passer aux filtres exécutés par bandes (BORDER_DEFAULT | BORDER_ISOLATED).
+private:
+    int bandCount(int rows) const; // Nombre de bandes pour une image de cette hauteur.
+    WorkerPool *m_pool; // Pool de threads (partagé par défaut).
+    int m_threadCount = 1; // Threads utilisés.
+    BufferPool m_buffers; // Tampons des bandes étendues (réutilisés d'une frame à l'autre).
+};
+#endif // TILEEXECUTOR_H
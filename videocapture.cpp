@@ -1,6 +1,14 @@
 #include "videocapture.h" // Déclaration de la classe VideoCapture.
+#include "frameprovider.h" // Fournisseur d'images pour l'affichage QML sans encodage.
+#include "framesource.h" // Sources de frames (caméra, fichier, séquence, mire).
+#include "mjpegserver.h" // Flux MJPEG des frames publiées.
 #include <QDebug> // Utilisé pour la sortie des messages de debug.
 #include <QDir> // Gestion des chemins et répertoires.
+#include <QFileInfo> // Dossier du fichier de sortie.
+#include <QDateTime> // Horodatage des fichiers d'événement et des mesures.
+#include <QJsonObject> // Fichier des mesures.
+#include <QRectF> // Zones d'intérêt décrites par QML.
+#include <QStandardPaths> // Dossier Images de l'utilisateur (captures d'images).
 #include <opencv2/opencv.hpp> // Bibliothèque OpenCV principale.
 #include <opencv2/highgui.hpp> // Fonctions pour la manipulation des fenêtres et des images.
 #include <opencv2/imgproc.hpp> // Fonctions de traitement d'image OpenCV.
@@ -10,40 +18,165 @@
 #include <QCoreApplication> // Gestion des propriétés globales de l'application Qt.
 #include <QString> // Gestion de chaînes de caractères.
 #include <QPixmap> // Manipulation d'images pour l'affichage dans l'interface Qt.
+#include <algorithm> // std::max.
 #include <chrono> // Mesure du temps (calcul du FPS).
 #include <sstream> // Manipulation avancée des flux.
 #include <vector> // Gestion des conteneurs de type vecteurs.
 #include <iomanip> // Formattage précis des flux de sortie.
 #include <thread>
-// Constructeur de la classe VideoCapture
-VideoCapture::VideoCapture(QObject *parent) : QObject(parent) ,m_filterMode(0) ,m_realFrameRate(0.0)  {
-    cap.open(0);// Ouvre la caméra par défaut (index 0).
+#include <atomic> // Compteur global des identifiants de source.
+#include <QThread> // Thread du traitement (interface ou pool).
+// Dossier par défaut des captures d'images : Images/mauellopencv (dossier courant si le système n'a pas de dossier Images)
+static QString defaultSnapshotDirectory() {
+    const QString pictures = QStandardPaths::writableLocation(QStandardPaths::PicturesLocation);
+    return QDir(pictures.isEmpty() ? QDir::currentPath() : pictures).filePath(QStringLiteral("mauellopencv"));
+}
+// Constructeur utilisé par QML : caméra 0, cadencée par son propre timer, démarrée immédiatement
+VideoCapture::VideoCapture(QObject *parent) : VideoCapture(QStringLiteral("camera:0"), nullptr, parent) {
+    startCapture();// Démarre la capture vidéo à l'initialisation.
+}
+// Constructeur du gestionnaire de caméras : source donnée, traitement confié à l'ordonnanceur (démarrage par startCapture())
+VideoCapture::VideoCapture(const QString &frameSource, CameraScheduler *scheduler, QObject *parent)
+    : QObject(parent) ,m_frameSource(frameSource) ,m_scheduler(scheduler) ,m_filterMode(0) ,m_realFrameRate(0.0)  {
+    static std::atomic<int> nextSourceId(0); // Numérotation des instances (plusieurs captures peuvent coexister).
+    m_sourceId = QStringLiteral("cam%1").arg(nextSourceId++); // Identifiant utilisé dans les URL "image://camera/...".
     frameTimer = new QTimer(this);// Création d'un timer pour capturer les frames périodiquement.
     connect(frameTimer, &QTimer::timeout, this, &VideoCapture::captureFrame);// Lier le timer à la méthode captureFrame.
-    //Initialisez le détecteur de visages
-    QString haarcascadePath = QCoreApplication::applicationDirPath() + "/haarcascade_frontalface_default.xml";
-    if (!faceCascade.load(haarcascadePath.toStdString())) {
-        qWarning() << "Erreur : Impossible de charger le modèle Haarcascade depuis :" << haarcascadePath;
+    // L'étape "faces" du graphe de filtres utilise le gris égalisé déjà calculé par le graphe
+    m_filterGraph.setFaceHandler([this](cv::Mat &bgr, const cv::Mat &gray) { detectFaces(bgr, gray); });
+    m_filterGraph.setThreadCount(0); // Filtres coûteux répartis sur tous les cœurs.
+    // Mesures par étape : lecture (thread de capture), encodage (threads d'enregistrement), le reste ici
+    m_engine.setMetrics(&m_metrics);
+    m_recorder.setMetrics(&m_metrics);
+    m_preroll.setMetrics(&m_metrics);
+    if (m_scheduler) {
+        m_engine.setFrameListener([scheduler]() { scheduler->wake(); }); // Chaque frame capturée réveille la répartition.
     }
+    // L'ouverture de la source se fait sur le thread de capture : son issue revient ici sur le thread de l'interface
+    m_engine.setStateListener([this]() { QMetaObject::invokeMethod(this, &VideoCapture::updateStatus, Qt::QueuedConnection); });
+    m_metricsFile = QDir::temp().filePath(QStringLiteral("mauellopencv-metrics-%1.json").arg(m_sourceId)); // Lu par la supervision.
+    metricsTimer = new QTimer(this);
+    connect(metricsTimer, &QTimer::timeout, this, &VideoCapture::publishMetrics);
+    metricsTimer->start(1000);
+    // Modèle de visages chargé par le thread de détection à la première frame qui en a besoin (étape faces)
+    QString haarcascadePath = QCoreApplication::applicationDirPath() + "/haarcascade_frontalface_default.xml";
+    m_faceDetector.setModelPath(haarcascadePath.toStdString());
+    // Captures d'images : écrites par les threads de SnapshotWriter, fin notifiée sur le thread de l'interface
+    m_snapshots.setDirectory(defaultSnapshotDirectory());
+    m_snapshots.setCallback([this](const SnapshotWriter::Result &result) {
+        QMetaObject::invokeMethod(this, [this, result]() {
+            if (result.error.isEmpty()) {
+                qDebug() << "Image enregistrée :" << result.files;
+            } else {
+                qWarning() << "Erreur lors de l'enregistrement de l'image :" << result.error;
+            }
+            emit snapshotSaved(result.id, result.files, result.error);
+        }, Qt::QueuedConnection);
+    });
     // Initialisation
     frameWidth = 640;// Largeur par défaut des frames.
     frameHeight = 480;// Hauteur par défaut des frames.
     fps = 30;// Images par seconde.
-    startCapture();// Démarre la capture vidéo à l'initialisation.
 }
 // Destructeur
 VideoCapture::~VideoCapture() {
-    if (cap.isOpened()) { // Vérifie si la caméra est ouverte
-        cap.release(); // Libère les ressources liées à la caméra
-    }
+    unschedule(); // Plus aucun traitement ne doit démarrer ni être en cours.
+    finishSnapshot(); // Les frames déjà prélevées sont écrites avant la destruction de m_snapshots.
+    FrameProvider::remove(m_sourceId); // Retire la dernière frame du fournisseur d'images.
+    MjpegServer::remove(m_sourceId); // Ferme les clients du flux MJPEG.
+    m_engine.stop(); // Arrête le thread de capture et libère la caméra
 }
 // Gestion des FPS
 double VideoCapture::realFrameRate() const {
     return m_realFrameRate; // Retourne le FPS réel calculé
 }
+// Mesures de la dernière seconde
+QVariantMap VideoCapture::metrics() const {
+    return m_metricsMap;
+}
+QString VideoCapture::metricsFile() const {
+    return m_metricsFile;
+}
+void VideoCapture::setMetricsFile(const QString &path) {
+    if (path != m_metricsFile) {
+        m_metricsFile = path;
+        emit metricsFileChanged();
+    }
+}
+// Résume la seconde écoulée : FPS lissé, latences par étape, compteurs ; notifie QML et écrit le fichier des mesures
+void VideoCapture::publishMetrics() {
+    checkEndOfStream(); // Sans timer de frames (ordonnanceur), la fin du flux est constatée ici.
+    QJsonObject json = PipelineMetrics::toJson(m_metrics.collect());
+    json["source"] = m_sourceId;
+    json["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    json["capturing"] = m_engine.isRunning();
+    json["status"] = m_status;
+    json["openMs"] = m_engine.openNs() >= 0 ? m_engine.openNs() / 1e6 : -1.0;
+    json["timeToFirstFrameMs"] = m_timeToFirstFrame;
+    json["faceModelLoadMs"] = m_faceDetector.stats().modelLoadMs;
+    json["droppedFrames"] = static_cast<double>(droppedFrames());
+    json["overrunFrames"] = static_cast<double>(overrunFrames());
+    json["allocationsPerFrame"] = m_allocationsPerFrame;
+    json["recorderDroppedFrames"] = static_cast<double>(m_lastRecorderStats.droppedFrames);
+    json["qualityLevel"] = m_qualityLevel;
+    json["qualityLevelName"] = qualityLevelName();
+    // Économies de la détection de changement : frames réutilisées telles quelles et tuiles effectivement retraitées
+    ChangeDetector::Stats changes;
+    {
+        std::lock_guard<std::mutex> locker(m_processMutex);
+        changes = m_changeDetector.takeStats();
+    }
+    m_skippedFrameRatio = changes.frames ? static_cast<double>(changes.skippedFrames) / changes.frames : 0.0;
+    m_dirtyTileRatio = changes.tiles ? static_cast<double>(changes.processedTiles) / changes.tiles : 0.0;
+    json["regions"] = m_regionList.size(); // Zones d'intérêt (0 = image entière).
+    json["changeDetection"] = changeDetection();
+    json["skippedFrameRatio"] = m_skippedFrameRatio;
+    json["dirtyTileRatio"] = m_dirtyTileRatio;
+    json["streamClients"] = MjpegServer::clientCount(m_sourceId); // Détail par client sur "/stats" du serveur MJPEG.
+    json["sharedMemoryExport"] = sharedMemoryExport() ? sharedMemoryName() : QString(); // Segment lu par les processus locaux (vide = désactivé).
+    json["snapshotsPending"] = m_snapshots.pendingFrames(); // Frames de captures d'images pas encore écrites.
+    const double fps = json["fps"].toDouble();
+    if (fps != m_realFrameRate) {
+        m_realFrameRate = fps;
+        emit realFrameRateChanged();
+    }
+    m_metricsMap = json.toVariantMap();
+    emit metricsChanged();
+    if (!m_metricsFile.isEmpty() && !PipelineMetrics::writeJson(json, m_metricsFile)) {
+        static LogRateLimiter limiter(60000);
+        if (limiter.allow()) {
+            qCWarning(lcPipeline) << "Erreur : Impossible d'écrire le fichier des mesures :" << m_metricsFile;
+        }
+    }
+}
 // Méthode pour vérifier si la capture est en cours
 bool VideoCapture::isCapturing() const {
-    return cap.isOpened(); // Renvoie vrai si la caméra est ouverte
+    return m_engine.isRunning(); // Renvoie vrai si le thread de capture tourne
+}
+QString VideoCapture::status() const {
+    return m_status;
+}
+double VideoCapture::timeToFirstFrame() const {
+    return m_timeToFirstFrame;
+}
+// État de la source : ouverture terminée ou échouée, première frame reçue, fin du flux
+void VideoCapture::updateStatus() {
+    static const char *const names[] = {"stopped", "opening", "ready", "failed"}; // Ordre de CaptureEngine::State.
+    const CaptureEngine::State state = m_engine.state();
+    const QString status = QString::fromLatin1(names[static_cast<int>(state)]);
+    const double firstFrameMs = m_engine.firstFrameNs() >= 0 ? m_engine.firstFrameNs() / 1e6 : -1.0;
+    if (status == m_status && firstFrameMs == m_timeToFirstFrame) {
+        return; // Notification d'un démarrage précédent, déjà prise en compte.
+    }
+    if (firstFrameMs >= 0.0 && m_timeToFirstFrame < 0.0) {
+        qDebug() << "Première frame de" << m_sourceId << "après" << firstFrameMs << "ms (ouverture :" << m_engine.openNs() / 1e6 << "ms)";
+    }
+    m_status = status;
+    m_timeToFirstFrame = firstFrameMs;
+    emit statusChanged();
+    if (state == CaptureEngine::State::Failed || state == CaptureEngine::State::Stopped) {
+        checkEndOfStream(); // Arrête le cadencement et signale la fin de la capture.
+    }
 }
 
 // Démarrer la capture
@@ -51,417 +184,823 @@ void VideoCapture::startCapture() {
     // Démarre le timer pour mesurer les FPS réels
     elapsedTimer.start();
 
-    if (!cap.open(0)) { // 0 : identifiant de la caméra par défaut
-        qWarning("Erreur : Impossible d'accéder à la caméra !");
-        return; // Arrête l'exécution si la caméra n'est pas accessible
+    unschedule(); // Le thread de capture va être remplacé : aucun traitement ne doit lire l'ancien.
+    // Crée la source choisie (caméra 0 par défaut) et lance le thread de capture, qui l'ouvre sans bloquer l'interface
+    std::unique_ptr<FrameSource> source = FrameSource::create(m_frameSource, frameWidth, frameHeight, fps);
+    if (!source) {
+        return; // Description de source invalide
     }
-
-    // Configuration de la caméra
-    cap.set(cv::CAP_PROP_BUFFERSIZE, 1); // Définit la taille du buffer
-    cap.set(cv::CAP_PROP_FRAME_WIDTH, frameWidth); // Largeur des images
-    cap.set(cv::CAP_PROP_FRAME_HEIGHT, frameHeight); // Hauteur des images
-    cap.set(cv::CAP_PROP_FPS, fps); // Définit le nombre d'images par seconde
-
-    // Affiche les propriétés actuelles de la caméra
-    qDebug() << "Propriétés caméra : "
-             << cap.get(cv::CAP_PROP_FRAME_WIDTH) << "x"
-             << cap.get(cv::CAP_PROP_FRAME_HEIGHT) << "@"
-             << cap.get(cv::CAP_PROP_FPS) << "FPS";
-
-    if (!writer.isOpened()) { // Vérifie si le fichier vidéo est configuré
-        qWarning("Attention : Aucun fichier vidéo n'a été configuré pour l'écriture !");
+    source->setPacing(m_unthrottled ? FrameSource::Pacing::Unthrottled : FrameSource::Pacing::RealTime);
+    const bool live = source->isLive();
+    if (!m_engine.start(std::move(source))) {
+        return; // Arrête l'exécution si la source n'est pas accessible
+    }
+    updateStatus(); // "opening" jusqu'à ce que le thread de capture ait ouvert la source.
+    m_lastSequence = 0; // Nouvelle séquence de frames
+    m_filterGraph.pool().clear(); // La résolution a pu changer : les tampons seront réalloués à la bonne taille.
+    m_faceDetector.reset(); // Les visages suivis appartiennent à l'ancienne source.
+    {
+        std::lock_guard<std::mutex> locker(m_processMutex);
+        m_governor.reset(); // Nouvelle source : la charge est à remesurer depuis la qualité complète.
+        applyQualitySettings();
+        updateFrameDeadline();
     }
+    if (m_qualityLevel != QualityGovernor::Full) {
+        m_qualityLevel = QualityGovernor::Full;
+        emit qualityChanged();
+    }
+    m_metrics.resetFps(); // L'intervalle entre frames repart de la nouvelle source.
+    emit isCapturingChanged();
 
-    // Démarre un timer pour capturer les frames selon le FPS défini
-    frameTimer->start(1000 / fps);
-    m_isRecording = true; // Marque l'état comme en enregistrement
+    if (m_scheduler) {
+        // Chaque nouvelle frame est traitée sur le pool partagé, dans le budget de FPS de la caméra
+        m_schedulerId = m_scheduler->addCamera([this]() { return !m_engine.ring().isLatestConsumed(); },
+                                               [this]() { processFrame(); }, m_priority, m_maxFps);
+        return;
+    }
+    // Démarre un timer pour capturer les frames selon le FPS défini (sans délai en rejeu au débit maximal)
+    frameTimer->start(m_unthrottled && !live ? 0 : 1000 / fps);
+}
+// Désinscrit la caméra de l'ordonnanceur (attend la fin du traitement en cours)
+void VideoCapture::unschedule() {
+    if (m_scheduler && m_schedulerId) {
+        m_scheduler->removeCamera(m_schedulerId);
+        m_schedulerId = 0;
+    }
 }
 
 // Arrêter la capture
 void VideoCapture::stopCapture() {
-    if (writer.isOpened()) writer.release(); // Ferme le fichier vidéo si ouvert
-    if (cap.isOpened()) cap.release(); // Libère la caméra si ouverte
+    setRecording(false); // Encode les frames en attente puis ferme le fichier vidéo
+    const bool wasCapturing = m_engine.isRunning();
+    unschedule(); // Attend la fin du traitement en cours
+    finishSnapshot(); // Une rafale interrompue garde les frames déjà prélevées
+    m_engine.stop(); // Arrête le thread de capture et libère la caméra
     frameTimer->stop(); // Arrête le timer des frames
+    m_metrics.resetFps();
     m_realFrameRate = 0.0; // Réinitialise le FPS réel
     emit realFrameRateChanged(); // Signale le changement de FPS
-    m_isRecording = false; // Met à jour l'état pour indiquer la fin de l'enregistrement
+    if (wasCapturing) {
+        emit isCapturingChanged();
+    }
+    updateStatus();
 }
 
 // Définir la résolution de la caméra
 void VideoCapture::setResolution(int width, int height) {
+    if (width == frameWidth && height == frameHeight) {
+        return; // Rien à renégocier avec la caméra.
+    }
     frameWidth = width; // Enregistre la largeur de l'image
     frameHeight = height; // Enregistre la hauteur de l'image
-    qDebug() << "Résolution définie sur" << width << "x" << height;
+    // Source ouverte : nouveau format appliqué par le thread de capture, sans fermer ni rouvrir le périphérique
+    const bool applied = m_engine.configure(frameWidth, frameHeight, fps);
+    qDebug() << "Résolution définie sur" << width << "x" << height << (applied ? "(appliquée à la source ouverte)" : "");
 }
 
-// Définir le nombre d'images par seconde
+// Définir le nombre d'images par seconde (appliqué aussitôt à la minuterie et à l'échéance du régulateur)
 void VideoCapture::setFPS(int fpsValue) {
-    fps = fpsValue; // Enregistre le nouveau FPS
+    fps = std::max(1, fpsValue); // Enregistre le nouveau FPS
+    m_engine.configure(frameWidth, frameHeight, fps); // Caméra ou mire ouverte : nouvelle cadence sans réouverture.
+    if (frameTimer->isActive() && frameTimer->interval() > 0) {
+        frameTimer->setInterval(1000 / fps); // Un rejeu sans cadencement garde son intervalle nul.
+    }
+    {
+        std::lock_guard<std::mutex> locker(m_processMutex);
+        updateFrameDeadline();
+    }
     qDebug() << "FPS défini sur" << fps;
 }
-
-
-
-void VideoCapture::setOutputFile(const QString &filePath) {
-    QString absolutePath = QDir::currentPath() + "/" + filePath; // Crée le chemin absolu pour le fichier vidéo
-    double fps = 7.5;  // FPS souhaité pour la sortie vidéo
-    int fourcc = cv::VideoWriter::fourcc('M', 'J', 'P', 'G'); // Codec vidéo utilisé pour la compression
-
-    // Ouvre le fichier de sortie pour enregistrer la vidéo
-    writer.open(absolutePath.toStdString(), fourcc, fps, cv::Size(frameWidth, frameHeight));
-    if (!writer.isOpened()) { // Vérifie si le fichier a été ouvert correctement
-        qWarning() << "Erreur : Impossible d'ouvrir le fichier vidéo pour l'écriture !" << absolutePath;
+// Échéance d'une frame : cadence demandée, ou budget de l'ordonnanceur s'il est plus bas
+void VideoCapture::updateFrameDeadline() {
+    const double target = m_maxFps > 0.0 ? std::min<double>(m_maxFps, fps) : fps;
+    m_governor.setFrameInterval(static_cast<int64_t>(1e9 / target));
+}
+// Régulation de la qualité
+bool VideoCapture::adaptiveQuality() const {
+    return m_adaptiveQuality;
+}
+void VideoCapture::setAdaptiveQuality(bool enabled) {
+    if (enabled == m_adaptiveQuality) {
         return;
     }
-    qDebug() << "Fichier vidéo configuré pour la sortie :" << absolutePath;
-
-    cv::VideoCapture cap(0); // Ouvre la caméra par défaut
-    cap.set(cv::CAP_PROP_FRAME_WIDTH, 320);  // Définit la largeur des frames capturées
-    cap.set(cv::CAP_PROP_FRAME_HEIGHT, 240); // Définit la hauteur des frames capturées
-    cap.set(cv::CAP_PROP_FPS, 30);  // Définit les FPS de capture
-
-    if (!cap.isOpened()) { // Vérifie si la caméra a été ouverte correctement
-        qWarning() << "Erreur lors de l'ouverture de la caméra !";
-        return;
+    {
+        std::lock_guard<std::mutex> locker(m_processMutex);
+        m_governor.setEnabled(enabled); // Désactivée : retour immédiat à la qualité complète.
+        applyQualitySettings();
     }
-
-    cv::CascadeClassifier face_cascade; // Initialise un classificateur pour la détection de visages
-    if (!face_cascade.load("C:/chemin/vers/haarcascade_frontalface_default.xml")) { // Charge le fichier Haar pour la détection des visages
-        qWarning() << "Erreur lors du chargement du classificateur de visages !";
-        cap.release(); // Libère la caméra en cas d'échec
+    m_adaptiveQuality = enabled;
+    m_qualityLevel = QualityGovernor::Full;
+    emit qualityChanged();
+}
+int VideoCapture::qualityLevel() const {
+    return m_qualityLevel;
+}
+QString VideoCapture::qualityLevelName() const {
+    return QString::fromLatin1(QualityGovernor::name(static_cast<QualityGovernor::Level>(m_qualityLevel)));
+}
+// Applique les réglages du palier courant au détecteur, au graphe et à l'échelle de traitement
+void VideoCapture::applyQualitySettings() {
+    const QualityGovernor::Settings settings = m_governor.settings();
+    m_faceDetector.setIntervalFactor(settings.detectionIntervalFactor);
+    m_filterGraph.setLightweight(settings.lightFilters);
+    if (settings.processingScale != m_processingScale) {
+        m_processingScale = settings.processingScale;
+        m_filterGraph.pool().clear(); // Les tampons à l'ancienne taille ne serviront plus.
+        m_faceDetector.reset(); // Positions des visages suivis à l'ancienne échelle.
+    }
+    invalidateOutput(); // Noyaux ou échelle modifiés : la sortie précédente ne correspond plus.
+}
+// Détection de changement
+bool VideoCapture::changeDetection() const {
+    return m_changeDetection;
+}
+void VideoCapture::setChangeDetection(bool enabled) {
+    if (enabled != m_changeDetection) {
+        {
+            std::lock_guard<std::mutex> locker(m_processMutex); // Changement entre deux frames, jamais pendant l'une d'elles.
+            m_changeDetection = enabled; // Désactivée : processFrame() oublie la sortie précédente.
+        }
+        emit changeDetectionChanged();
+    }
+}
+// Export en mémoire partagée
+bool VideoCapture::sharedMemoryExport() const {
+    return m_sharedMemoryExport;
+}
+QString VideoCapture::sharedMemoryName() const {
+    return QStringLiteral("mauellopencv-") + m_sourceId;
+}
+void VideoCapture::setSharedMemoryExport(bool enabled) {
+    if (enabled == m_sharedMemoryExport) {
         return;
     }
+    {
+        std::lock_guard<std::mutex> locker(m_processMutex); // L'écrivain appartient au traitement des frames.
+        m_sharedMemoryExport = enabled;
+        if (enabled) {
+            m_exporter.setName(sharedMemoryName()); // Segment créé à la prochaine frame publiée.
+        } else {
+            m_exporter.close(); // Les lecteurs voient le segment fermé.
+        }
+    }
+    qDebug() << "Export en mémoire partagée" << (enabled ? "activé :" : "désactivé :") << sharedMemoryName();
+    emit sharedMemoryExportChanged();
+}
+double VideoCapture::skippedFrameRatio() const {
+    return m_skippedFrameRatio;
+}
+double VideoCapture::dirtyTileRatio() const {
+    return m_dirtyTileRatio;
+}
+// Oublie la sortie précédente : la prochaine frame est traitée en entier et sert de nouvelle référence
+void VideoCapture::invalidateOutput() {
+    m_lastOutput.release(); // Le tampon retourne au pool.
+    m_changeDetector.reset();
+}
 
-    cv::Mat frame; // Matrice pour stocker chaque frame capturée
-    auto lastTime = std::chrono::high_resolution_clock::now(); // Enregistre le temps initial pour gérer les FPS
-    const double frameDuration = 1.0 / fps; // Calcul de la durée entre chaque frame (en secondes)
-
-    try {
-        while (cap.read(frame)) { // Lit les frames de la caméra en boucle
-            if (frame.empty()) { // Vérifie si la frame est vide
-                qWarning() << "Frame vide capturée !";
-                break;
-            }
-
-            qDebug() << "Frame capturée : " << frame.rows << "x" << frame.cols; // Affiche les dimensions de la frame
-
-            cv::Mat gray;
-            cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY); // Convertit la frame en niveaux de gris
-
-            std::vector<cv::Rect> faces; // Liste des visages détectés
-            face_cascade.detectMultiScale(gray, faces, 1.1, 3, 0, cv::Size(30, 30)); // Détecte les visages dans l'image
-
-            for (const auto &face : faces) { // Trace un rectangle autour de chaque visage détecté
-                cv::rectangle(frame, face, cv::Scalar(0, 255, 0), 2);
-            }
-
-            // Applique des filtres supplémentaires à la frame si nécessaire
-            applyFilters(frame);
-
-            // Calcul du temps écoulé depuis la dernière frame
-            auto currentTime = std::chrono::high_resolution_clock::now();
-            std::chrono::duration<double> elapsedTime = currentTime - lastTime;
-
-            // Si le temps écoulé est inférieur à la durée d'une frame, attend
-            if (elapsedTime.count() < frameDuration) {
-                std::this_thread::sleep_for(std::chrono::duration<double>(frameDuration - elapsedTime.count()));
-            }
 
-            // Enregistre la frame dans le fichier vidéo
-            writer.write(frame);
 
-            lastTime = currentTime; // Met à jour le dernier temps enregistré
+void VideoCapture::setOutputFile(const QString &filePath) {
+    m_outputFile = QDir::current().absoluteFilePath(filePath); // Chemin absolu du fichier vidéo
+    qDebug() << "Fichier vidéo configuré pour la sortie :" << m_outputFile;
+    if (m_isRecording) {
+        setRecording(false); // Bascule vers le nouveau fichier
+        setRecording(true);
+    }
+}
+// Réglages de l'enregistreur : taille de la file, politique quand elle est pleine, découpage en segments (au prochain enregistrement)
+void VideoCapture::setRecordingOptions(int queueCapacity, bool blockWhenFull, int segmentSeconds, qint64 segmentBytes) {
+    m_recorder.setQueueCapacity(queueCapacity);
+    m_recorder.setPolicy(blockWhenFull ? Recorder::Policy::Block : Recorder::Policy::DropOldest);
+    m_recorder.setSegmentDuration(segmentSeconds);
+    m_recorder.setSegmentSize(segmentBytes);
+}
+// Pré-capture : les dernières secondes restent en mémoire (JPEG), rien n'est écrit sans événement
+bool VideoCapture::prerollEnabled() const {
+    return m_prerollEnabled;
+}
+void VideoCapture::setPrerollEnabled(bool enabled) {
+    if (m_prerollEnabled != enabled) {
+        {
+            std::lock_guard<std::mutex> locker(m_processMutex); // Changement entre deux frames.
+            m_prerollEnabled = enabled;
         }
-    } catch (const std::exception &e) { // Gère les exceptions éventuelles
-        qWarning() << "Exception capturée : " << e.what();
+        emit prerollEnabledChanged();
     }
-
-    cap.release(); // Libère la caméra
-    writer.release(); // Ferme le fichier vidéo
-    qDebug() << "Capture vidéo terminée.";
+}
+void VideoCapture::setPrerollOptions(int prerollSeconds, int postrollSeconds, int memoryMegabytes) {
+    m_preroll.setPrerollSeconds(prerollSeconds);
+    m_preroll.setPostrollSeconds(postrollSeconds);
+    m_preroll.setMemoryBudget(static_cast<size_t>(memoryMegabytes) * 1024 * 1024);
+}
+// Écrit la pré-capture et la post-capture dans "event_<raison>_<date>.avi", à côté du fichier de sortie
+void VideoCapture::triggerEventRecording(const QString &reason) {
+    if (!m_prerollEnabled) {
+        qWarning() << "Attention : Pré-capture désactivée, événement ignoré :" << reason;
+        return;
+    }
+    const QDir directory = m_outputFile.isEmpty() ? QDir::current() : QFileInfo(m_outputFile).absoluteDir();
+    const QString file = directory.filePath(QStringLiteral("event_%1_%2.avi").arg(reason, QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")));
+    m_preroll.trigger(file, m_realFrameRate > 0 ? m_realFrameRate : fps);
+    m_prerollStats = m_preroll.stats();
+    emit prerollStatsChanged();
+}
+qulonglong VideoCapture::prerollMemory() const {
+    return m_prerollStats.bytesUsed;
+}
+double VideoCapture::prerollBufferedSeconds() const {
+    return m_prerollStats.bufferedSeconds;
+}
+bool VideoCapture::eventRecording() const {
+    return m_prerollStats.flushing;
+}
+// Mesures de l'enregistreur
+int VideoCapture::recorderQueueDepth() const {
+    return m_lastRecorderStats.queueDepth;
+}
+double VideoCapture::recorderEncodeLatency() const {
+    return m_lastRecorderStats.encodeLatencyMs;
+}
+qulonglong VideoCapture::recorderDroppedFrames() const {
+    return m_lastRecorderStats.droppedFrames;
 }
 
+// Priorité et budget de FPS auprès de l'ordonnanceur (sans effet sur une caméra cadencée par son timer)
+int VideoCapture::priority() const {
+    return m_priority;
+}
+void VideoCapture::setPriority(int priority) {
+    if (priority != m_priority) {
+        m_priority = priority;
+        if (m_schedulerId) {
+            m_scheduler->setPriority(m_schedulerId, priority);
+        }
+        emit schedulingChanged();
+    }
+}
+double VideoCapture::maxFps() const {
+    return m_maxFps;
+}
+void VideoCapture::setMaxFps(double maxFps) {
+    maxFps = std::max(0.0, maxFps);
+    if (maxFps != m_maxFps) {
+        m_maxFps = maxFps;
+        if (m_schedulerId) {
+            m_scheduler->setMaxFps(m_schedulerId, maxFps);
+        }
+        {
+            std::lock_guard<std::mutex> locker(m_processMutex);
+            updateFrameDeadline();
+        }
+        emit schedulingChanged();
+    }
+}
 // Vérifie si l'enregistrement vidéo est en cours
 bool VideoCapture::isRecording() const {
     return m_isRecording; // Retourne l'état d'enregistrement
 }
+// Description de la source des frames
+QString VideoCapture::frameSource() const {
+    return m_frameSource;
+}
+// Choisit la source des frames
+void VideoCapture::setFrameSource(const QString &spec) {
+    if (m_frameSource != spec) {
+        m_frameSource = spec;
+        emit frameSourceChanged();
+    }
+}
+// Vrai si les sources enregistrées sont lues sans cadencement
+bool VideoCapture::unthrottled() const {
+    return m_unthrottled;
+}
+// Active ou désactive la lecture au débit maximal
+void VideoCapture::setUnthrottled(bool unthrottled) {
+    if (m_unthrottled != unthrottled) {
+        m_unthrottled = unthrottled;
+        emit frameSourceChanged();
+    }
+}
+// Nombre de frames capturées mais écrasées avant d'être consommées
+qulonglong VideoCapture::droppedFrames() const {
+    return m_engine.ring().droppedFrames();
+}
+// Nombre de frames perdues parce que toutes les cases de l'anneau étaient lues
+qulonglong VideoCapture::overrunFrames() const {
+    return m_engine.ring().overrunFrames();
+}
+// Nombre d'allocations de cv::Mat pendant le traitement de la dernière frame
+int VideoCapture::allocationsPerFrame() const {
+    return m_allocationsPerFrame;
+}
+// Notifie QML si les compteurs de frames perdues ont changé
+void VideoCapture::updateCaptureStats() {
+    const qulonglong dropped = droppedFrames();
+    const qulonglong overruns = overrunFrames();
+    if (dropped != m_lastDropped || overruns != m_lastOverruns) {
+        m_lastDropped = dropped;
+        m_lastOverruns = overruns;
+        emit captureStatsChanged();
+    }
+}
 
 void VideoCapture::setRecording(bool recording) {
-    if (m_isRecording != recording) { // Vérifie si l'état d'enregistrement a changé.
+    if (m_isRecording == recording) { // Vérifie si l'état d'enregistrement a changé.
+        return;
+    }
+    if (recording) {
+        if (m_outputFile.isEmpty()) {
+            qWarning("Attention : Aucun fichier vidéo n'a été configuré pour l'écriture !");
+            return;
+        }
+        // La cadence du fichier est mesurée sur les frames capturées ; le FPS demandé ne sert qu'en secours
+        if (!m_recorder.start(m_outputFile, m_realFrameRate > 0 ? m_realFrameRate : fps)) {
+            return;
+        }
+    } else {
+        m_recorder.stop(); // Encode les frames encore en file puis ferme le segment
+    }
+    {
+        std::lock_guard<std::mutex> locker(m_processMutex); // Changement entre deux frames.
         m_isRecording = recording; // Met à jour l'état d'enregistrement.
-        emit recordingChanged(); // Émet un signal pour notifier les observateurs du changement.
     }
+    emit recordingChanged(); // Émet un signal pour notifier les observateurs du changement.
 }
+// Tick du timer (capture sans ordonnanceur) : traite la dernière frame sur le thread de l'interface
 void VideoCapture::captureFrame() {
-    if (!cap.isOpened()) { // Vérifie si la caméra est ouverte.
-        qWarning("Message : La caméra n'est pas ouverte !");
-        return;
+    if (!processFrame()) {
+        updateCaptureStats();
+        checkEndOfStream(); // Pas encore de nouvelle frame depuis le dernier tick, ou capture terminée.
     }
-
-    cv::Mat frame;
-    cap >> frame; // Capture une image depuis la caméra
-
-    if (frame.empty()) { // Vérifie si la frame capturée est vide.
-        qWarning("Erreur : La caméra ne renvoie pas de frame !");
+}
+// Arrête la distribution des frames si le thread de capture s'est arrêté (fin du flux, caméra perdue)
+void VideoCapture::checkEndOfStream() {
+    if (m_engine.isRunning() || (!frameTimer->isActive() && !m_schedulerId)) {
         return;
-
     }
+    qWarning() << (m_engine.endOfStream() ? "Message : Fin du flux de la source." : "Message : La caméra n'est pas ouverte !");
+    frameTimer->stop();
+    unschedule();
+    finishSnapshot();
+    emit isCapturingChanged();
+}
+// Traite la dernière frame capturée ; faux s'il n'y en a pas de nouvelle.
+// Appelée sur le thread de l'interface (timer) ou sur un thread du pool (ordonnanceur, une frame à la fois) :
+// tout ce que QML lit est transmis à applyUpdate() sur le thread de l'interface.
+bool VideoCapture::processFrame() {
+    std::unique_lock<std::mutex> locker(m_processMutex); // Exclut les réglages du graphe faits depuis l'interface.
+    // Prend la dernière frame publiée par le thread de capture (sans bloquer la lecture caméra)
+    FrameRing::FrameRef latest = m_engine.ring().latest();
+    if (!latest.isValid() || latest.sequence() == m_lastSequence) {
+        return false;
+    }
+    m_lastSequence = latest.sequence();
+    m_update = FrameUpdate();
+    const uint64_t allocationsBefore = AllocationCounter::allocations(); // Mesure des allocations du chemin de traitement.
+    const auto processingStart = std::chrono::steady_clock::now(); // Durée comparée à l'échéance par le régulateur.
+    const cv::Mat &source = latest.image();
+    const int64_t timestampNs = latest.timestampNs(); // Horodatage de capture (cadence réelle de l'enregistrement).
+    m_frameTimestampNs = timestampNs; // Repris par l'export en mémoire partagée.
+    const cv::Size captureSize = source.size();
+    if (m_processingScale < 1.0) {
+        // Palier de résolution réduite : traitement sur une image plus petite, agrandie à l'affichage (et pour les encodeurs)
+        const cv::Size reduced(std::max(1, cvRound(source.cols * m_processingScale)), std::max(1, cvRound(source.rows * m_processingScale)));
+        m_workFrame = m_filterGraph.pool().acquire(reduced.height, reduced.width, source.type());
+        cv::resize(source, m_workFrame, reduced, 0, 0, cv::INTER_AREA);
+    } else {
+        m_workFrame = m_filterGraph.pool().acquire(source.rows, source.cols, source.type()); // Tampon de travail recyclé.
+        source.copyTo(m_workFrame); // Les filtres travaillent sur place : copie dans le tampon de travail.
+    }
+    latest.release(); // Libère la case au plus tôt pour le producteur.
+    cv::Mat &frame = m_workFrame;
+    // Consommateurs de la frame BGR filtrée (lus une fois : la même décision vaut pour toute la frame)
+    const bool prerollEnabled = m_prerollEnabled;
+    const bool recording = m_isRecording;
+    const bool snapshot = m_snapshotRemaining > 0; // Capture d'image ou rafale en cours de prélèvement.
+    // Détection de changement : seulement si la sortie ne dépend que de l'image (ni bruit aléatoire, ni visages)
+    const bool gated = m_changeDetection && m_filterGraph.isDeterministic() && m_regions.empty(); // Zones d'intérêt : déjà limité à leur surface.
+    if (!gated && !m_lastOutput.empty()) {
+        invalidateOutput(); // Détection désactivée ou chaîne non déterministe : plus de sortie à réutiliser.
+    }
+    const int dirtyTiles = gated ? m_changeDetector.detect(frame) : -1;
+    const bool reusable = gated && m_lastOutput.size() == frame.size(); // Sortie précédente à la même échelle.
+    const bool keepFrame = gated || prerollEnabled || recording || snapshot || m_legacyFrameMode; // Avec la détection, la sortie BGR sert de base aux frames suivantes.
+    const cv::Mat *output = &frame; // Sortie BGR de cette frame (encodeurs).
+    if (reusable && dirtyTiles == 0) {
+        // Image inchangée : la sortie précédente reste affichée, sans filtre, conversion, encodage ni frameChanged
+        output = &m_lastOutput;
+        m_changeDetector.account(0);
+    } else {
+        // Tampon RGB du pool : il y retourne quand la QImage qui le référence est libérée (thread de rendu compris)
+        cv::Mat *rgb = new cv::Mat(m_filterGraph.pool().acquire(frame.rows, frame.cols, CV_8UC3)); // Seul l'en-tête est alloué.
+        // Filtres locaux et peu de tuiles modifiées : seules ces tuiles (et celles que leur halo atteint) sont recalculées
+        std::vector<cv::Rect> tiles;
+        const int halo = m_filterGraph.halo();
+        if (reusable && halo >= 0) {
+            tiles = m_changeDetector.dirtyTiles(halo);
+        }
+        bool partial = !tiles.empty() && tiles.size() * 2 <= static_cast<size_t>(m_changeDetector.tileCount()); // Au-delà de la moitié, la frame entière (par bandes) coûte moins.
+        // Appliquer les filtres à la frame (la dernière étape pixel à pixel écrit directement l'image RGB)
+        {
+            PipelineMetrics::ScopedTimer timer(&m_metrics, PipelineMetrics::Filter);
+            partial = partial && m_filterGraph.processRegions(frame, m_lastOutput, tiles);
+            if (!partial) {
+                filterFrame(frame, rgb, keepFrame);
+            }
+        }
 
-    // Ajouter un log pour vérifier les dimensions de la frame
-    qDebug() << "Dimensions de la frame : " << frame.rows << "x" << frame.cols;
-
-    // Calcul du FPS avec std::chrono
-    static auto lastTime = std::chrono::high_resolution_clock::now();// Initialise le temps précédent.
-    auto currentTime = std::chrono::high_resolution_clock::now();// Temps actuel.
-    double elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - lastTime).count(); // Temps écoulé en ms.
-    lastTime = currentTime;
-
-    if (elapsedMs > 0) { // Calcul du FPS.
-        m_realFrameRate = 1000.0 / elapsedMs;
-        emit realFrameRateChanged(); // Notifie les changements de FPS.
-        qDebug() << "Real FPS:" << m_realFrameRate;
+        if (frame.empty()) {
+            delete rgb;
+            static LogRateLimiter limiter; // Une chaîne défaillante échouerait à chaque frame.
+            if (limiter.allow()) {
+                qCWarning(lcPipeline, "Erreur : La frame est vide après les filtres !");
+            }
+            return true;
+        }
+        if (partial) {
+            output = &m_lastOutput; // Sortie précédente mise à jour sur place (personne d'autre ne la référence).
+            PipelineMetrics::ScopedTimer convertTimer(&m_metrics, PipelineMetrics::Convert);
+            m_filterGraph.toDisplay(m_lastOutput, *rgb);
+        } else if (gated) {
+            m_lastOutput = frame; // Conserve le tampon : base des frames suivantes.
+        }
+        if (gated) {
+            m_changeDetector.account(partial ? static_cast<int>(tiles.size()) : m_changeDetector.tileCount());
+        }
+        // Publier la frame vers l'affichage QML (sans encodage JPEG)
+        publishFrame(*output, rgb);
     }
-    // Appliquer les filtres à la frame
-    applyFilters(frame);
+    m_update.allocations = static_cast<int>(AllocationCounter::allocations() - allocationsBefore); // Avec plusieurs caméras, compte aussi les leurs.
 
-    // Convertir la frame de OpenCV en RGB
-    cv::cvtColor(frame, frame, cv::COLOR_BGR2RGB);
+    m_metrics.frameCompleted(timestampNs); // FPS lissé des frames traitées.
 
-    // Convertir la frame de OpenCV en QImage
-    if (frame.empty()) {
-        qWarning("Erreur : La frame est vide après les filtres !");
+    {
+        // Les encodeurs reçoivent aussi les frames inchangées : leur cadence (horodatages) fixe celle des fichiers
+        PipelineMetrics::ScopedTimer recordTimer(recording || prerollEnabled ? &m_metrics : nullptr, PipelineMetrics::Record); // Copies vers les encodeurs.
+        const cv::Mat *encoded = output;
+        if ((recording || prerollEnabled || snapshot) && output->size() != captureSize) {
+            cv::resize(*output, m_fullFrame, captureSize, 0, 0, cv::INTER_LINEAR); // Les fichiers gardent la résolution de capture.
+            encoded = &m_fullFrame;
+        }
+        // Mémorise la frame compressée pour un éventuel événement (encodage JPEG sur le thread de pré-capture)
+        if (prerollEnabled) {
+            m_preroll.push(*encoded, timestampNs);
+        }
+        // Dépose la frame filtrée dans la file de l'enregistreur (copie, encodage sur son propre thread)
+        if (recording) {
+            m_recorder.push(*encoded, timestampNs);
+        }
+        // Prélève la frame traitée pour la capture d'image en cours (copie ici, écriture sur les threads de SnapshotWriter)
+        if (snapshot) {
+            m_snapshots.add(m_snapshotId, *encoded);
+            --m_snapshotRemaining;
+        }
+    }
+    // Régulation : durée de traitement de cette frame face à l'échéance
+    const int64_t processingNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - processingStart).count();
+    if (m_governor.frameProcessed(processingNs)) {
+        applyQualitySettings(); // Pris en compte dès la frame suivante.
+        m_update.qualityLevel = m_governor.level();
+    }
+    const FrameUpdate update = m_update;
+    locker.unlock(); // Les signaux émis peuvent modifier les réglages (verrou repris).
+    deliver(update);
+    return true;
+}
+// Transmet le résultat d'une frame au thread de l'interface
+void VideoCapture::deliver(const FrameUpdate &update) {
+    if (QThread::currentThread() == thread()) {
+        applyUpdate(update);
+    } else {
+        QMetaObject::invokeMethod(this, [this, update]() { applyUpdate(update); }, Qt::QueuedConnection); // Ignoré si l'objet est détruit entre-temps.
+    }
+}
+// Met à jour ce que QML lit et émet les signaux (thread de l'interface)
+void VideoCapture::applyUpdate(const FrameUpdate &update) {
+    updateCaptureStats();
+    if (update.published) {
+        if (m_legacyFrameMode) {
+            m_frame = update.base64;
+        }
+        ++m_frameId;
+        emit frameChanged(); // Notifier le changement de frame
+    }
+    if (update.allocations >= 0 && update.allocations != m_allocationsPerFrame) {
+        m_allocationsPerFrame = update.allocations; // Doit rester à 0 en régime établi à résolution fixe.
+        emit captureStatsChanged();
+    }
+    if (update.faceStatsChanged) {
+        emit faceStatsChanged();
+    }
+    if (update.qualityLevel >= 0 && update.qualityLevel != m_qualityLevel && m_adaptiveQuality) {
+        m_qualityLevel = update.qualityLevel;
+        qCDebug(lcPipeline) << m_sourceId << "palier de qualité :" << qualityLevelName();
+        emit qualityChanged();
+    }
+    if (update.faceAppeared && m_prerollEnabled) {
+        triggerEventRecording(QStringLiteral("face")); // Un visage apparaît : conserve les secondes qui précèdent.
+    }
+    if (m_prerollEnabled && (!m_prerollStatsTimer.isValid() || m_prerollStatsTimer.elapsed() >= 1000)) {
+        m_prerollStatsTimer.start();
+        m_prerollStats = m_preroll.stats();
+        emit prerollStatsChanged();
+    }
+    if (m_isRecording) {
+        const Recorder::Stats stats = m_recorder.stats();
+        if (stats.queueDepth != m_lastRecorderStats.queueDepth || stats.droppedFrames != m_lastRecorderStats.droppedFrames
+            || stats.encodeLatencyMs != m_lastRecorderStats.encodeLatencyMs) {
+            m_lastRecorderStats = stats;
+            emit recorderStatsChanged();
+        }
+    }
+}
+void VideoCapture::applyFilters(cv::Mat &frame) {
+    // Exécute la chaîne de filtres compilée (un seul passage, produits intermédiaires partagés)
+    std::lock_guard<std::mutex> locker(m_processMutex); // Le graphe n'est utilisé que par un thread à la fois.
+    filterFrame(frame);
+}
+// Exécute la chaîne sur l'image entière, ou seulement dans les zones d'intérêt mises à la taille de la frame
+void VideoCapture::filterFrame(cv::Mat &frame, cv::Mat *display, bool keepFrame) {
+    if (m_regions.empty()) {
+        m_filterGraph.process(frame, display, keepFrame);
         return;
     }
-    QImage qimage(frame.data, frame.cols, frame.rows, frame.step, QImage::Format_RGB888);
-
-    if (qimage.isNull()) { // Vérifie si la conversion a échoué.
-        qWarning("Erreur : Conversion de cv::Mat en QImage a échoué !");
+    m_regionPixels.clear();
+    for (const cv::Rect2d &region : m_regions) {
+        // Fractions : les zones suivent la résolution de la source et l'échelle du palier de qualité
+        m_regionPixels.push_back(cv::Rect(cvRound(region.x * frame.cols), cvRound(region.y * frame.rows),
+                                          cvRound(region.width * frame.cols), cvRound(region.height * frame.rows)));
+    }
+    m_filterGraph.processRois(frame, m_regionPixels, m_outsideBrightness, display);
+}
+// Zones d'intérêt
+QVariantList VideoCapture::regions() const {
+    return m_regionList;
+}
+void VideoCapture::setRegions(const QVariantList &regions) {
+    std::vector<cv::Rect2d> parsed;
+    QVariantList accepted;
+    for (const QVariant &entry : regions) {
+        // Qt.rect(...) depuis QML, ou objet {x, y, width, height}
+        QRectF rect;
+        if (entry.canConvert<QRectF>()) {
+            rect = entry.toRectF();
+        } else {
+            const QVariantMap map = entry.toMap();
+            rect = QRectF(map.value("x").toDouble(), map.value("y").toDouble(), map.value("width").toDouble(), map.value("height").toDouble());
+        }
+        rect = rect.normalized() & QRectF(0, 0, 1, 1);
+        if (rect.isEmpty()) {
+            qWarning() << "Zone d'intérêt ignorée (fractions de l'image attendues, entre 0 et 1) :" << entry;
+            continue;
+        }
+        parsed.emplace_back(rect.x(), rect.y(), rect.width(), rect.height());
+        accepted.append(QVariantMap{{"x", rect.x()}, {"y", rect.y()}, {"width", rect.width()}, {"height", rect.height()}});
+    }
+    if (accepted == m_regionList) {
         return;
     }
-
-    // Encoder en base64
-    QByteArray buffer;// Prépare un buffer pour encoder l'image.
-    QBuffer buf(&buffer);
-    buf.open(QIODevice::WriteOnly);
-    qimage.save(&buf, "JPEG"); // Sauvegarde l'image en format JPEG dans le buffer.
-    m_frame = QString::fromLatin1(buffer.toBase64());// Encode en base64.
-    emit frameChanged(); // Notifier le changement de frame
-
-
-    // Record video with synchronized FPS
-    if (m_isRecording  && writer.isOpened()) {// Vérifie si l'enregistrement est actif.
-        writer.write(frame);// Enregistre la frame.
-    }else {
-        qWarning("Erreur : Le VideoWriter n'est pas ouvert !");
+    {
+        std::lock_guard<std::mutex> locker(m_processMutex);
+        m_regions = parsed;
+        m_faceDetector.setRegions(parsed); // Cascade limitée aux mêmes zones (oublie les visages suivis : pas pendant une frame).
+        invalidateOutput(); // La sortie précédente n'a pas été filtrée sur les mêmes zones.
     }
-
-    // Désactivez temporairement les filtres si besoin
-    applyFilters(frame);
-
-    // Redémarrer le timer pour la prochaine frame
-    elapsedTimer.restart();
+    m_regionList = accepted;
+    qDebug() << "Zones d'intérêt :" << m_regionList.size();
+    emit regionsChanged();
 }
-void VideoCapture::applyFilters(cv::Mat &frame) {
-    // Appliquer les filtres
-    if (m_filterMode == 0) {
-        // Aucun filtre
-        // Aucun changement
-    } else if (m_filterMode == 1) {
-        // Gris
-        cv::cvtColor(frame, frame, cv::COLOR_BGR2GRAY);
-        cv::cvtColor(frame, frame, cv::COLOR_GRAY2BGR);
-    } else if (m_filterMode == 2) {
-        // Inversion
-        cv::bitwise_not(frame, frame);
-    } else if (m_filterMode == 3) {
-        // Gaussian
-        cv::GaussianBlur(frame, frame, cv::Size(5, 5), 0);
-    } else if (m_filterMode == 4) {
-        // Median
-        cv::medianBlur(frame, frame, 5);
-    } else if (m_filterMode == 5) {
-        // CLAHE
-        cv::Mat lab;
-        cv::cvtColor(frame, lab, cv::COLOR_BGR2Lab);
-        std::vector<cv::Mat> lab_planes;
-        cv::split(lab, lab_planes);
-        cv::Ptr<cv::CLAHE> clahe = cv::createCLAHE(2.0, cv::Size(8, 8));
-        clahe->apply(lab_planes[0], lab_planes[0]);
-        cv::merge(lab_planes, lab);
-        cv::cvtColor(lab, frame, cv::COLOR_Lab2BGR);
-    } else if (m_filterMode == 6) {
-        // Sobel
-        cv::Mat sobelX, sobelY;
-        cv::Sobel(frame, sobelX, CV_64F, 1, 0, 3);
-        cv::Sobel(frame, sobelY, CV_64F, 0, 1, 3);
-        cv::Mat sobel;
-        cv::magnitude(sobelX, sobelY, sobel);
-        sobel.convertTo(frame, CV_8U);
-    } else if (m_filterMode == 7) {
-        // Sel & Poivre
-        for (int i = 0; i < 500; i++) {
-            int x = rand() % frame.cols;
-            int y = rand() % frame.rows;
-            frame.at<cv::Vec3b>(y, x) = (i % 2 == 0) ? cv::Vec3b(255, 255, 255) : cv::Vec3b(0, 0, 0);
+double VideoCapture::outsideBrightness() const {
+    return m_outsideBrightness;
+}
+void VideoCapture::setOutsideBrightness(double brightness) {
+    brightness = std::min(1.0, std::max(0.0, brightness));
+    if (brightness != m_outsideBrightness) {
+        {
+            std::lock_guard<std::mutex> locker(m_processMutex);
+            m_outsideBrightness = brightness;
         }
-    } else if (m_filterMode == 8) {
-        // Histogram
-        cv::normalize(frame, frame, 0, 255, cv::NORM_MINMAX);
-    } else if (m_filterMode == 9) {
-        // Canny Edge Detection
-        cv::Mat grayFrame;
-        cv::cvtColor(frame, grayFrame, cv::COLOR_BGR2GRAY); // Conversion en niveaux de gris
-        cv::Canny(grayFrame, frame, 100, 200);
-    } else if (m_filterMode == 10) {
-        // Bilateral Filter
-        cv::Mat filteredFrame;
-        // Vérifiez si l'image est en niveaux de gris ou en couleur
-        if (frame.channels() == 1) {
-            // Image en niveaux de gris, OK
-            cv::bilateralFilter(frame, filteredFrame, 9, 75, 75);
-        } else if (frame.channels() == 3) {
-            // Image couleur
-            cv::bilateralFilter(frame, filteredFrame, 9, 75, 75);
-        } else {
-            // Format d'image non pris en charge
-            qDebug() << "Format d'image non pris en charge pour Bilateral Filter.";
-            return;
+        emit regionsChanged();
+    }
+}
+// Renvoie la chaîne de filtres courante
+QVariantList VideoCapture::filterChain() const {
+    return m_filterGraph.chain();
+}
+// Définit une chaîne de filtres, par exemple ["gray", {"type": "gaussian", "size": 7}, "canny"]
+void VideoCapture::setFilterChain(const QVariantList &chain) {
+    QString error;
+    std::unique_lock<std::mutex> locker(m_processMutex); // Attend la fin de la frame en cours de traitement.
+    if (!m_filterGraph.setChain(chain, &error)) {
+        qWarning() << "Erreur :" << error; // La chaîne précédente reste active
+        return;
+    }
+    invalidateOutput();
+    locker.unlock();
+    m_filterMode = -1; // La chaîne ne correspond plus à une entrée de la liste des filtres.
+    emit filterChainChanged();
+}
+// Renvoie le nombre de threads utilisés par les filtres
+int VideoCapture::threadCount() const {
+    return m_filterGraph.threadCount(); // Écrit seulement par l'interface.
+}
+// Définit le nombre de threads des filtres (le résultat est identique quel que soit ce nombre)
+void VideoCapture::setThreadCount(int count) {
+    int previous, current;
+    {
+        std::lock_guard<std::mutex> locker(m_processMutex);
+        previous = m_filterGraph.threadCount();
+        m_filterGraph.setThreadCount(count);
+        current = m_filterGraph.threadCount();
+    }
+    if (current != previous) {
+        emit threadCountChanged();
+    }
+}
+// Intervalle de détection des visages (en frames)
+int VideoCapture::faceDetectionInterval() const {
+    return m_faceDetector.detectionInterval();
+}
+void VideoCapture::setFaceDetectionInterval(int frames) {
+    if (frames != m_faceDetector.detectionInterval()) {
+        {
+            std::lock_guard<std::mutex> locker(m_processMutex); // Lu par le traitement des frames.
+            m_faceDetector.setDetectionInterval(frames);
         }
-        // Copie du résultat dans l'image originale
-        frame = filteredFrame.clone();
-    } else if (m_filterMode == 11) {
-        // Laplacian Filter
-        cv::Mat laplacianFrame;
-        // Applique le filtre Laplacian (CV_16S pour capturer les valeurs négatives/positives des gradients)
-        cv::Laplacian(frame, laplacianFrame, CV_16S, 3);
-        // Convertit en un format affichable (CV_8U)
-        cv::convertScaleAbs(laplacianFrame, frame);
-    } else if (m_filterMode == 12) {
-        // Sharpening
-        cv::Mat kernel = (cv::Mat_<float>(3, 3) << 0, -1, 0, -1, 5, -1, 0, -1, 0);
-        cv::filter2D(frame, frame, -1, kernel);
-    } else if (m_filterMode == 13) {
-        // Cartoon Effect
-        cv::Mat gray, edges;
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-        cv::medianBlur(gray, gray, 7);
-        cv::adaptiveThreshold(gray, edges, 255, cv::ADAPTIVE_THRESH_MEAN_C, cv::THRESH_BINARY, 9, 2);
-        cv::bitwise_and(frame, frame, frame, edges);
-    } else if (m_filterMode == 14) {
-        // Motion Blur
-        cv::Mat kernel = cv::Mat::zeros(15, 15, CV_32F);
-        kernel.at<float>(7, 7) = 1.0 / 15.0;
-        cv::filter2D(frame, frame, -1, kernel);
-    } else if (m_filterMode == 15) {
-        // Emboss Effect
-        cv::Mat kernel = (cv::Mat_<float>(3, 3) << -2, -1, 0, -1, 1, 1, 0, 1, 2);
-        cv::filter2D(frame, frame, CV_8U, kernel);
-    } else if (m_filterMode == 16) {
-        // Sepia Effect
-        cv::Mat sepiaKernel = (cv::Mat_<float>(3, 3) <<
-                                   0.272, 0.534, 0.131,
-                               0.349, 0.686, 0.168,
-                               0.393, 0.769, 0.189);
-        cv::transform(frame, frame, sepiaKernel);
-    }else if (m_filterMode == 17) {
-        detectFaces(frame); // Appliquer la détection des visages
+        emit faceDetectionSettingsChanged();
+    }
+}
+// Facteur de réduction de l'image analysée par la cascade
+double VideoCapture::faceDetectionScale() const {
+    return m_faceDetector.detectionScale();
+}
+void VideoCapture::setFaceDetectionScale(double scale) {
+    const double previous = m_faceDetector.detectionScale();
+    {
+        std::lock_guard<std::mutex> locker(m_processMutex);
+        m_faceDetector.setDetectionScale(scale); // Oublie les visages suivis : pas pendant le traitement d'une frame.
     }
+    if (m_faceDetector.detectionScale() != previous) {
+        emit faceDetectionSettingsChanged();
+    }
+}
+// Mesures de la détection de visages
+double VideoCapture::faceDetectionLatency() const {
+    return m_faceDetector.stats().detectionLatencyMs;
+}
+double VideoCapture::faceDetectionFps() const {
+    return m_faceDetector.stats().detectionFps;
+}
+double VideoCapture::faceTrackingHitRate() const {
+    return m_faceDetector.stats().trackingHitRate;
 }
 // Renvoie l'image actuelle encodée en base64
 QString VideoCapture::frame() const {
     return m_frame;
 }
+// Renvoie l'identifiant de la source pour le fournisseur d'images
+QString VideoCapture::sourceId() const {
+    return m_sourceId;
+}
+// Renvoie le numéro de la dernière frame publiée
+int VideoCapture::frameId() const {
+    return m_frameId;
+}
+// Vérifie si le mode compatibilité Base64 est actif
+bool VideoCapture::legacyFrameMode() const {
+    return m_legacyFrameMode;
+}
+// Active ou désactive le mode compatibilité Base64
+void VideoCapture::setLegacyFrameMode(bool enabled) {
+    if (m_legacyFrameMode != enabled) {
+        {
+            std::lock_guard<std::mutex> locker(m_processMutex); // Lu plusieurs fois par frame (conservation de la sortie BGR, publication).
+            m_legacyFrameMode = enabled;
+        }
+        if (!enabled) {
+            m_frame.clear(); // Libère la dernière chaîne Base64.
+        }
+        emit legacyFrameModeChanged();
+    }
+}
+// Publie une frame vers l'affichage ; rgb (pris en charge) est l'image déjà convertie par le graphe, sinon elle est convertie ici
+void VideoCapture::publishFrame(const cv::Mat &frame, cv::Mat *rgb) {
+    PipelineMetrics::ScopedTimer timer(&m_metrics, PipelineMetrics::Publish);
+    if (!rgb) {
+        // Tampon RGB du pool : il y retourne quand la QImage qui le référence est libérée (thread de rendu compris)
+        rgb = new cv::Mat(m_filterGraph.pool().acquire(frame.rows, frame.cols, CV_8UC3)); // Seul l'en-tête est alloué.
+        PipelineMetrics::ScopedTimer convertTimer(&m_metrics, PipelineMetrics::Convert);
+        m_filterGraph.toDisplay(frame, *rgb);
+    }
+    // La QImage pointe directement sur les données de la cv::Mat ; la fonction de nettoyage la libère.
+    QImage qimage(rgb->data, rgb->cols, rgb->rows, static_cast<int>(rgb->step), QImage::Format_RGB888,
+                  [](void *info) { delete static_cast<cv::Mat *>(info); }, rgb);
+    if (qimage.isNull()) { // Vérifie si la conversion a échoué.
+        qWarning("Erreur : Conversion de cv::Mat en QImage a échoué !");
+        delete rgb;
+        return;
+    }
+    FrameProvider::publish(m_sourceId, qimage); // Partage implicite : aucune copie des pixels.
+    MjpegServer::publish(m_sourceId, frame); // Compressée une seule fois pour tous les clients du flux (rien sans client).
+    if (m_sharedMemoryExport) {
+        m_exporter.publish(frame, m_frameTimestampNs); // Pixels bruts copiés une fois ; les lecteurs les lisent sur place.
+    }
+    if (m_legacyFrameMode) {
+        m_update.base64 = matToBase64(frame); // Ancien chemin : JPEG + Base64 pour les URL "data:".
+    }
+    m_update.published = true; // frameChanged est émis par applyUpdate().
+}
+// Convertit une image Mat (BGR) en JPEG encodé en Base64 (mode compatibilité)
+QString VideoCapture::matToBase64(const cv::Mat &frame) {
+    std::vector<uchar> &jpeg = m_jpegBuffer; // Données JPEG produites par OpenCV (capacité conservée d'une frame à l'autre).
+    PipelineMetrics::ScopedTimer timer(&m_metrics, PipelineMetrics::Encode);
+    if (!cv::imencode(".jpg", frame, jpeg)) { // Encodage direct depuis la Mat BGR, sans passer par QImage.
+        qWarning("Erreur : Encodage JPEG de la frame impossible !");
+        return QString();
+    }
+    const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char *>(jpeg.data()), static_cast<int>(jpeg.size()));
+    return QString::fromLatin1(data.toBase64()); // Encode en base64.
+}
+// Renvoie le mode de filtre choisi (liste déroulante de l'interface)
+int VideoCapture::filterMode() const {
+    return m_filterMode;
+}
 // Définit le mode de filtre et affiche un message de débogage
 void VideoCapture::setFilterMode(int mode) {
+    if (mode == m_filterMode) {
+        return; // Écriture de la liaison QML sans changement : le graphe et sa sortie restent en place.
+    }
     m_filterMode = mode; // Enregistre le mode de filtre sélectionné
+    {
+        std::lock_guard<std::mutex> locker(m_processMutex);
+        m_filterGraph.setSingleMode(mode); // Chaîne d'une seule étape équivalente à l'ancien mode
+        invalidateOutput();
+    }
+    emit filterChainChanged();
     qDebug() << "Mode de filtre défini sur :" << mode; // Log pour le suivi
 }
-// Fonction pour détecter une image via la caméra
+// Fonction pour détecter une image via la caméra (ancien bouton de capture)
 void VideoCapture::detectImage() {
-    if (!cap.isOpened()) { // Vérifie si la caméra est active
+    takeSnapshot();
+}
+// Capture d'image : la prochaine frame traitée par le pipeline (pas de seconde lecture ni de second passage des filtres)
+int VideoCapture::takeSnapshot() {
+    const int id = startSnapshot(QStringLiteral("snapshot"), 1);
+    if (id >= 0 && m_prerollEnabled) {
+        triggerEventRecording(QStringLiteral("snapshot")); // Garde aussi la vidéo autour de la capture d'image.
+    }
+    return id;
+}
+// Rafale : les N prochaines frames traitées, à la cadence du traitement ; seule la copie est faite sur le thread de traitement
+int VideoCapture::captureBurst(int frames) {
+    return startSnapshot(QStringLiteral("burst"), std::min(120, std::max(1, frames))); // 120 frames 1080p : environ 750 Mo si l'écriture prend du retard.
+}
+int VideoCapture::startSnapshot(const QString &prefix, int frames) {
+    if (!m_engine.isRunning()) { // Vérifie si la caméra est active
         qDebug() << "Erreur : La caméra n'est pas active.";
-        return; // Arrête l'exécution si la caméra n'est pas active
-    }
-    cv::Mat frame; // Initialise une matrice pour stocker l'image capturée
-    cap >> frame; // Capture une seule image de la caméra
-    if (frame.empty()) { // Vérifie si la capture a réussi
-        qDebug() << "Erreur : Frame vide.";
-        return; // Arrête l'exécution si l'image est vide
-    }
-    // Applique des filtres à l'image capturée
-    applyFilters(frame);
-    // Enregistre l'image modifiée dans un fichier
-    bool savedModified = cv::imwrite("C:/Users/RANIA/Documents/projetsQT/mauellopencv/build/Desktop_Qt_6_8_1_MinGW_64_bit-Debug/debug/outimg_modified.jpg", frame);
-    if (savedModified) { // Vérifie si l'image a été enregistrée avec succès
-        qDebug() << "Image modifiée enregistrée avec succès sous 'outimg_modified.jpg'.";
-    } else { // Avertit en cas d'échec de l'enregistrement
-        qWarning() << "Erreur lors de l'enregistrement de l'image modifiée.";
-    }
-    // Convertit la frame de OpenCV (BGR) en format RGB
-    cv::cvtColor(frame, frame, cv::COLOR_BGR2RGB);
-    // Crée un objet QImage à partir des données OpenCV
-    QImage qimage((const uchar*)frame.data, frame.cols, frame.rows, frame.step, QImage::Format_RGB888);
-    if (qimage.isNull()) { // Vérifie si la conversion en QImage a échoué
-        qWarning("Erreur : Conversion de cv::Mat en QImage a échoué !");
-        return; // Ignore l'image si la conversion échoue
-    }
-    // Prépare un buffer pour encoder l'image en base64
-    QByteArray buffer; // Déclare un tableau de bytes
-    QBuffer buf(&buffer); // Associe le buffer au tableau
-    buf.open(QIODevice::WriteOnly); // Ouvre le buffer en mode écriture
-    // Sauvegarde l'image dans le buffer au format JPEG
-    qimage.save(&buf, "JPEG");
-    // Encode les données du buffer en base64 et les stocke dans m_frame
-    m_frame = QString::fromLatin1(buffer.toBase64());
-    // Émet un signal pour notifier que l'image a changé
-    emit frameChanged();
-}
-void VideoCapture::detectFaces(cv::Mat &frame) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> locker(m_processMutex); // Prélèvement fait par le traitement des frames.
+    if (m_snapshotRemaining > 0) {
+        qDebug() << "Erreur : Une capture d'image est déjà en cours.";
+        return -1;
+    }
+    const QString name = QStringLiteral("%1-%2-%3").arg(prefix, m_sourceId, QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-HHmmss-zzz")));
+    m_snapshotId = m_snapshots.begin(name, frames);
+    m_snapshotRemaining = frames;
+    return m_snapshotId;
+}
+void VideoCapture::finishSnapshot() {
+    std::lock_guard<std::mutex> locker(m_processMutex);
+    if (m_snapshotRemaining > 0) {
+        m_snapshots.finish(m_snapshotId);
+        m_snapshotRemaining = 0;
+    }
+}
+void VideoCapture::setSnapshotOptions(const QString &directory, const QString &format, int jpegQuality, int pngCompression) {
+    m_snapshots.setDirectory(directory.isEmpty() ? defaultSnapshotDirectory() : directory);
+    m_snapshots.setFormat(format);
+    m_snapshots.setJpegQuality(jpegQuality);
+    m_snapshots.setPngCompression(pngCompression);
+    emit snapshotOptionsChanged(); // Appliqués à la prochaine capture.
+}
+QString VideoCapture::snapshotDirectory() const {
+    return m_snapshots.directory();
+}
+void VideoCapture::detectFaces(cv::Mat &frame, const cv::Mat &gray) {
     // Vérifier si le cadre d'entrée est vide
     if (frame.empty()) {
         qWarning() << "Erreur : L'image est vide!";
         return; // Quitte la fonction si l'image est invalide
     }
-    // Vérifier si le détecteur Haarcascade est chargé
-    if (faceCascade.empty()) {
-        qWarning("Erreur : Le détecteur Haarcascade n'est pas chargé !");
-        return; // Quitte la fonction si le détecteur est introuvable
-    }
-    std::vector<cv::Rect> faces; // Stocke les rectangles des visages détectés
-    cv::Mat gray; // Matrice pour stocker l'image convertie en niveaux de gris
-    // Convertir l'image en niveaux de gris
-    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-    // Améliorer le contraste de l'image pour de meilleures détections
-    cv::equalizeHist(gray, gray);
-    // Détecter les visages dans l'image avec le détecteur Haarcascade
-    faceCascade.detectMultiScale(gray, faces, 1.1, 3, 0, cv::Size(30, 30));
-    // Parcourir chaque visage détecté et effectuer des actions
-    for (size_t i = 0; i < faces.size(); ++i) {
-        cv::Rect face = faces[i]; // Rectangle délimitant un visage
-        cv::Scalar color = cv::Scalar(0, 255, 0); // Couleur verte pour dessiner le rectangle
-        int thickness = 2; // Définir l'épaisseur des lignes du rectangle
-        // Dessiner un rectangle autour du visage
-        cv::rectangle(frame, face, color, thickness);
-        // Ajouter un texte à côté du visage (index ou annotation)
-        std::string text = "Visage " + std::to_string(i + 1); // Génère le texte
-        int fontFace = cv::FONT_HERSHEY_SIMPLEX; // Police du texte
-        double fontScale = 0.5; // Taille du texte
-        int fontThickness = 1; // Épaisseur du texte
-        cv::Point textOrg(face.x, face.y - 10); // Position du texte au-dessus du visage
-        // Dessiner le texte (principal)
-        cv::putText(frame, text, textOrg, fontFace, fontScale, color, fontThickness);
-        // Ajouter une ombre au texte (optionnel)
-        cv::Point shadowOffset(2, 2); // Décalage de l'ombre
-        cv::putText(frame, text, textOrg + shadowOffset, fontFace, fontScale, cv::Scalar(0, 0, 0), fontThickness);
-    }
-
-    // Afficher le nombre de visages détectés dans la console
-    qDebug() << "Nombre de visages détectés :" << faces.size();
-
-    // Si l'enregistrement est activé et que le writer est ouvert, enregistrer la frame
-    if (m_isRecording && writer.isOpened()) {
-        writer.write(frame); // Écrit l'image actuelle dans la vidéo
-    } else {
-        qWarning("Erreur : Le VideoWriter n'est pas ouvert !");
+    // Suivi des visages et envoi éventuel au thread de détection ; dessine les derniers résultats sans attendre
+    m_faceDetector.process(frame, gray);
+    const FaceDetector::Stats stats = m_faceDetector.stats();
+    if (stats.detections != m_lastFaceDetections) { // Une détection s'est terminée depuis la dernière frame
+        m_lastFaceDetections = stats.detections;
+        m_update.faceStatsChanged = true;
     }
+    m_update.faceAppeared = stats.faceCount > 0 && m_lastFaceCount == 0; // Déclenche un événement (pré-capture).
+    m_lastFaceCount = stats.faceCount;
 }
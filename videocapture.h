@@ -12,33 +12,152 @@
 #include <chrono> // Fournit des outils pour la gestion du temps.
 #include <QTimer> // Gestion des minuteries dans Qt.
 #include <QElapsedTimer> // Chronomètre pour mesurer des intervalles.
+#include "captureengine.h" // Thread de capture et anneau des dernières frames.
+#include "filtergraph.h" // Chaîne de filtres composable.
+#include "facedetector.h" // Détection de visages asynchrone avec suivi.
+#include "recorder.h" // Enregistrement vidéo sur un thread dédié.
+#include "prerollbuffer.h" // Pré-enregistrement en mémoire pour l'enregistrement sur événement.
+#include "metrics.h" // Latences par étape et FPS lissé.
+#include "camerascheduler.h" // Traitement des frames sur le pool partagé (plusieurs caméras).
+#include "qualitygovernor.h" // Dégradation de la qualité sous charge.
+#include "changedetector.h" // Frames et tuiles inchangées d'une frame à l'autre.
+#include "frameexporter.h" // Anneau de frames en mémoire partagée pour les processus locaux.
+#include "snapshotwriter.h" // Écriture des captures d'images hors du thread de l'interface.
+#include <QVariantMap> // Mesures exposées à QML.
+#include <QVariantList> // Description de la chaîne de filtres depuis QML.
+#include <QStringList> // Fichiers des captures d'images.
+#include <atomic> // États lus par le thread de traitement.
+#include <mutex> // Traitement des frames sur un thread du pool.
 class VideoCapture : public QObject { // Déclaration de la classe héritant de QObject (nécessaire pour QML et signaux/slots).
     Q_OBJECT // Macro Qt pour activer les fonctionnalités spécifiques de QObject.
     // Propriétés accessibles depuis QML avec des getters et signaux de changement
     Q_PROPERTY(bool isCapturing READ isCapturing NOTIFY isCapturingChanged) // Indique si la capture est active.
-    Q_PROPERTY(QString frame READ frame NOTIFY frameChanged) // Contient l'image capturée sous forme de chaîne.
-    Q_PROPERTY(double realFrameRate READ realFrameRate NOTIFY realFrameRateChanged) // Fréquence d'images actuelle.
+    Q_PROPERTY(QString status READ status NOTIFY statusChanged) // État de la source : "stopped", "opening", "ready" ou "failed".
+    Q_PROPERTY(double timeToFirstFrame READ timeToFirstFrame NOTIFY statusChanged) // Délai entre startCapture() et la première frame (ms, -1 avant).
+    Q_PROPERTY(QString frame READ frame NOTIFY frameChanged) // Contient l'image capturée sous forme de chaîne (mode compatibilité uniquement).
+    Q_PROPERTY(QString sourceId READ sourceId CONSTANT) // Identifiant de la source auprès du fournisseur d'images "image://camera".
+    Q_PROPERTY(int frameId READ frameId NOTIFY frameChanged) // Numéro de la dernière frame publiée (change à chaque frame).
+    Q_PROPERTY(bool legacyFrameMode READ legacyFrameMode WRITE setLegacyFrameMode NOTIFY legacyFrameModeChanged) // Active l'ancien chemin JPEG + Base64.
+    Q_PROPERTY(double realFrameRate READ realFrameRate NOTIFY realFrameRateChanged) // Fréquence d'images traitées (lissée, mise à jour chaque seconde).
+    Q_PROPERTY(QVariantMap metrics READ metrics NOTIFY metricsChanged) // Latences par étape sur la dernière seconde : {"fps", "stages": {"grab": {"p50_ms", ...}}}.
+    Q_PROPERTY(QString metricsFile READ metricsFile WRITE setMetricsFile NOTIFY metricsFileChanged) // Fichier JSON réécrit chaque seconde (vide = désactivé).
     Q_PROPERTY(bool isRecording READ isRecording WRITE setRecording NOTIFY recordingChanged) // Indique si l'enregistrement est actif.
+    Q_PROPERTY(int allocationsPerFrame READ allocationsPerFrame NOTIFY captureStatsChanged) // Allocations de cv::Mat pendant la dernière frame traitée.
+    Q_PROPERTY(QString frameSource READ frameSource WRITE setFrameSource NOTIFY frameSourceChanged) // Source des frames ("camera:0", "file:...", "images:...", "synthetic").
+    Q_PROPERTY(bool unthrottled READ unthrottled WRITE setUnthrottled NOTIFY frameSourceChanged) // Lecture sans cadencement des sources enregistrées.
+    Q_PROPERTY(QVariantList filterChain READ filterChain WRITE setFilterChain NOTIFY filterChainChanged) // Chaîne de filtres ordonnée.
+    Q_PROPERTY(int filterMode READ filterMode WRITE setFilterMode NOTIFY filterChainChanged) // Filtre unique choisi dans la liste (-1 = chaîne définie par setFilterChain()).
+    Q_PROPERTY(int threadCount READ threadCount WRITE setThreadCount NOTIFY threadCountChanged) // Threads utilisés par les filtres exécutés par bandes.
+    Q_PROPERTY(int faceDetectionInterval READ faceDetectionInterval WRITE setFaceDetectionInterval NOTIFY faceDetectionSettingsChanged) // Une détection toutes les N frames.
+    Q_PROPERTY(double faceDetectionScale READ faceDetectionScale WRITE setFaceDetectionScale NOTIFY faceDetectionSettingsChanged) // Réduction de l'image analysée.
+    Q_PROPERTY(double faceDetectionLatency READ faceDetectionLatency NOTIFY faceStatsChanged) // Latence de détection (ms).
+    Q_PROPERTY(double faceDetectionFps READ faceDetectionFps NOTIFY faceStatsChanged) // Détections terminées par seconde.
+    Q_PROPERTY(double faceTrackingHitRate READ faceTrackingHitRate NOTIFY faceStatsChanged) // Part des visages retrouvés entre deux détections.
+    Q_PROPERTY(int recorderQueueDepth READ recorderQueueDepth NOTIFY recorderStatsChanged) // Frames en attente d'encodage.
+    Q_PROPERTY(double recorderEncodeLatency READ recorderEncodeLatency NOTIFY recorderStatsChanged) // Latence d'encodage (ms).
+    Q_PROPERTY(qulonglong recorderDroppedFrames READ recorderDroppedFrames NOTIFY recorderStatsChanged) // Frames jetées par l'encodeur (file pleine).
+    Q_PROPERTY(bool prerollEnabled READ prerollEnabled WRITE setPrerollEnabled NOTIFY prerollEnabledChanged) // Mémorise les dernières secondes pour l'enregistrement sur événement.
+    Q_PROPERTY(qulonglong prerollMemory READ prerollMemory NOTIFY prerollStatsChanged) // Octets occupés par la pré-capture.
+    Q_PROPERTY(double prerollBufferedSeconds READ prerollBufferedSeconds NOTIFY prerollStatsChanged) // Secondes mémorisées.
+    Q_PROPERTY(bool eventRecording READ eventRecording NOTIFY prerollStatsChanged) // Un fichier d'événement est en cours d'écriture.
+    Q_PROPERTY(qulonglong droppedFrames READ droppedFrames NOTIFY captureStatsChanged) // Frames capturées mais jamais consommées.
+    Q_PROPERTY(qulonglong overrunFrames READ overrunFrames NOTIFY captureStatsChanged) // Frames perdues faute de case libre dans l'anneau.
+    Q_PROPERTY(int priority READ priority WRITE setPriority NOTIFY schedulingChanged) // Priorité auprès de l'ordonnanceur multi-caméras.
+    Q_PROPERTY(double maxFps READ maxFps WRITE setMaxFps NOTIFY schedulingChanged) // Budget de FPS du traitement (0 = cadence de la source).
+    Q_PROPERTY(bool adaptiveQuality READ adaptiveQuality WRITE setAdaptiveQuality NOTIFY qualityChanged) // Régulation de la qualité pour tenir la cadence.
+    Q_PROPERTY(int qualityLevel READ qualityLevel NOTIFY qualityChanged) // Palier de qualité courant (0 = qualité complète).
+    Q_PROPERTY(QString qualityLevelName READ qualityLevelName NOTIFY qualityChanged) // Nom du palier ("full", "light-filters"...).
+    Q_PROPERTY(bool changeDetection READ changeDetection WRITE setChangeDetection NOTIFY changeDetectionChanged) // Réutilise la sortie précédente là où l'image n'a pas changé.
+    Q_PROPERTY(double skippedFrameRatio READ skippedFrameRatio NOTIFY metricsChanged) // Part des frames de la dernière seconde dont la sortie a été réutilisée.
+    Q_PROPERTY(double dirtyTileRatio READ dirtyTileRatio NOTIFY metricsChanged) // Part des tuiles retraitées sur la dernière seconde.
+    Q_PROPERTY(QVariantList regions READ regions WRITE setRegions NOTIFY regionsChanged) // Zones d'intérêt filtrées et analysées, en fractions de l'image ({x, y, width, height}) ; vide = image entière.
+    Q_PROPERTY(double outsideBrightness READ outsideBrightness WRITE setOutsideBrightness NOTIFY regionsChanged) // Luminosité hors des zones (1 = inchangée, 0.4 = assombrie).
+    Q_PROPERTY(bool sharedMemoryExport READ sharedMemoryExport WRITE setSharedMemoryExport NOTIFY sharedMemoryExportChanged) // Copie chaque frame publiée dans l'anneau partagé "mauellopencv-<sourceId>".
+    Q_PROPERTY(QString snapshotDirectory READ snapshotDirectory NOTIFY snapshotOptionsChanged) // Dossier des captures d'images et des rafales.
     // Membres privés de la classe
     QElapsedTimer elapsedTimer; // Chronomètre pour mesurer des durées.
-    cv::VideoCapture cap; // Objet OpenCV pour capturer des flux vidéo.
+    PipelineMetrics m_metrics; // Latences par étape (déclaré avant les threads qui y écrivent).
+    CaptureEngine m_engine; // Thread de capture propriétaire de la caméra.
 public:
     explicit VideoCapture(QObject *parent = nullptr); // Constructeur avec paramètre parent (nullptr par défaut).
+    VideoCapture(const QString &frameSource, CameraScheduler *scheduler, QObject *parent = nullptr); // Caméra d'un gestionnaire (non démarrée).
     ~VideoCapture(); // Destructeur.
     // Méthodes accessibles depuis QML
     Q_INVOKABLE void startCapture(); // Démarrer la capture vidéo.
     Q_INVOKABLE void captureFrame(); // Capturer une image.
     Q_INVOKABLE void stopCapture(); // Arrêter la capture vidéo.
     Q_INVOKABLE void setOutputFile(const QString &filePath); // Définir le fichier de sortie pour l'enregistrement.
+    Q_INVOKABLE void setRecordingOptions(int queueCapacity, bool blockWhenFull, int segmentSeconds, qint64 segmentBytes); // File de l'encodeur et découpage en segments (au prochain enregistrement).
     Q_INVOKABLE bool isCapturing() const; // Vérifier si la capture est active.
-    Q_INVOKABLE void setResolution(int width, int height); // Définir la résolution de la capture.
-    Q_INVOKABLE void setFPS(int fps); // Définir les images par seconde.
+    QString status() const; // État de l'ouverture de la source.
+    double timeToFirstFrame() const; // Délai de la première frame (ms).
+    Q_INVOKABLE void setResolution(int width, int height); // Définir la résolution de la capture (appliquée sur place à une caméra ouverte).
+    Q_INVOKABLE void setFPS(int fps); // Définir les images par seconde (appliqués sur place à une caméra ouverte).
+    int filterMode() const; // Récupérer le mode de filtre.
     Q_INVOKABLE void setFilterMode(int mode); // Définir un mode de filtre (ex. : gris, inversion).
-    Q_INVOKABLE void detectImage(); // Détecter une image dans le flux vidéo.
+    QVariantList filterChain() const; // Récupérer la chaîne de filtres.
+    Q_INVOKABLE void setFilterChain(const QVariantList &chain); // Définir une chaîne de filtres (noms ou objets {type, paramètres}).
+    int threadCount() const; // Récupérer le nombre de threads des filtres.
+    Q_INVOKABLE void setThreadCount(int count); // Définir le nombre de threads des filtres (0 = tous les cœurs, 1 = série).
+    int faceDetectionInterval() const; // Récupérer l'intervalle de détection.
+    Q_INVOKABLE void setFaceDetectionInterval(int frames); // Définir l'intervalle de détection (en frames).
+    double faceDetectionScale() const; // Récupérer le facteur de réduction de la détection.
+    Q_INVOKABLE void setFaceDetectionScale(double scale); // Définir le facteur de réduction (0.1 à 1).
+    double faceDetectionLatency() const; // Récupérer la latence de détection.
+    double faceDetectionFps() const; // Récupérer le débit de détection.
+    double faceTrackingHitRate() const; // Récupérer le taux de suivi réussi.
+    Q_INVOKABLE void detectImage(); // Détecter une image dans le flux vidéo (équivaut à takeSnapshot()).
+    Q_INVOKABLE int takeSnapshot(); // Enregistre la prochaine frame traitée ; renvoie le numéro repris par snapshotSaved (-1 si impossible).
+    Q_INVOKABLE int captureBurst(int frames); // Enregistre les N prochaines frames traitées (1 à 120, gardées en mémoire jusqu'à leur écriture).
+    Q_INVOKABLE void setSnapshotOptions(const QString &directory, const QString &format, int jpegQuality, int pngCompression); // Dossier (vide = Images/mauellopencv), "jpg" ou "png", qualité JPEG (1 à 100), compression PNG (0 à 9).
+    QString snapshotDirectory() const; // Récupérer le dossier des captures d'images.
     QString frame() const; // Récupérer l'image capturée en tant que chaîne.
+    QString sourceId() const; // Récupérer l'identifiant de la source pour le fournisseur d'images.
+    int frameId() const; // Récupérer le numéro de la dernière frame publiée.
+    bool legacyFrameMode() const; // Vérifier si le mode compatibilité Base64 est actif.
+    Q_INVOKABLE void setLegacyFrameMode(bool enabled); // Activer ou désactiver le mode compatibilité Base64.
     double realFrameRate() const; // Récupérer la fréquence d'images actuelle.
+    QVariantMap metrics() const; // Récupérer les mesures de la dernière seconde.
+    QString metricsFile() const; // Récupérer le fichier des mesures.
+    Q_INVOKABLE void setMetricsFile(const QString &path); // Définir le fichier des mesures (vide = pas d'écriture).
     bool isRecording() const; // Vérifier si l'enregistrement est actif.
+    QString frameSource() const; // Récupérer la description de la source des frames.
+    Q_INVOKABLE void setFrameSource(const QString &spec); // Choisir la source (appliquée au prochain startCapture()).
+    bool unthrottled() const; // Vérifier si la lecture est sans cadencement.
+    Q_INVOKABLE void setUnthrottled(bool unthrottled); // Activer la lecture au débit maximal (appliquée au prochain startCapture()).
+    int allocationsPerFrame() const; // Récupérer le nombre d'allocations de la dernière frame.
+    qulonglong droppedFrames() const; // Récupérer le nombre de frames jamais consommées.
+    qulonglong overrunFrames() const; // Récupérer le nombre de dépassements de l'anneau.
     Q_INVOKABLE void setRecording(bool recording); // Activer ou désactiver l'enregistrement.
+    int priority() const; // Récupérer la priorité de traitement.
+    Q_INVOKABLE void setPriority(int priority); // Définir la priorité (plus grand = servi plus souvent quand les cœurs sont saturés).
+    double maxFps() const; // Récupérer le budget de FPS.
+    Q_INVOKABLE void setMaxFps(double maxFps); // Définir le budget de FPS (0 = illimité).
+    bool adaptiveQuality() const; // Vérifier si la régulation de qualité est active.
+    Q_INVOKABLE void setAdaptiveQuality(bool enabled); // Activer la régulation (désactivée : qualité complète en permanence).
+    int qualityLevel() const; // Récupérer le palier de qualité courant.
+    QString qualityLevelName() const; // Récupérer le nom du palier courant.
+    bool changeDetection() const; // Vérifier si la détection de changement est active.
+    Q_INVOKABLE void setChangeDetection(bool enabled); // Activer la détection (désactivée : chaque frame est traitée en entier).
+    double skippedFrameRatio() const; // Récupérer la part de frames réutilisées.
+    double dirtyTileRatio() const; // Récupérer la part de tuiles retraitées.
+    bool sharedMemoryExport() const; // Vérifier si l'export en mémoire partagée est actif.
+    Q_INVOKABLE void setSharedMemoryExport(bool enabled); // Activer l'export (désactivé : le segment est supprimé).
+    QString sharedMemoryName() const; // Nom du segment partagé de cette caméra.
+    bool prerollEnabled() const; // Vérifier si la pré-capture est active.
+    Q_INVOKABLE void setPrerollEnabled(bool enabled); // Activer la pré-capture (enregistrement sur événement).
+    Q_INVOKABLE void setPrerollOptions(int prerollSeconds, int postrollSeconds, int memoryMegabytes); // Durées avant/après l'événement et mémoire maximale.
+    Q_INVOKABLE void triggerEventRecording(const QString &reason); // Écrit la pré-capture et les secondes suivantes dans un fichier.
+    qulonglong prerollMemory() const; // Récupérer la mémoire occupée par la pré-capture.
+    double prerollBufferedSeconds() const; // Récupérer la durée mémorisée.
+    bool eventRecording() const; // Vérifier si un événement est en cours d'écriture.
+    int recorderQueueDepth() const; // Récupérer la profondeur de la file d'encodage.
+    double recorderEncodeLatency() const; // Récupérer la latence d'encodage.
+    qulonglong recorderDroppedFrames() const; // Récupérer le nombre de frames jetées par l'encodeur.
+    QVariantList regions() const; // Récupérer les zones d'intérêt.
+    Q_INVOKABLE void setRegions(const QVariantList &regions); // Limiter filtres et détection à des zones (Qt.rect ou {x, y, width, height}, entre 0 et 1).
+    double outsideBrightness() const; // Récupérer la luminosité hors des zones.
+    Q_INVOKABLE void setOutsideBrightness(double brightness); // Définir la luminosité hors des zones (0 à 1).
     Q_INVOKABLE void applyFilters(cv::Mat &frame); // Appliquer des filtres sur une image donnée.
 signals: // Déclaration des signaux pour notifier des changements
     void isCapturingChanged(); // Signal émis lorsque l'état de capture change.
@@ -46,18 +165,113 @@ signals: // Déclaration des signaux pour notifier des changements
     void frameChanged(const QString &frameData); // Version surchargée avec données d'image.
     void realFrameRateChanged(); // Signal émis lorsque la fréquence d'images change.
     void recordingChanged(); // Signal émis lorsque l'état d'enregistrement change.
+    void legacyFrameModeChanged(); // Signal émis lorsque le mode compatibilité change.
+    void filterChainChanged(); // Signal émis lorsque la chaîne de filtres change.
+    void threadCountChanged(); // Signal émis lorsque le nombre de threads des filtres change.
+    void frameSourceChanged(); // Signal émis lorsque la source ou son cadencement change.
+    void captureStatsChanged(); // Signal émis lorsque les compteurs de frames perdues changent.
+    void faceDetectionSettingsChanged(); // Signal émis lorsque l'intervalle ou l'échelle de détection change.
+    void faceStatsChanged(); // Signal émis à chaque détection de visages terminée.
+    void recorderStatsChanged(); // Signal émis lorsque les mesures de l'enregistreur changent.
+    void prerollEnabledChanged(); // Signal émis lorsque la pré-capture est activée ou désactivée.
+    void prerollStatsChanged(); // Signal émis (au plus une fois par seconde) lorsque les mesures de pré-capture changent.
+    void metricsChanged(); // Signal émis chaque seconde avec les nouvelles mesures.
+    void metricsFileChanged(); // Signal émis lorsque le fichier des mesures change.
+    void schedulingChanged(); // Signal émis lorsque la priorité ou le budget de FPS change.
+    void qualityChanged(); // Signal émis lorsque la régulation est activée/désactivée ou que le palier change.
+    void changeDetectionChanged(); // Signal émis lorsque la détection de changement est activée ou désactivée.
+    void regionsChanged(); // Signal émis lorsque les zones d'intérêt ou la luminosité hors des zones changent.
+    void sharedMemoryExportChanged(); // Signal émis lorsque l'export en mémoire partagée est activé ou désactivé.
+    void statusChanged(); // Signal émis lorsque la source s'ouvre, échoue, livre sa première frame ou s'arrête.
+    void snapshotOptionsChanged(); // Signal émis lorsque le dossier ou le format des captures d'images change.
+    void snapshotSaved(int id, const QStringList &files, const QString &error); // Signal émis quand toutes les frames d'une capture (ou d'une rafale) sont écrites ; error vide en cas de succès.
 private:// Membres privés pour la gestion de la capture et du traitement
-    cv::VideoWriter writer; // Objet pour écrire des vidéos.
+    Recorder m_recorder; // Enregistreur (file bornée, thread d'encodage, segments).
+    QString m_outputFile; // Fichier de sortie de l'enregistrement.
+    Recorder::Stats m_lastRecorderStats; // Dernières mesures notifiées à QML.
     int frameWidth = 640; // Largeur par défaut des images capturées.
     int frameHeight = 480; // Hauteur par défaut des images capturées.
     int fps = 30; // Fréquence d'images par défaut.
     QString m_frame; // Image capturée, encodée en Base64.
-    int m_filterMode = 0; // Mode de filtre (0 = Aucun, 1 = Gris, 2 = Inversion).
+    int m_filterMode = 0; // Mode de filtre (0 = Aucun, 1 = Gris, 2 = Inversion ; -1 = chaîne quelconque).
     QString matToBase64(const cv::Mat &frame); // Convertir une image Mat en Base64.
-    cv::CascadeClassifier faceCascade; // Classificateur pour la détection de visages.
-    void detectFaces(cv::Mat &frame); // Méthode pour détecter les visages dans une image.
+    void publishFrame(const cv::Mat &frame, cv::Mat *rgb = nullptr); // Publier une frame BGR (ou gris) vers l'affichage QML (rgb : image déjà convertie, prise en charge).
+    QString m_sourceId; // Identifiant unique de la source ("cam0", "cam1", ...).
+    int m_frameId = 0; // Compteur de frames publiées.
+    std::atomic<bool> m_legacyFrameMode{false}; // Mode compatibilité : encode aussi la frame en JPEG + Base64 dans m_frame (lu par le thread de traitement).
+    QString m_frameSource = QStringLiteral("camera:0"); // Source des frames (caméra par défaut).
+    CameraScheduler *m_scheduler = nullptr; // Ordonnanceur partagé (nul : traitement cadencé par frameTimer).
+    int m_schedulerId = 0; // Inscription auprès de l'ordonnanceur (0 = non inscrite).
+    int m_priority = 0; // Priorité auprès de l'ordonnanceur.
+    double m_maxFps = 0.0; // Budget de FPS auprès de l'ordonnanceur.
+    void unschedule(); // Désinscrit la caméra (attend la fin du traitement en cours).
+    void checkEndOfStream(); // Constate l'arrêt du thread de capture.
+    // Résultat d'une frame transmis au thread de l'interface
+    struct FrameUpdate {
+        bool published = false; // Une frame a été publiée (frameChanged).
+        QString base64; // Frame encodée (mode compatibilité).
+        int allocations = -1; // Allocations pendant le traitement (-1 = non mesuré).
+        bool faceStatsChanged = false; // Une détection de visages s'est terminée.
+        bool faceAppeared = false; // Un visage vient d'apparaître.
+        int qualityLevel = -1; // Nouveau palier de qualité (-1 = inchangé).
+    };
+    bool processFrame(); // Traite la dernière frame (thread de l'interface ou du pool) ; faux si aucune nouvelle.
+    void deliver(const FrameUpdate &update); // Transmet le résultat au thread de l'interface.
+    void applyUpdate(const FrameUpdate &update); // Met à jour l'état lu par QML et émet les signaux.
+    std::mutex m_processMutex; // Un seul traitement à la fois (frame, capture d'image, réglages du graphe).
+    FrameUpdate m_update; // Résultat de la frame en cours (sous m_processMutex).
+    QualityGovernor m_governor; // Régulateur de qualité (sous m_processMutex).
+    double m_processingScale = 1.0; // Échelle de l'image traitée (palier courant, sous m_processMutex).
+    void applyQualitySettings(); // Applique les réglages du palier courant (sous m_processMutex).
+    void updateFrameDeadline(); // Échéance d'une frame pour le régulateur (FPS visé et budget).
+    bool m_adaptiveQuality = true; // Copie de l'interface : régulation active.
+    int m_qualityLevel = 0; // Copie de l'interface : palier courant.
+    cv::Mat m_fullFrame; // Frame agrandie à la résolution de capture pour les encodeurs (traitement réduit).
+    ChangeDetector m_changeDetector; // Tuiles modifiées depuis la dernière sortie (sous m_processMutex).
+    cv::Mat m_lastOutput; // Dernière sortie BGR filtrée, base des frames suivantes (sous m_processMutex).
+    void invalidateOutput(); // Les réglages du graphe ont changé : la prochaine frame est traitée en entier (sous m_processMutex).
+    std::atomic<bool> m_changeDetection{true}; // Détection de changement active (lue par le thread de traitement).
+    double m_skippedFrameRatio = 0.0; // Mesures de la dernière seconde.
+    double m_dirtyTileRatio = 0.0;
+    QVariantList m_regionList; // Zones d'intérêt telles que décrites par QML.
+    double m_outsideBrightness = 1.0; // Luminosité hors des zones (sous m_processMutex pour le traitement).
+    std::vector<cv::Rect2d> m_regions; // Zones d'intérêt en fractions de l'image (sous m_processMutex).
+    std::vector<cv::Rect> m_regionPixels; // Zones à la taille de la frame traitée (tampon réutilisé).
+    void filterFrame(cv::Mat &frame, cv::Mat *display = nullptr, bool keepFrame = true); // Chaîne de filtres sur l'image entière ou les zones (sous m_processMutex).
+    FrameExporter m_exporter; // Écrivain de l'anneau partagé (sous m_processMutex).
+    std::atomic<bool> m_sharedMemoryExport{false}; // Export actif (lu par le thread de traitement).
+    int64_t m_frameTimestampNs = 0; // Horodatage de capture de la frame en cours (sous m_processMutex).
+    SnapshotWriter m_snapshots; // Copies des frames capturées et threads d'écriture des fichiers.
+    int m_snapshotId = 0; // Capture en cours de prélèvement (sous m_processMutex).
+    int m_snapshotRemaining = 0; // Frames encore à prélever pour elle (sous m_processMutex).
+    int startSnapshot(const QString &prefix, int frames); // Ouvre une capture de N frames ; -1 si la caméra est arrêtée ou une rafale en cours.
+    void finishSnapshot(); // Clôt la capture en cours quand les frames s'arrêtent (écrit celles déjà prélevées).
+    bool m_unthrottled = false; // Lecture sans cadencement des sources enregistrées.
+    uint64_t m_lastSequence = 0; // Numéro de la dernière frame capturée déjà traitée.
+    cv::Mat m_workFrame; // Copie de travail de la frame capturée (tampon du pool).
+    std::vector<uchar> m_jpegBuffer; // Tampon JPEG du mode compatibilité (réutilisé).
+    int m_allocationsPerFrame = 0; // Allocations de cv::Mat pendant la dernière frame.
+    void updateCaptureStats(); // Émet captureStatsChanged si les compteurs ont bougé.
+    qulonglong m_lastDropped = 0; // Derniers compteurs notifiés à QML.
+    qulonglong m_lastOverruns = 0;
+    FaceDetector m_faceDetector; // Détection de visages sur un thread dédié, suivi entre deux détections.
+    void updateStatus(); // Reprend l'état du thread de capture (thread de l'interface).
+    QString m_status = QStringLiteral("stopped"); // Dernier état notifié à QML.
+    double m_timeToFirstFrame = -1.0; // Dernier délai de première frame notifié (ms).
+    uint64_t m_lastFaceDetections = 0; // Nombre de détections déjà notifiées à QML.
+    int m_lastFaceCount = 0; // Visages suivis à la frame précédente (déclenchement sur apparition d'un visage).
+    PrerollBuffer m_preroll; // Dernières secondes compressées en mémoire.
+    std::atomic<bool> m_prerollEnabled{false}; // Pré-capture active (lue par le thread de traitement).
+    PrerollBuffer::Stats m_prerollStats; // Dernières mesures de pré-capture notifiées à QML.
+    QElapsedTimer m_prerollStatsTimer; // Limite la fréquence de prerollStatsChanged.
+    void detectFaces(cv::Mat &frame, const cv::Mat &gray); // Méthode pour détecter les visages dans une image.
+    FilterGraph m_filterGraph; // Chaîne de filtres compilée.
     double m_realFrameRate; // Stocker la fréquence d'images actuelle.
+    void publishMetrics(); // Résume la seconde écoulée, notifie QML et écrit le fichier des mesures.
+    QVariantMap m_metricsMap; // Dernières mesures notifiées à QML.
+    QString m_metricsFile; // Fichier des mesures pour la supervision.
+    QTimer *metricsTimer; // Publication des mesures chaque seconde.
     QTimer *frameTimer; // Minuterie pour capturer des images périodiquement.
-    bool m_isRecording = false; // Indique si l'enregistrement est actif.
+    std::atomic<bool> m_isRecording{false}; // Indique si l'enregistrement est actif (lu par le thread de traitement).
 };
 #endif // VIDEOCAPTURE_H
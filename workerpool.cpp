@@ -0,0 +1,141 @@
+#include "workerpool.h" // Déclaration de la classe WorkerPool.
+#include <algorithm> // std::max, std::min.
+// Thread de travail courant : pool et file (nullptr / -1 hors d'un thread de travail)
+static thread_local const WorkerPool *currentPool = nullptr;
+static thread_local int currentQueue = -1;
+// Constructeur : lance threadCount - 1 threads (le thread appelant complète le pool dans parallelFor)
+WorkerPool::WorkerPool(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    for (int i = 1; i < threadCount; ++i) {
+        m_queues.emplace_back(new Queue);
+    }
+    for (int i = 0; i < threadCount - 1; ++i) {
+        m_threads.emplace_back(&WorkerPool::workerLoop, this, i); // Après la création de toutes les files (vol).
+    }
+}
+// Destructeur : arrête les threads après les tâches en file
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> locker(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (std::thread &thread : m_threads) {
+        thread.join();
+    }
+}
+int WorkerPool::threadCount() const {
+    return static_cast<int>(m_threads.size()) + 1;
+}
+int WorkerPool::workerCount() const {
+    return static_cast<int>(m_threads.size());
+}
+// Ajoute une tâche dans la file du thread courant (thread du pool) ou dans la suivante à tour de rôle
+void WorkerPool::submit(std::function<void()> task) {
+    if (m_queues.empty()) {
+        task(); // Machine à un cœur : personne d'autre pour l'exécuter.
+        return;
+    }
+    const int index = currentPool == this ? currentQueue
+                                          : static_cast<int>(m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size());
+    {
+        std::lock_guard<std::mutex> locker(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    m_pending.fetch_add(1); // Après l'ajout : un thread qui voit m_pending > 0 trouve la tâche.
+    if (m_sleeping.load() > 0) {
+        std::lock_guard<std::mutex> locker(m_mutex); // Le thread qui s'endort a vérifié m_pending sous ce verrou.
+        m_condition.notify_one();
+    }
+}
+// Exécute function(i) pour i dans [0, count) sur au plus maxThreads threads, appelant compris
+void WorkerPool::parallelFor(int count, const std::function<void(int)> &function, int maxThreads) {
+    if (count <= 0) {
+        return;
+    }
+    if (maxThreads <= 0) {
+        maxThreads = threadCount();
+    }
+    const int helpers = std::min({maxThreads, threadCount(), count}) - 1; // Threads du pool appelés en renfort.
+    if (helpers <= 0) {
+        for (int i = 0; i < count; ++i) {
+            function(i); // Exécution en série, sans passer par la file.
+        }
+        return;
+    }
+    // Contexte partagé : un renfort qui démarre après la fin du travail ne touche que ce contexte
+    struct Context {
+        const std::function<void(int)> *function; // Valide tant que des indices restent à traiter.
+        int count;
+        std::atomic<int> next{0}; // Prochain indice à distribuer.
+        std::atomic<int> done{0}; // Indices terminés.
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto context = std::make_shared<Context>();
+    context->function = &function;
+    context->count = count;
+    auto work = [](Context &ctx) {
+        int index;
+        while ((index = ctx.next.fetch_add(1)) < ctx.count) {
+            (*ctx.function)(index);
+            if (ctx.done.fetch_add(1) + 1 == ctx.count) { // Dernier indice terminé : réveille l'appelant.
+                std::lock_guard<std::mutex> locker(ctx.mutex);
+                ctx.finished.notify_all();
+            }
+        }
+    };
+    for (int i = 0; i < helpers; ++i) {
+        submit([context, work]() { work(*context); });
+    }
+    work(*context); // L'appelant participe.
+    std::unique_lock<std::mutex> locker(context->mutex);
+    context->finished.wait(locker, [&]() { return context->done.load() == count; });
+}
+// Pool partagé (créé au premier usage)
+WorkerPool &WorkerPool::shared() {
+    static WorkerPool pool;
+    return pool;
+}
+// Dépile la tâche la plus récente de sa file, sinon vole la plus ancienne d'une autre file
+bool WorkerPool::take(int index, Task &task) {
+    const int count = static_cast<int>(m_queues.size());
+    for (int i = 0; i < count; ++i) {
+        Queue &queue = *m_queues[(index + i) % count];
+        std::lock_guard<std::mutex> locker(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (i == 0) {
+            task = std::move(queue.tasks.back()); // Sa propre file : la dernière tâche ajoutée.
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front()); // Vol : la plus ancienne, la plus loin du travail de son propriétaire.
+            queue.tasks.pop_front();
+        }
+        m_pending.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+// Boucle d'un thread de travail
+void WorkerPool::workerLoop(int index) {
+    currentPool = this;
+    currentQueue = index;
+    for (;;) {
+        Task task;
+        if (take(index, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> locker(m_mutex);
+        m_sleeping.fetch_add(1);
+        m_condition.wait(locker, [this]() { return m_stopping || m_pending.load() > 0; });
+        m_sleeping.fetch_sub(1);
+        if (m_stopping && m_pending.load() <= 0) {
+            return; // Arrêt demandé et plus rien à faire.
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+// Inclusion des bibliothèques nécessaires
+#include <atomic> // Compteurs de tâches et de threads endormis.
+#include <condition_variable> // Réveil des threads en attente de tâches.
+#include <deque> // Files des tâches.
+#include <functional> // std::function pour les tâches.
+#include <memory> // std::unique_ptr pour les files.
+#include <mutex> // Protection des files.
+#include <thread> // Threads de travail.
+#include <vector> // Liste des threads.
+// Pool de threads partagé par tout le traitement (caméras, bandes des filtres, tâches de fond).
+// Chaque thread de travail a sa propre file : il dépile ses tâches par la fin (les plus récentes, encore
+// en cache) et, quand elle est vide, vole les plus anciennes des autres files. Une tâche soumise depuis
+// un thread du pool (bandes d'un filtre lancé par le traitement d'une caméra) reste dans la file de ce
+// thread ; une tâche soumise de l'extérieur est répartie à tour de rôle entre les files.
+// parallelFor() découpe un travail en indices et fait participer le thread appelant :
+// un appel imbriqué depuis un thread du pool ne peut donc pas bloquer faute de thread libre.
+class WorkerPool {
+public:
+    explicit WorkerPool(int threadCount = 0); // Nombre total de threads (appelant compris) ; 0 = nombre de cœurs.
+    ~WorkerPool(); // Termine les tâches en file puis arrête les threads.
+    int threadCount() const; // Threads de travail + thread appelant.
+    int workerCount() const; // Threads de travail (tâches soumises en arrière-plan).
+    void submit(std::function<void()> task); // Exécute une tâche en arrière-plan (sur place si le pool n'a aucun thread de travail).
+    void parallelFor(int count, const std::function<void(int)> &function, int maxThreads = 0); // Exécute function(0..count-1) et attend la fin.
+    static WorkerPool &shared(); // Pool commun à l'application (un thread par cœur).
+private:
+    using Task = std::function<void()>;
+    // File d'un thread de travail
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    void workerLoop(int index); // Boucle d'un thread de travail.
+    bool take(int index, Task &task); // Dépile une tâche de sa file, ou en vole une.
+    std::vector<std::unique_ptr<Queue>> m_queues; // Une file par thread de travail.
+    std::vector<std::thread> m_threads; // Threads de travail.
+    std::atomic<int> m_pending{0}; // Tâches en file (toutes files confondues).
+    std::atomic<int> m_sleeping{0}; // Threads endormis faute de tâche.
+    std::atomic<unsigned> m_nextQueue{0}; // File de la prochaine tâche soumise de l'extérieur.
+    std::mutex m_mutex; // Endormissement et réveil des threads.
+    std::condition_variable m_condition; // Signale une nouvelle tâche ou l'arrêt.
+    bool m_stopping = false; // Demande d'arrêt des threads.
+};
+#endif // WORKERPOOL_H